@@ -27,6 +27,7 @@
 class AnalyzedData
 {
   public:
+    virtual ~AnalyzedData() {}
     /**
      * It returns true, if data are complete.<br>
      * Vrac true, kdy jsou data kompletn.
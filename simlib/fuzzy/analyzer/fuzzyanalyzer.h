@@ -17,102 +17,8 @@
 /////////////////////////////////////////////////////////////////////////////
 #include <sax2/Attributes.hpp>
 #include <sax2/DefaultHandler.hpp>
-#include "analyzer.h"
-#include "fuzzy.h"
+#include "fuzzydata.h"
 #include <sax/Locator.hpp>
-/**
- * Data which FuzzyHandler and FuzzyAnalyzer can return.<br>
- * Data, kter me vrtit FuzzyHandler a FuzzyAnalyzer. 
- * @ingroup xml
- */
-class FuzzyData
-: public AnalyzedData
-{
-  public:
-    /** 
-     * Parameterless constructor. Values must be added explicitly.<br>
-     * Bezparametrick konstruktor. Hodnoty je poteba doplnit explicitn. 
-     */
-    FuzzyData() : cl(false), in1(NULL), in2(NULL), out(NULL), fset(NULL) 
-    { setReleasable(true); }
-    /** 
-     * It creates a fully defined object which contains data for fuzzy controller creation.<br> 
-     * Vytvo pln definovan objekt obsahujc data k vytvoen fuzzy regultoru. 
-     */
-    FuzzyData(FuzzyInput * input1, FuzzyInput * input2, FuzzyOutput * output, FuzzyIIORules * rules)
-    : cl(true), in1(input1), in2(input2), out(output), r(rules), fset(NULL) 
-    { setReleasable(true); }
-    /**
-     * It creates a fully defined object which contains fuzzy set definition.<br>
-     * Vytvo pln definovan objekt obsahujc definici fuzzy mnoiny 
-     */
-    FuzzyData(FuzzySet * set)
-    : cl(false), in1(NULL), in2(NULL), out(NULL), fset(set) 
-    { setReleasable(true); }
-    
-    /** 
-     * If true was set by setReleasable() method, it dealocates memory for variables.<br>
-     * Pokud se metodou setReleasable() nenastavilo false, uvoln pam zabranou promnnmi. 
-     */
-    virtual ~FuzzyData() 
-    {
-      if (releasable)
-      {
-        if (in1 != NULL) delete in1;
-        if (in2 != NULL) delete in2;
-        if (out != NULL) delete out;
-        if (r != NULL) delete r;
-        if (fset != NULL) delete fset;
-      }
-    }
-    
-    /** It returns true, if object is complete.<br> Vrac true, kdy je objekt kompletn. */
-    virtual bool isComplete() 
-    { return ((in1 != NULL) && (in2 != NULL) && (out != NULL) && (r != NULL)) || (fset != NULL); }
-    
-    /**
-     * It says, if object contains controller definition or fuzzy set definition.
-     * If true is returned, content of object is fuzzy regulator definition. In this case
-     * method getFuzzySet() NULL returns. If false is result, method getFuzzySet returs 
-     * one fuzzy set definition and others get...() methods returns NULL.<br>
-     * Uruje, jestli objekt obsahuje definici regultoru nebo samostatn fuzzy mnoiny.
-     * Pokud vrt true, je obsahem objektu definice fuzzy regultoru. Metoda getFuzzySet() vrac 
-     * v tomto ppad NULL. Pokud je vsledkem false, metoda getFuzzySet() vrt definici jedn
-     * fuzzy mnoiny a ostatn funkce get...() vracej NULL.
-     */
-    bool isClass() { return cl; }
-    
-    /** It returns first input variable.<br>Vrac prvn vstupn fuzzy promnnou. */
-    FuzzyInput * getInput1() { return in1; }
-    /** It returns second input variable.<br>Vrac druhou vstupn fuzzy promnnou. */
-    FuzzyInput * getInput2() { return in2; }
-    /** It returns output variable.<br>Vrac vstupn fuzzy promnnou. */
-    FuzzyOutput * getOutput() { return out; }
-    /** It returns inference rules definition.<br>Vrac definici inferennch pravidel. */
-    FuzzyIIORules * getRules() { return r; }
-    /** It returns fuzzy set definition.<br>Vrac definici fuzzy mnoiny. */
-    FuzzySet * getFuzzySet() { return fset; }
-    
-    /** It sets first input variable.<br>Nastav prvn vstupn promnnou. */
-    void setInput1(FuzzyInput * input) { in1 = input; cl = true; }
-    /** It sets second input variable.<br>Nastav druhou vstupn promnnou. */
-    void setInput2(FuzzyInput * input) { in2 = input; cl = true; }
-    /** It sets output variable.<br>Nastav vstupn promnnou. */
-    void setOutput(FuzzyOutput * output) { out = output; cl = true; }
-    /** It sets inference rules definition.<br>Nastav definici inferennch pravidel. */
-    void setRules(FuzzyIIORules * rules) { r = rules; cl = true; }
-    /** It sets fuzzy set definition.<br>Nastav definici fuzzy mnoiny. */
-    void setFuzzySet(FuzzySet * set) { fset = set; cl = false; }
-  protected:
-    bool cl;             /**< It contains class or fuzzy set. */
-    FuzzyInput * in1;    /**< First input variable.  */
-    FuzzyInput * in2;    /**< Second input variable.  */
-    FuzzyOutput * out;   /**< Output variable. */ 
-    FuzzyIIORules * r;   /**< Inference rules definition. */
-    FuzzySet * fset;     /**< Fuzzy set definition. */
-  private:
-};
-
 /**
  * Definition of analyzer of XML according to SAX2 interface. FuzzyAnalyzer uses object of 
  * this class for it is not necessary to create it explicitly.<br>
@@ -254,51 +160,3 @@ class FuzzyAnalyzer: public Analyzer
     FuzzyData *data;        /**< Obtained data. */
   private:
 };
-
-
-/**
- * Exception generated by method create() of class MFFactory.<br>
- * Vyjmka generovan metodou create() tdy MFFactory.
- * @ingroup xml
- */
-class MFFException
-{
-    const char * m;
-  public:
-    /** It creates a exeption with error message.<br>Vytvo vjimku s chybovou hlkou. */
-    MFFException(const char *msg) : m(msg) {}
-    /** It returns error message.<br>Vrac chybov hlen. */
-    const char * getMsg() const { return m; }
-  protected:
-  private:
-};
-
-/**
- * Class for safe making of FuzzyMembershipFunction.<br>
- * Tda pro bezpen vytven FuzzyMembershipFunction.
- * @ingroup xml
- */
-class MFFactory
-{
-  public:
-    /**
-     * Safe making of FuzzyMembershipFunction. It can generate MFFException.<br>
-     * Bezpen vytven FuzzyMembershipFunction. Me generovat vjimku MFFException.
-     */
-    static FuzzyMembershipFunction * create(const char* mftype, const char* wordvalue)
-    {
-      if (XMLString::compareString(mftype, "FuzzyTriangle") == 0)
-      { return new FuzzyTriangle(wordvalue); }
-      else if (XMLString::compareString(mftype, "FuzzyTrapez") == 0)
-      { return new FuzzyTrapez(wordvalue); }
-      else if (XMLString::compareString(mftype, "FuzzyGauss") == 0)
-      { return new FuzzyGauss(wordvalue); }
-      else if (XMLString::compareString(mftype, "FuzzySingleton") == 0)
-      { return new FuzzySingleton(wordvalue); }
-      else
-        throw MFFException("Unknown type of member function!");
-    }
-   
-  protected:
-  private:
-};
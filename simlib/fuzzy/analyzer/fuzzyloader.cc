@@ -0,0 +1,748 @@
+/////////////////////////////////////////////////////////////////////////////
+// fuzzyloader.cc
+//
+// Copyright (c) 2026 agent <agent@local>
+//
+// This library is licensed under GNU Library GPL. See the file COPYING.
+//
+// Warning: this is EXPERIMENTAL code, interfaces can be changed
+//
+// Fuzzy subsystem for SIMLIB
+// 
+/////////////////////////////////////////////////////////////////////////////
+// Implementation of native fuzzy XML analyzer (one pass, no XML library)
+// and of binary images of fuzzy models.
+//
+// Image format (native byte order, all records have fixed size):
+//   Header                          magic, version and table sizes
+//   Item  [items]                   set or controller (3 sets + rules)
+//   Set   [sets]                    universum, name, membership functions
+//   MF    [mfs]                     type, word value, definition values
+//   Rule  [rules]                   operation and output of n1*n2 rules
+//   char  [strings]                 names (zero terminated)
+/////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <errno.h>
+#include <iostream>
+
+#include "simlib.h"
+#include "internal.h"
+#include "fuzzyloader.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define FUZZY_MMAP 1
+#endif
+
+using std::cerr;
+using std::endl;
+
+namespace {
+
+const char MAGIC[8] = { 'S','L','F','U','Z','Z','Y','1' };
+const uint32_t VERSION = 1;
+
+struct Header { char magic[8]; uint32_t version, items, sets, mfs, rules, strings, pad[2]; };
+struct Item   { uint32_t isClass, firstSet, firstRule, pad; };
+struct Set    { uint32_t name, first, count, pad; double min, max; };
+struct MF     { int32_t kind; uint32_t word; double value[4]; };
+struct Rule   { int16_t op, out; };
+
+/** Type names for MFFactory (index is FuzzyMembershipFunction::BatchTypes). */
+const char * const mfTypeName[] =
+  { 0, "FuzzySingleton", "FuzzyTriangle", "FuzzyTrapez", "FuzzyGauss", "FuzzyGauss2" };
+/** Number of definition values of function type. */
+const int mfDefValues[] = { 0, 1, 3, 4, 2, 4 };
+
+/** Name without namespace prefix. */
+inline const char *localName(const std::string &name)
+{
+  std::string::size_type i = name.find(':');
+  return name.c_str() + (i == std::string::npos ? 0 : i + 1);
+}
+
+inline bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+inline bool isNameChar(char c)
+{ return !isSpace(c) && c != '>' && c != '/' && c != '=' && c != '<' && c != '"' && c != '\''; }
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   FuzzyLoader
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * It set all variables into their default values.<br>
+ * Nastav implicitn hodnoty vech vnitnch promnnch.
+ */
+void FuzzyLoader::init()
+{
+  fileName = "";
+  line = 1;
+  failed = false;
+  errors = 0;
+  fatalErrors = 0;
+  nattrs = 0;
+  numSets = 0;
+  numRows = 0;
+  rowLength = 0;
+  in1 = NULL;
+  in2 = NULL;
+  out = NULL;
+  rules = NULL;
+  fset = NULL;
+  mf = NULL;
+  isClass = false;
+}
+
+/** It releases partially created objects.<br>Uvoln sten vytvoen objekty. */
+void FuzzyLoader::clear()
+{
+  delete mf;
+  delete fset;
+  delete rules;
+  delete out;
+  delete in2;
+  delete in1;
+  mf = NULL;
+  fset = NULL;
+  rules = NULL;
+  out = NULL;
+  in1 = in2 = NULL;
+}
+
+/** Printout of error message.<br>Vpis chybovho hlen. */
+void FuzzyLoader::error(const char *msg, bool fatal)
+{
+  failed = true;
+  if (fatal) fatalErrors++; else errors++;
+  cerr << (fatal ? "\nFatal Error at file " : "\nError at file ") << fileName
+       << ", line " << line
+       << "\n  Message: " << msg << endl;
+}
+
+/** Value of attribute of actual element (NULL if missing).<br>Hodnota atributu aktulnho elementu. */
+const char *FuzzyLoader::attribute(const char *name)
+{
+  for (unsigned i = 0; i < nattrs; i++)
+    if (attrs[i].name == name) return attrs[i].value.c_str();
+  return NULL;
+}
+
+/** Numeric value of attribute, error is indicated for bad format.<br>seln hodnota atributu. */
+double FuzzyLoader::number(const char *name)
+{
+  const char *s = attribute(name);
+  char *end = NULL;
+  errno = 0;
+  double x = s ? strtod(s, &end) : 0;
+  if (s != NULL && end != s)
+    while (isSpace(*end)) end++;
+  if (s == NULL || end == s || *end != '\0' || errno != 0)
+  {
+    std::string msg = std::string("Bad number format for attribute \"") + name + "\"!";
+    error(msg.c_str());
+  }
+  return x;
+}
+
+/** Start element event treatment.<br>Oeten udlosti vskytu zatku elementu. */
+void FuzzyLoader::startElement(const std::string &qname)
+{
+  const char *local = localName(qname);
+  if (strcmp(local, "fuzzyclass") == 0)
+  {
+    isClass = true;
+  }
+  else if (strcmp(local, "fuzzytype") == 0)
+  {
+    double min = number("minrange");
+    double max = number("maxrange");
+    const char *name = attribute("typename");
+    if (failed) return;
+    if (fset != NULL) { error("Nested \"fuzzytype\" tag!"); return; }
+    fset = new FuzzySet(name ? name : "", min, max);
+  }
+  else if (strcmp(local, "fuzzymf") == 0)
+  {
+    const char *mftype = attribute("mftype");
+    const char *wordvalue = attribute("wordvalue");
+    if (fset == NULL || mf != NULL) { error("Unexpected \"fuzzymf\" tag!"); return; }
+    if (fset->count() >= FuzzySet::MAX) { error("Too many membership functions!"); return; }
+    try
+    {
+      mf = MFFactory::create(mftype ? mftype : "", wordvalue ? wordvalue : "");
+    }
+    catch(const MFFException& e)
+    {
+      error(e.getMsg());
+    }
+  }
+  else if (strcmp(local, "value") == 0)
+  {
+    double val = number("value");
+    if (failed) return;
+    if (mf == NULL) { error("Unexpected \"value\" tag!"); return; }
+    mf->addDefValue(val);
+  }
+  else if (strcmp(local, "behavior") == 0)
+  {
+    if (!isClass || out == NULL || rules != NULL) { error("Unexpected \"behavior\" tag!"); return; }
+    rules = new FuzzyIIORules(in1, in2, out);
+  }
+  else if (strcmp(local, "row") == 0)
+  {
+    if (rules == NULL || numRows >= in2->count()) { error("Bad count of \"rows\" tags!"); return; }
+    numRows++;
+    rowLength = 0;
+  }
+  else if (strcmp(local, "outvalue") == 0)
+  {
+    const char *value = attribute("value");
+    if (rules == NULL || numRows == 0) { error("Unexpected \"outvalue\" tag!"); return; }
+    if (rowLength >= in1->count()) { error("Bad count of \"outvalue\" tags!"); return; }
+    rowLength++;
+    unsigned i;
+    for (i = 0; value != NULL && i < out->count(); i++)
+      if (strcmp(value, out->wordValue(i)) == 0) break;
+    if (value == NULL || i == out->count()) { error("Unknown output word value!"); return; }
+    rules->add(FuzzyIIORules::opAND, rowLength-1, numRows-1, int(i));
+  }
+}
+
+/** End element event treatment.<br>Oeten udlosti vskytu konce elementu. */
+void FuzzyLoader::endElement(const std::string &qname)
+{
+  const char *local = localName(qname);
+  if (strcmp(local, "fuzzymf") == 0)
+  {
+    if (mf == NULL) return;
+    fset->add(*mf);
+    delete mf;
+    mf = NULL;
+  }
+  else if (strcmp(local, "fuzzytype") == 0)
+  {
+    if (isClass) 
+    {
+      switch (numSets++)
+      {
+        case 0:
+          in1 = new FuzzyInput(*fset);
+          break;
+        case 1:
+          in2 = new FuzzyInput(*fset);
+          break;
+        case 2:
+          out = new FuzzyOutput(*fset);
+          break;
+        default: 
+          error("Too many \"fuzzytype\" tags in class!");
+          break;
+      }
+      delete fset;
+      fset = NULL;
+    }
+    else if (data == NULL)
+    {
+      data = new FuzzyData(fset);
+      fset = NULL;
+    }
+    else
+      error("More than one \"fuzzytype\" tag!");
+  }
+  else if (strcmp(local, "row") == 0)
+  {
+    if (rowLength != in1->count())
+      error("Bad count of \"outvalue\" tags!");
+  }
+  else if (strcmp(local, "behavior") == 0)
+  {
+    if (numRows != in2->count())
+      error("Bad count of \"rows\" tags!");
+  }
+  else if (strcmp(local, "fuzzyclass") == 0)
+  {
+    if (rules == NULL || data != NULL)
+      error("Incomplete \"fuzzyclass\"!");
+    else
+      data = new FuzzyData(in1, in2, out, rules);
+  }
+}
+
+/**
+ * It analyzes xml definition of fuzzy model in memory. Tags and attributes are
+ * read in one pass, declarations, comments and CDATA sections are skipped.<br>
+ * Analyzuje xml definici fuzzy modelu v pamti. Znaky a atributy se tou jednm
+ * prchodem, deklarace, komente a sekce CDATA jsou peskoeny.
+ */
+void FuzzyLoader::analyze(const char *text, unsigned long length, const char *name)
+{
+  clock_t start = clock();
+  clear();
+  data = NULL;          // previous data are owned by user
+  init();
+  fileName = name;
+  const char *p = text;
+  const char *end = text + length;
+  std::vector<std::string> stack;
+  bool root = false;
+  while (!failed && p < end)
+  {
+    // character data (ignored)
+    while (p < end && *p != '<')
+      if (*p++ == '\n') line++;
+    if (p == end) break;
+    const char *skipTo = NULL;
+    if (p + 1 < end && p[1] == '?') skipTo = "?>";
+    else if (end - p >= 4 && strncmp(p, "<!--", 4) == 0) skipTo = "-->";
+    else if (end - p >= 9 && strncmp(p, "<![CDATA[", 9) == 0) skipTo = "]]>";
+    if (skipTo != NULL)
+    {
+      size_t n = strlen(skipTo);
+      for (p += 2; p + n <= end && strncmp(p, skipTo, n) != 0; p++)
+        if (*p == '\n') line++;
+      if (p + n > end) { error("Unterminated markup!", true); break; }
+      p += n;
+      continue;
+    }
+    if (p + 1 < end && p[1] == '!')   // <!DOCTYPE ... [ ... ]>
+    {
+      int depth = 0;
+      char quote = 0;
+      for (p += 2; p < end; p++)
+      {
+        if (*p == '\n') line++;
+        if (quote) { if (*p == quote) quote = 0; }
+        else if (*p == '"' || *p == '\'') quote = *p;
+        else if (*p == '[') depth++;
+        else if (*p == ']') depth--;
+        else if (*p == '>' && depth <= 0) break;
+      }
+      if (p == end) { error("Unterminated declaration!", true); break; }
+      p++;
+      continue;
+    }
+    // tag
+    bool endTag = (++p < end && *p == '/');
+    if (endTag) p++;
+    const char *s = p;
+    while (p < end && isNameChar(*p)) p++;
+    if (p == s) { error("Bad tag name!", true); break; }
+    std::string tag(s, p);
+    nattrs = 0;
+    bool empty = false;
+    for (;;)
+    {
+      while (p < end && isSpace(*p))
+        if (*p++ == '\n') line++;
+      if (p == end) break;
+      if (*p == '>') { p++; break; }
+      if (*p == '/' && !endTag && p + 1 < end && p[1] == '>') { p += 2; empty = true; break; }
+      if (endTag) { error("Bad end tag!", true); break; }
+      // attribute
+      s = p;
+      while (p < end && isNameChar(*p)) p++;
+      if (p == s) { error("Bad attribute name!", true); break; }
+      if (nattrs == attrs.size()) attrs.resize(nattrs + 1);
+      Attribute &a = attrs[nattrs++];
+      a.name.assign(s, p);
+      a.value.clear();
+      while (p < end && isSpace(*p))
+        if (*p++ == '\n') line++;
+      if (p == end || *p != '=') { error("Expected '=' after attribute name!", true); break; }
+      p++;
+      while (p < end && isSpace(*p))
+        if (*p++ == '\n') line++;
+      if (p == end || (*p != '"' && *p != '\'')) { error("Expected quoted attribute value!", true); break; }
+      char quote = *p++;
+      while (p < end && *p != quote && *p != '<')
+      {
+        if (*p == '\n') line++;
+        if (*p != '&') { a.value += *p++; continue; }
+        const char *e = (const char *)memchr(p, ';', end - p);
+        if (e == NULL) { error("Bad entity reference!", true); break; }
+        std::string ent(p + 1, e);
+        if (ent == "lt") a.value += '<';
+        else if (ent == "gt") a.value += '>';
+        else if (ent == "amp") a.value += '&';
+        else if (ent == "quot") a.value += '"';
+        else if (ent == "apos") a.value += '\'';
+        else if (ent.size() > 1 && ent[0] == '#')
+        {
+          long c = (ent[1] == 'x') ? strtol(ent.c_str() + 2, NULL, 16) : strtol(ent.c_str() + 1, NULL, 10);
+          if (c <= 0 || c > 255) { error("Unsupported character reference!"); break; }
+          a.value += char(c);
+        }
+        else { error("Unknown entity!"); break; }
+        p = e + 1;
+      }
+      if (failed) break;
+      if (p == end || *p != quote) { error("Unterminated attribute value!", true); break; }
+      p++;
+    }
+    if (failed) break;
+    if (p == end && !empty && (p[-1] != '>')) { error("Unterminated tag!", true); break; }
+    if (endTag)
+    {
+      if (stack.empty() || stack.back() != tag) { error("End tag does not match start tag!", true); break; }
+      stack.pop_back();
+      endElement(tag);
+      continue;
+    }
+    if (stack.empty() && root) { error("More than one root element!", true); break; }
+    root = true;
+    startElement(tag);
+    if (failed) break;
+    if (empty)
+      endElement(tag);
+    else
+      stack.push_back(tag);
+  }
+  if (!failed && (!root || !stack.empty()))
+    error("Unexpected end of document!", true);
+  if (!failed && data == NULL)
+    error("No fuzzy set or class defined!");
+  if (data != NULL && data->isClass())
+  {
+    in1 = in2 = NULL;   // owned by data
+    out = NULL;
+    rules = NULL;
+  }
+  if (failed && data != NULL)
+  {
+    delete data;
+    data = NULL;
+  }
+  clear();
+  analyzeTime = (clock() - start) * 1000 / CLOCKS_PER_SEC;
+}
+
+/**
+ * It analyzes file with xml definition of fuzzy model. XML file must have the same format
+ * as MeFE program uses.<br>
+ * Analyzuje soubor, kter obsahuje xml definici fuzzy modelu. XML mus bt stejnho
+ * formtu jako pouv program MeFE.
+ * @param fileName Name of file with XML data.<br>Jmno souboru s XML daty.
+ */
+void FuzzyLoader::analyze(char * fileName)
+{
+  FILE *f = fopen(fileName, "rb");
+  if (f == NULL)
+    SIMLIB_error("FuzzyLoader::analyze: can not open file '%s'", fileName);
+  std::vector<char> text;
+  char buffer[4096];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0)
+    text.insert(text.end(), buffer, buffer + n);
+  fclose(f);
+  analyze(text.empty() ? "" : &text[0], text.size(), fileName);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   FuzzyImageWriter
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+/** It adds string into string table.<br>Pid etzec do tabulky etzc. */
+unsigned FuzzyImageWriter::addString(const char *s)
+{
+  unsigned i = strings.size();
+  strings.append(s ? s : "");
+  strings += '\0';
+  return i;
+}
+
+/** It adds set record and its functions, returns index of set.<br>Pid zznam mnoiny. */
+unsigned FuzzyImageWriter::addSet(const FuzzySet &set)
+{
+  Set s;
+  memset(&s, 0, sizeof(s));
+  s.name = addString(set.name());
+  s.first = mfs.size() / sizeof(MF);
+  s.count = set.count();
+  s.min = set.min();
+  s.max = set.max();
+  for (int i = 0; i < set.count(); i++)
+  {
+    MF m;
+    memset(&m, 0, sizeof(m));
+    m.kind = set.batchKind(i);
+    if (m.kind <= FuzzyMembershipFunction::mfGeneral || m.kind > FuzzyMembershipFunction::mfGauss2)
+      SIMLIB_error("FuzzyImageWriter::add: unsupported type of membership function '%s'!", set.wordValue(i));
+    m.word = addString(set.wordValue(i));
+    for (int j = 0; j < mfDefValues[m.kind]; j++)
+      m.value[j] = set[i]->getDefValue(j);
+    mfs.insert(mfs.end(), (const char *)&m, (const char *)(&m + 1));
+  }
+  unsigned index = sets.size() / sizeof(Set);
+  sets.insert(sets.end(), (const char *)&s, (const char *)(&s + 1));
+  return index;
+}
+
+/** It adds fuzzy set.<br>Pid fuzzy mnoinu. */
+void FuzzyImageWriter::add(const FuzzySet &set)
+{
+  items.push_back(0);
+  items.push_back(addSet(set));
+  items.push_back(0);
+  items.push_back(0);
+}
+
+/** It adds fuzzy set or controller.<br>Pid fuzzy mnoinu nebo regultor. */
+void FuzzyImageWriter::add(FuzzyData &data)
+{
+  if (!data.isComplete())
+    SIMLIB_error("FuzzyImageWriter::add: incomplete data!");
+  if (!data.isClass())
+  {
+    add(*data.getFuzzySet());
+    return;
+  }
+  const FuzzyIIORules *r = data.getRules();
+  int n1 = data.getInput1()->count();
+  int n2 = data.getInput2()->count();
+  int no = data.getOutput()->count();
+  if (r->getNumRules() < n1 * n2)
+    SIMLIB_error("FuzzyImageWriter::add: incomplete table of rules!");
+  items.push_back(1);
+  items.push_back(addSet(*data.getInput1()->fuzzySet()));
+  addSet(*data.getInput2()->fuzzySet());
+  addSet(*data.getOutput()->fuzzySet());
+  items.push_back(rules.size() / 2);
+  items.push_back(0);
+  for (int i = 0; i < n1 * n2; i++)
+  {
+    int o = r->getOutWV(i);
+    rules.push_back(short(r->getOperation(i)));
+    rules.push_back(short((o >= 0 && o < no) ? o : -1));
+  }
+}
+
+/** It writes image into file.<br>Zape obraz do souboru. */
+void FuzzyImageWriter::save(const char *fileName) const
+{
+  Header h;
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, MAGIC, sizeof(MAGIC));
+  h.version = VERSION;
+  h.items = count();
+  h.sets = sets.size() / sizeof(Set);
+  h.mfs = mfs.size() / sizeof(MF);
+  h.rules = rules.size() / 2;
+  h.strings = strings.size();
+  std::vector<Item> it(h.items);
+  for (unsigned i = 0; i < h.items; i++)
+  {
+    it[i].isClass = items[4*i];
+    it[i].firstSet = items[4*i+1];
+    it[i].firstRule = items[4*i+2];
+    it[i].pad = 0;
+  }
+  std::vector<Rule> ru(h.rules);
+  for (unsigned i = 0; i < h.rules; i++)
+  {
+    ru[i].op = rules[2*i];
+    ru[i].out = rules[2*i+1];
+  }
+  FILE *f = fopen(fileName, "wb");
+  if (f == NULL)
+    SIMLIB_error("FuzzyImageWriter::save: can not create file '%s'", fileName);
+  bool ok = fwrite(&h, sizeof(h), 1, f) == 1;
+  if (ok && h.items) ok = fwrite(&it[0], sizeof(Item), h.items, f) == h.items;
+  if (ok && h.sets) ok = fwrite(&sets[0], 1, sets.size(), f) == sets.size();
+  if (ok && h.mfs) ok = fwrite(&mfs[0], 1, mfs.size(), f) == mfs.size();
+  if (ok && h.rules) ok = fwrite(&ru[0], sizeof(Rule), h.rules, f) == h.rules;
+  if (ok && h.strings) ok = fwrite(strings.data(), 1, strings.size(), f) == strings.size();
+  if (fclose(f) != 0 || !ok)
+    SIMLIB_error("FuzzyImageWriter::save: write error '%s'", fileName);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//   FuzzyImage
+//
+/////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+inline const Header *header(const char *base) { return (const Header *)base; }
+inline const Item *itemTable(const char *base) 
+{ return (const Item *)(base + sizeof(Header)); }
+inline const Set *setTable(const char *base) 
+{ return (const Set *)(itemTable(base) + header(base)->items); }
+inline const MF *mfTable(const char *base) 
+{ return (const MF *)(setTable(base) + header(base)->sets); }
+inline const Rule *ruleTable(const char *base) 
+{ return (const Rule *)(mfTable(base) + header(base)->mfs); }
+inline const char *stringTable(const char *base) 
+{ return (const char *)(ruleTable(base) + header(base)->rules); }
+} // namespace
+
+/**
+ * It opens image file and checks its header and tables.<br>
+ * Oteve soubor s obrazem a zkontroluje jeho hlaviku a tabulky.
+ */
+FuzzyImage::FuzzyImage(const char *fileName) : base(NULL), size(0), mapped(false)
+{
+#ifdef FUZZY_MMAP
+  int fd = open(fileName, O_RDONLY);
+  struct stat st;
+  if (fd >= 0 && fstat(fd, &st) == 0 && st.st_size > 0)
+  {
+    void *p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p != MAP_FAILED)
+    {
+      base = (const char *)p;
+      size = st.st_size;
+      mapped = true;
+    }
+  }
+  if (fd >= 0) close(fd);
+#endif
+  if (base == NULL)
+  {
+    FILE *f = fopen(fileName, "rb");
+    if (f == NULL)
+      SIMLIB_error("FuzzyImage: can not open file '%s'", fileName);
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *buffer = new char[n > 0 ? n : 1];   // aligned for double
+    if (n <= 0 || fread(buffer, 1, n, f) != (size_t)n)
+      n = 0;
+    fclose(f);
+    base = buffer;
+    size = n;
+  }
+  const Header *h = header(base);
+  if (size < sizeof(Header) || memcmp(h->magic, MAGIC, sizeof(MAGIC)) != 0 || h->version != VERSION)
+    SIMLIB_error("FuzzyImage: '%s' is not fuzzy image", fileName);
+  unsigned long need = sizeof(Header) + (unsigned long)h->items * sizeof(Item)
+                     + (unsigned long)h->sets * sizeof(Set) + (unsigned long)h->mfs * sizeof(MF)
+                     + (unsigned long)h->rules * sizeof(Rule) + h->strings;
+  if (need != size || (h->strings > 0 && stringTable(base)[h->strings - 1] != '\0'))
+    SIMLIB_error("FuzzyImage: '%s' is corrupted", fileName);
+  for (unsigned i = 0; i < h->items; i++)
+  {
+    const Item &it = itemTable(base)[i];
+    if (it.firstSet + (it.isClass ? 3 : 1) > h->sets)
+      SIMLIB_error("FuzzyImage: '%s' is corrupted", fileName);
+    if (it.isClass)
+    {
+      const Set *s = setTable(base) + it.firstSet;
+      if ((unsigned long)it.firstRule + s[0].count * s[1].count > h->rules)
+        SIMLIB_error("FuzzyImage: '%s' is corrupted", fileName);
+    }
+  }
+  for (unsigned i = 0; i < h->sets; i++)
+  {
+    const Set &s = setTable(base)[i];
+    if (s.count > FuzzySet::MAX || s.first + s.count > h->mfs || s.name >= h->strings)
+      SIMLIB_error("FuzzyImage: '%s' is corrupted", fileName);
+  }
+  for (unsigned i = 0; i < h->mfs; i++)
+  {
+    const MF &m = mfTable(base)[i];
+    if (m.kind <= FuzzyMembershipFunction::mfGeneral || m.kind > FuzzyMembershipFunction::mfGauss2
+        || m.word >= h->strings)
+      SIMLIB_error("FuzzyImage: '%s' is corrupted", fileName);
+  }
+}
+
+FuzzyImage::~FuzzyImage()
+{
+#ifdef FUZZY_MMAP
+  if (mapped)
+  {
+    munmap((void *)base, size);
+    return;
+  }
+#endif
+  delete [] base;
+}
+
+/** Number of items.<br>Poet poloek. */
+unsigned FuzzyImage::count() const
+{
+  return header(base)->items;
+}
+
+/** It returns true if i-th item is controller.<br>Vrac true, kdy i-t poloka je regultor. */
+bool FuzzyImage::isClass(unsigned i) const
+{
+  if (i >= count())
+    SIMLIB_error("FuzzyImage::isClass: index out of range!");
+  return itemTable(base)[i].isClass != 0;
+}
+
+/** It creates s-th set of image.<br>Vytvo s-tou mnoinu obrazu. */
+FuzzySet *FuzzyImage::makeSet(unsigned s) const
+{
+  const Set &set = setTable(base)[s];
+  const char *str = stringTable(base);
+  FuzzySet *fs = new FuzzySet(str + set.name, set.min, set.max);
+  const MF *m = mfTable(base) + set.first;
+  for (unsigned i = 0; i < set.count; i++)
+  {
+    FuzzyMembershipFunction *f = MFFactory::create(mfTypeName[m[i].kind], str + m[i].word);
+    for (int j = 0; j < mfDefValues[m[i].kind]; j++)
+      f->addDefValue(m[i].value[j]);
+    fs->add(*f);
+    delete f;
+  }
+  return fs;
+}
+
+/** It creates fuzzy set of i-th item.<br>Vytvo fuzzy mnoinu i-t poloky. */
+FuzzySet *FuzzyImage::createSet(unsigned i) const
+{
+  if (i >= count())
+    SIMLIB_error("FuzzyImage::createSet: index out of range!");
+  return makeSet(itemTable(base)[i].firstSet);
+}
+
+/**
+ * It creates i-th item (see FuzzyData).<br>
+ * Vytvo i-tou poloku (viz FuzzyData).
+ */
+FuzzyData *FuzzyImage::create(unsigned i) const
+{
+  if (i >= count())
+    SIMLIB_error("FuzzyImage::create: index out of range!");
+  const Item &it = itemTable(base)[i];
+  if (!it.isClass)
+    return new FuzzyData(makeSet(it.firstSet));
+  FuzzyInput *in[2];
+  FuzzyOutput *out;
+  for (int k = 0; k < 2; k++)
+  {
+    FuzzySet *s = makeSet(it.firstSet + k);
+    in[k] = new FuzzyInput(*s);
+    delete s;
+  }
+  FuzzySet *s = makeSet(it.firstSet + 2);
+  out = new FuzzyOutput(*s);
+  delete s;
+  FuzzyIIORules *r = new FuzzyIIORules(in[0], in[1], out);
+  const Rule *rule = ruleTable(base) + it.firstRule;
+  int n1 = in[0]->count();
+  int n = n1 * in[1]->count();
+  for (int k = 0; k < n; k++)
+    if (rule[k].out >= 0 && rule[k].out < int(out->count()))
+      r->add(FuzzyInferenceRules::Operations(rule[k].op), k % n1, k / n1, rule[k].out);
+  return new FuzzyData(in[0], in[1], out, r);
+}
+
+// end of fuzzyloader.cc
@@ -0,0 +1,181 @@
+/////////////////////////////////////////////////////////////////////////////
+// fuzzyloader.h
+//
+// Copyright (c) 2026 agent <agent@local>
+//
+// This library is licensed under GNU Library GPL. See the file COPYING.
+//
+// Warning: this is EXPERIMENTAL code, interfaces can be changed
+//
+// Loading of fuzzy models for Fuzzy subsystem for SIMLIB
+// 
+/////////////////////////////////////////////////////////////////////////////
+// Native analyzer of MeFE XML (no XML library is needed) and binary images
+// of fuzzy sets and controllers.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef FUZZYLOADER_H
+#define FUZZYLOADER_H
+
+#include "fuzzydata.h"
+#include <string>
+#include <vector>
+
+/**
+ * Analyzer of XML definition of fuzzy model in the same format as FuzzyAnalyzer
+ * (MeFE program). It reads the file in one pass without XML library, there is
+ * no validation against DTD.<br>
+ * Analyztor XML definice fuzzy modelu ve stejnm formtu jako FuzzyAnalyzer
+ * (program MeFE). te soubor jednm prchodem bez XML knihovny, neprovd
+ * ovovn proti DTD.
+ * @ingroup xml
+ */
+class FuzzyLoader: public Analyzer
+{
+  public:
+    /** It creates a fully defined object.<br>Vytvo pln definovan objekt. */
+    FuzzyLoader() : data(NULL) { init(); }
+    virtual ~FuzzyLoader() { clear(); }
+    /**
+     * It analyzes file with xml definition of fuzzy model.<br>
+     * Analyzuje soubor, kter obsahuje xml definici fuzzy modelu.
+     * @param fileName Name of file with XML data.<br>Jmno souboru s XML daty.
+     */
+    // implemented in fuzzyloader.cc
+    virtual void analyze(char * fileName);
+    /**
+     * It analyzes xml definition of fuzzy model in memory.<br>
+     * Analyzuje xml definici fuzzy modelu v pamti.
+     */
+    // implemented in fuzzyloader.cc
+    void analyze(const char *text, unsigned long length, const char *name = "(memory)");
+    /** It returns number of indicated erros.<br>Vrac poet indikovanch chyb. */
+    virtual int getNumErrors() { return errors; }
+    /** It returns number of indicated fatal errors.<br>Vrac poet indikovanch fatlnch chyb. */
+    virtual int getNumFatalErrors() { return fatalErrors; }
+    /** It returns number of indicated warnings.<br> Vrac poet indikovanch varovn. */
+    virtual int getNumWarnings() { return 0; }
+    /**
+     * It returns data obtained by analysis (NULL after error). User must see about
+     * dealocation of memory.<br>
+     * Vrt data zskan analzou (NULL po chyb). Uivatel se mus sm postarat
+     * o uvolnn alokovan pamti.
+     */
+    virtual AnalyzedData * getAnalyzedData() { return data; }
+  protected:
+    /** Attribute of element.<br>Atribut elementu. */
+    struct Attribute { std::string name, value; };
+    // implemented in fuzzyloader.cc
+    void init();
+    // implemented in fuzzyloader.cc
+    void clear();
+    // implemented in fuzzyloader.cc
+    const char *attribute(const char *name);
+    // implemented in fuzzyloader.cc
+    double number(const char *name);
+    // implemented in fuzzyloader.cc
+    void startElement(const std::string &name);
+    // implemented in fuzzyloader.cc
+    void endElement(const std::string &name);
+    // implemented in fuzzyloader.cc
+    void error(const char *msg, bool fatal=false);
+
+    const char *fileName;             /**< Name for error messages. */
+    unsigned line;                    /**< Actual line. */
+    bool failed;                      /**< Error indicated, stop analysis. */
+    int  errors;                      /**< A number of errors.  */
+    int  fatalErrors;                 /**< A number of fatal errors. */
+    std::vector<Attribute> attrs;     /**< Attributes of actual element. */
+    unsigned nattrs;                  /**< A number of valid attributes. */
+    unsigned int  numSets;            /**< A number of actualy defined fuzzy sets. */
+    unsigned int  numRows;            /**< A number of readed rows of rule matrix. */
+    unsigned int  rowLength;          /**< A lenght of row in rule matrix. */
+    FuzzyInput * in1;                 /**< First input variable. */
+    FuzzyInput * in2;                 /**< Second input variable. */
+    FuzzyOutput * out;                /**< Output variable. */
+    FuzzyIIORules * rules;            /**< A definition of fuzzy inference rules. */
+    FuzzySet * fset;                  /**< A definition of fuzzy set. */
+    FuzzyMembershipFunction * mf;     /**< An auxiliary variable.  */
+    bool isClass;                     /**< Is class defined? */
+    FuzzyData *data;                  /**< Obtained data. */
+};
+
+/**
+ * Writer of binary image of fuzzy sets and controllers (FuzzyIIORules with
+ * its variables). The image contains flat tables of fixed size records and
+ * a string table, see FuzzyImage.<br>
+ * Zapisova binrnho obrazu fuzzy mnoin a regultor (FuzzyIIORules s jeho
+ * promnnmi). Obraz obsahuje ploch tabulky zznam pevn dlky a tabulku
+ * etzc, viz FuzzyImage.
+ * @ingroup xml
+ */
+class FuzzyImageWriter
+{
+  public:
+    /** It adds fuzzy set.<br>Pid fuzzy mnoinu. */
+    // implemented in fuzzyloader.cc
+    void add(const FuzzySet &set);
+    /** It adds fuzzy set or controller.<br>Pid fuzzy mnoinu nebo regultor. */
+    // implemented in fuzzyloader.cc
+    void add(FuzzyData &data);
+    /** Number of added items.<br>Poet pidanch poloek. */
+    unsigned count() const { return items.size() / 4; }
+    /** It writes image into file.<br>Zape obraz do souboru. */
+    // implemented in fuzzyloader.cc
+    void save(const char *fileName) const;
+  protected:
+    // implemented in fuzzyloader.cc
+    unsigned addSet(const FuzzySet &set);
+    // implemented in fuzzyloader.cc
+    unsigned addString(const char *s);
+    std::vector<unsigned> items;      /**< items (4 words each) */
+    std::vector<char> sets;           /**< set records */
+    std::vector<char> mfs;            /**< membership function records */
+    std::vector<short> rules;         /**< rules (operation, output) */
+    std::string strings;              /**< string table */
+};
+
+/**
+ * Binary image of fuzzy sets and controllers created by FuzzyImageWriter.
+ * The file is mapped into memory (if possible) and used without decoding,
+ * items are created directly from its tables.<br>
+ * Binrn obraz fuzzy mnoin a regultor vytvoen pomoc FuzzyImageWriter.
+ * Soubor je mapovn do pamti (pokud je to mon) a pouvn bez dekdovn,
+ * poloky se vytvej pmo z jeho tabulek.
+ * @ingroup xml
+ */
+class FuzzyImage
+{
+  public:
+    /** It opens image file.<br>Oteve soubor s obrazem. */
+    // implemented in fuzzyloader.cc
+    FuzzyImage(const char *fileName);
+    // implemented in fuzzyloader.cc
+    ~FuzzyImage();
+    /** Number of items.<br>Poet poloek. */
+    // implemented in fuzzyloader.cc
+    unsigned count() const;
+    /** It returns true if i-th item is controller.<br>Vrac true, kdy i-t poloka je regultor. */
+    // implemented in fuzzyloader.cc
+    bool isClass(unsigned i) const;
+    /**
+     * It creates i-th item (see FuzzyData). User must see about dealocation of memory.<br>
+     * Vytvo i-tou poloku (viz FuzzyData). Uivatel se mus sm postarat o uvolnn pamti.
+     */
+    // implemented in fuzzyloader.cc
+    FuzzyData *create(unsigned i) const;
+    /** It creates fuzzy set of i-th item.<br>Vytvo fuzzy mnoinu i-t poloky. */
+    // implemented in fuzzyloader.cc
+    FuzzySet *createSet(unsigned i) const;
+  protected:
+    // implemented in fuzzyloader.cc
+    FuzzySet *makeSet(unsigned s) const;
+    const char *base;                 /**< image in memory */
+    unsigned long size;               /**< size of image */
+    bool mapped;                      /**< memory mapped file */
+  private:
+    FuzzyImage(const FuzzyImage &);   // disable copy
+    FuzzyImage &operator=(const FuzzyImage &);
+};
+
+#endif
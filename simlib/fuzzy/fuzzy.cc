@@ -34,7 +34,7 @@ namespace simlib3 {
  * @param max Maximal value of universum.<br>Horn mez univerza.
  */
 FuzzySet::FuzzySet(const char * name, double min, double max)
- : n(0), xmin(min), xmax(max) 
+ : n(0), xmin(min), xmax(max), samplesN(101)
 { 
   Name = strdup(name);
 }
@@ -46,7 +46,7 @@ FuzzySet::FuzzySet(const char * name, double min, double max)
  */
 FuzzySet::FuzzySet(const char * name, double min, double max,
     const FuzzyMembershipFunction &m1)
- : n(0), xmin(min), xmax(max) 
+ : n(0), xmin(min), xmax(max), samplesN(101)
 {
   Name = strdup(name);
   add(m1);
@@ -60,7 +60,7 @@ FuzzySet::FuzzySet(const char * name, double min, double max,
 FuzzySet::FuzzySet(const char * name, double min, double max,
              const FuzzyMembershipFunction &m1,
 	     const FuzzyMembershipFunction &m2)
- : n(0), xmin(min), xmax(max) 
+ : n(0), xmin(min), xmax(max), samplesN(101)
 {
   Name = strdup(name);
   add(m1);
@@ -76,7 +76,7 @@ FuzzySet::FuzzySet(const char * name, double min, double max,
              const FuzzyMembershipFunction &m1,
 	     const FuzzyMembershipFunction &m2,
 	     const FuzzyMembershipFunction &m3)
- : n(0), xmin(min), xmax(max) 
+ : n(0), xmin(min), xmax(max), samplesN(101)
 {
   Name = strdup(name);
   add(m1);
@@ -94,7 +94,7 @@ FuzzySet::FuzzySet(const char * name, double min, double max,
 	     const FuzzyMembershipFunction &m2,
 	     const FuzzyMembershipFunction &m3,
 	     const FuzzyMembershipFunction &m4)
- : n(0), xmin(min), xmax(max) 
+ : n(0), xmin(min), xmax(max), samplesN(101)
 {
   Name = strdup(name);
   add(m1);
@@ -114,7 +114,7 @@ FuzzySet::FuzzySet(const char * name, double min, double max,
 	     const FuzzyMembershipFunction &m3,
 	     const FuzzyMembershipFunction &m4,
 	     const FuzzyMembershipFunction &m5)
- : n(0), xmin(min), xmax(max) 
+ : n(0), xmin(min), xmax(max), samplesN(101)
 {
   Name = strdup(name);
   add(m1);
@@ -132,7 +132,43 @@ void FuzzySet::add(const FuzzyMembershipFunction &x)
 {
   TRACE(printf("FuzzySet::add(%s)\n", x.wordValue()));
   if (n >= MAX) SIMLIB_error("FuzzySet limit exceeded");
-  array[n++] = x.clone();
+  array[n] = x.clone();
+  kind[n] = array[n]->batchParams(par[n]);
+  ctr[n] = array[n]->center();
+  n++;
+  smp.clear();
+}
+
+/**
+ * It sets number of samples of universum for sampled defuzzification.<br>
+ * Nastav poet vzork univerza pro vzorkovanou defuzzifikaci.
+ */
+void FuzzySet::setResolution(unsigned samples)
+{
+  if (samples < 2) SIMLIB_error("FuzzySet::setResolution: at least 2 samples required!");
+  samplesN = samples;
+  smp.clear();
+}
+
+/**
+ * Values of all functions in equidistant points of universum (computed once).<br>
+ * Hodnoty vech funkc v ekvidistantnch bodech univerza (pot se jednou).
+ */
+const double *FuzzySet::samples() const
+{
+  if (smp.empty())
+  {
+    smp.resize(n * samplesN);
+    double y[MAX];
+    const double step = (xmax - xmin) / (samplesN - 1);
+    for (unsigned k = 0; k < samplesN; k++)
+    {
+      Membership(k + 1 < samplesN ? xmin + k * step : xmax, y);
+      for (unsigned i = 0; i < n; i++)
+        smp[i * samplesN + k] = y[i];
+    }
+  }
+  return &smp[0];
 }
 
 /** It duplicates object.<br>Duplikuje objekt. */
@@ -165,6 +201,57 @@ double FuzzySet::Membership(int i, double x) const
   return array[i]->Membership(x);
 }
 
+/**
+ * It computes values of all functions. Known types of functions are computed here
+ * without virtual calls (the same formulas as in fuzzymf.cc).<br>
+ * Vypote hodnoty vech funkc. Znm typy funkc jsou potny zde bez virtulnch
+ * voln (stejn vzorce jako ve fuzzymf.cc).
+ */
+void FuzzySet::Membership(double x, double *result) const
+{
+  for (unsigned i = 0; i < n; i++)
+  {
+    const double *p = par[i];
+    double y;
+    switch (kind[i])
+    {
+      case FuzzyMembershipFunction::mfSingleton:
+        y = (x == p[0]) ? 1 : 0;
+        break;
+      case FuzzyMembershipFunction::mfTriangle:
+        if (x == p[1]) y = 1;
+        else if (x > p[0] && x <= p[1]) y = (x - p[0]) / (p[1] - p[0]);
+        else if (x > p[1] && x <= p[2]) y = (p[2] - x) / (p[2] - p[1]);
+        else y = 0;
+        break;
+      case FuzzyMembershipFunction::mfTrapez:
+        if (x >= p[1] && x <= p[2]) y = 1;
+        else if (x > p[0] && x < p[1]) y = (x - p[0]) / (p[1] - p[0]);
+        else if (x > p[2] && x < p[3]) y = (p[3] - x) / (p[3] - p[2]);
+        else y = 0;
+        break;
+      case FuzzyMembershipFunction::mfGauss:
+        if (p[1] == 0) y = (x == p[0]) ? 1.0 : 0.0;
+        else y = exp(-((x-p[0])*(x-p[0]))/p[1]);
+        break;
+      case FuzzyMembershipFunction::mfGauss2:
+      {
+        double y1, y2;
+        if (p[1] == 0) y1 = (x < p[0]) ? 0.0 : 1.0;
+        else y1 = (x < p[0]) ? exp(-(x-p[0])*(x-p[0])/p[1]) : 1.0;
+        if (p[3] == 0) y2 = (x > p[2]) ? 0.0 : 1.0;
+        else y2 = (x > p[2]) ? exp(-(x-p[2])*(x-p[2])/p[3]) : 1.0;
+        y = y1*y2;
+        break;
+      }
+      default:
+        y = array[i]->Membership(x);
+        break;
+    }
+    result[i] = y;
+  }
+}
+
 /** Destructor removes all membership functions.<br>Destruktor uvoln vechny funkce pslunosti. */
 FuzzySet::~FuzzySet() 
 {
@@ -256,7 +343,9 @@ const FuzzyMembershipFunction *FuzzyVariable::mf(int i) const
 /** It gets center of i-th member function.<br>Vrac sted i-t funkce pslunosti. */
 double FuzzyVariable::center(int i) const 
 {
-  return mf(i)->center();
+  if(unsigned(i)>=n) 
+    SIMLIB_error("FuzzyVariable::center(i) index out of range");
+  return m->center(i);
 }
 
 /** It gets i-th word value.<br>Vrac i-tou slovn hondotu. */
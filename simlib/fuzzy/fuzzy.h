@@ -35,6 +35,8 @@
 
 #include "simlib.h"
 #include <vector>
+#include <list>
+#include <map>
 
 namespace simlib3 {
 
@@ -170,6 +172,23 @@ class FuzzyMembershipFunction
     virtual void addDefValue(double value) = 0;
     /** It retuns number of definition values.<br>Vrt poet defininch hodnot. */
     virtual int getNumValues() = 0;
+    /** Types of functions for batch evaluation.<br>Typy funkc pro dvkov vyhodnocen. */
+    enum BatchTypes { mfGeneral, mfSingleton, mfTriangle, mfTrapez, mfGauss, mfGauss2 };
+    /**
+     * Type and parameters for fast evaluation in FuzzySet, mfGeneral means that virtual
+     * method Membership is used.<br>
+     * Typ a parametry pro rychl vyhodnocen ve FuzzySet, mfGeneral znamen, e se
+     * pouije virtuln metoda Membership.
+     * @param p Array of 4 parameters.<br>Pole 4 parametr.
+     */
+    // implemented in fuzzymf.cc
+    virtual int batchParams(double *p) const;
+    /**
+     * It returns i-th definition value (see addDefValue).<br>
+     * Vrt i-tou definin hodnotu (viz addDefValue).
+     */
+    // implemented in fuzzymf.cc
+    virtual double getDefValue(int i) const;
 };//FuzzyMembershipFunction 
 
 /////////////////////////////////////////////////////////////////////////////
@@ -219,6 +238,10 @@ class FuzzySingleton: public FuzzyMembershipFunction
     virtual void addDefValue(double value);
     /** It retuns number of definition values.<br>Vrt poet defininch hodnot. */
     virtual int getNumValues() { return 1; }
+    // implemented in fuzzymf.cc
+    virtual int batchParams(double *p) const;
+    // implemented in fuzzymf.cc
+    virtual double getDefValue(int i) const;
 };//FuzzySingleton
 
 /**
@@ -265,6 +288,10 @@ class FuzzyTriangle: public FuzzyMembershipFunction
     /** This adds next definition value.<br>Pid dal definin hodnotu. */
     // implemented in fuzzymf.cc
     virtual void addDefValue(double value);
+    // implemented in fuzzymf.cc
+    virtual int batchParams(double *p) const;
+    // implemented in fuzzymf.cc
+    virtual double getDefValue(int i) const;
 };//FuzzyTriangle
 
 /////////////////////////////////////////////////////////////////////////////
@@ -316,6 +343,10 @@ class FuzzyTrapez: public FuzzyMembershipFunction
     /** This adds next definition value.<br>Pid dal definin hodnotu. */
     // implemented in fuzzymf.cc
     virtual void addDefValue(double value);
+    // implemented in fuzzymf.cc
+    virtual int batchParams(double *p) const;
+    // implemented in fuzzymf.cc
+    virtual double getDefValue(int i) const;
 };// FuzzyTrapez
 
 /////////////////////////////////////////////////////////////////////////////
@@ -364,6 +395,10 @@ class FuzzyGauss: public FuzzyMembershipFunction
     /** This adds next definition value.<br>Pid dal definin hodnotu. */
     // implemented in fuzzymf.cc
     virtual void addDefValue(double value);
+    // implemented in fuzzymf.cc
+    virtual int batchParams(double *p) const;
+    // implemented in fuzzymf.cc
+    virtual double getDefValue(int i) const;
 };// FuzzyGauss
 
 /**
@@ -416,6 +451,10 @@ class FuzzyGauss2 : public FuzzyMembershipFunction
     /** This adds next definition value.<br>Pid dal definin hodnotu. */
     // implemented in fuzzymf.cc
     virtual void addDefValue(double value);
+    // implemented in fuzzymf.cc
+    virtual int batchParams(double *p) const;
+    // implemented in fuzzymf.cc
+    virtual double getDefValue(int i) const;
   protected:
     double leftSigma;     /**< A radius of the left function. */
     double leftCenter;    /**< A center of the left function. */
@@ -445,11 +484,17 @@ class FuzzyGauss2 : public FuzzyMembershipFunction
  */
 class FuzzySet 
 {
+  public:
+    enum { MAX=10 };    /**< implementation limit */
   protected:
     unsigned n;         /**< actual number of elements */
-    enum { MAX=10 };    /**< implementation limit */
     const FuzzyMembershipFunction *array[MAX]; /**< is owner of objects on pointers */
+    int kind[MAX];      /**< type of function for batch evaluation (0 = general) */
+    double par[MAX][4]; /**< parameters for batch evaluation */
+    double ctr[MAX];    /**< centers of functions */
     double xmin, xmax;  /**< limits */
+    unsigned samplesN;  /**< resolution of sampled defuzzification */
+    mutable std::vector<double> smp; /**< tabulated functions, see samples() */
     char * Name;        /**< name of this set */
   public:
     /**
@@ -529,10 +574,17 @@ class FuzzySet
     /** It computes i-th function value (membership).<br>Vypote i-tou funkn hodnotu (pslunost). */
     // implemented in fuzzy.cc
     double Membership(int i, double x) const;
+    /**
+     * It computes values of all functions (batch evaluation without virtual calls).<br>
+     * Vypote hodnoty vech funkc (dvkov vyhodnocen bez virtulnch voln).
+     * @param result Array of count() values.<br>Pole count() hodnot.
+     */
+    // implemented in fuzzy.cc
+    void Membership(double x, double *result) const;
     /** Minimal value of universum.<br>Spodn mez univerza. */
-    double min() { return xmin; }
+    double min() const { return xmin; }
     /** Maximal value of universum.<br>Horn mez univerza. */
-    double max() { return xmax; }
+    double max() const { return xmax; }
     /** Name of this fuzzy set.<br>Jmno tto fuzzy mnoiny. */
     const char * name() const { return Name; }
     /** Word value of i-th membership function.<br>Slovn hodnota i-t funkce pslunosti. */
@@ -543,6 +595,28 @@ class FuzzySet
     /** Maximum of maxims.<br>Maximum z maxim. */
     // implemented in fuzzy.cc
     double max1(); // max of 1
+    /** Center of i-th function (no range check).<br>Sted i-t funkce (bez kontroly mez). */
+    double center(int i) const { return ctr[i]; }
+    /** Type of i-th function, see FuzzyMembershipFunction::BatchTypes.<br>Typ i-t funkce. */
+    int batchKind(int i) const { return kind[i]; }
+    /** Parameters of i-th function for batch evaluation.<br>Parametry i-t funkce pro dvkov vyhodnocen. */
+    const double *batchParams(int i) const { return par[i]; }
+    /**
+     * It sets number of samples of universum for sampled defuzzification (default 101).<br>
+     * Nastav poet vzork univerza pro vzorkovanou defuzzifikaci (implicitn 101).
+     */
+    // implemented in fuzzy.cc
+    void setResolution(unsigned samples);
+    /** Number of samples of universum.<br>Poet vzork univerza. */
+    unsigned resolution() const { return samplesN; }
+    /**
+     * Values of all functions in resolution() equidistant points of universum,
+     * function i starts at index i*resolution(). Computed at first use.<br>
+     * Hodnoty vech funkc v resolution() ekvidistantnch bodech univerza,
+     * funkce i zan na indexu i*resolution(). Vypoteno pi prvnm pouit.
+     */
+    // implemented in fuzzy.cc
+    const double *samples() const;
     
 }; // FuzzySet
 
@@ -593,6 +667,10 @@ class FuzzyVariable : public aContiBlock
     void registerOwner(FuzzyBlock *owner);  // registration inside owner
     /** Number of members.<br>Poet len. */
     unsigned count() const { return n; } 
+    /** Minimal value of universum.<br>Spodn mez univerza. */
+    double getMin() const { return m->min(); }
+    /** Maximal value of universum.<br>Horn mez univerza. */
+    double getMax() const { return m->max(); }
     /** I-th member function.<br>I-t funkce pslunosti. */
     // implemented in fuzzy.cc
     const FuzzyMembershipFunction *mf(int i) const;
@@ -611,6 +689,16 @@ class FuzzyVariable : public aContiBlock
     // implemented in fuzzy.cc
     unsigned search(const char *s) const; 
     
+    /** Fuzzy set of this variable.<br>Fuzzy mnoina tto promnn. */
+    const FuzzySet *fuzzySet() const { return m; }
+    /** All fuzzy values (count() items).<br>Vechny fuzzy hodnoty (count() poloek). */
+    const double *values() const { return mval; }
+    /**
+     * It sets number of samples for sampled defuzzification.<br>
+     * Nastav poet vzork pro vzorkovanou defuzzifikaci.
+     */
+    void setResolution(unsigned samples) { m->setResolution(samples); }
+    
     /** Fuzzify all membership functions.<br>Fuzzifikuje vechny funkce pslunosti.*/
     // implemented in fuzzyio.cc
     void Fuzzify(double x);
@@ -696,8 +784,11 @@ class FuzzyInput : public FuzzyVariable {
  * @ingroup fuzzy
  */
 class FuzzyOutput: public FuzzyVariable {
+    friend class FuzzyBlockArray;
+    friend class FuzzySampledBlock;
     double value; /**? value after defuzzification */ 
     double (*defuzzify)(const FuzzyVariable&); /**< defuzzification function */  // remove!!!!!!!####
+    bool preset;  /**< value set by setValue, no defuzzification in Done */
   public:
     /**
      * It adds fuzzy set and defuzzification function.<br>
@@ -728,11 +819,19 @@ class FuzzyOutput: public FuzzyVariable {
      */
     // implemented in fuzzyrul.cc
     double Value();
+    /**
+     * It sets sharp value directly (e.g. from lookup table), the next Done
+     * does not defuzzify.<br>
+     * Nastav pmo ostrou hodnotu (nap. z vyhledvac tabulky), nsledujc
+     * Done nedefuzzifikuje.
+     */
+    // implemented in fuzzyrul.cc
+    void setValue(double v);
 //inherited:  virtual void Init() { for(int i=0; i<n; i++) mval[i]=0.0F; }
     /** 
      * It defuzzifies itself.<br> Defuzzifikuje se. 
      */
-    virtual void Done() { Defuzzify(); }
+    virtual void Done() { if (preset) preset = false; else Defuzzify(); }
     // implemented in fuzzyrul.cc
     virtual ~FuzzyOutput();
 }; // FuzzyOutput
@@ -769,6 +868,33 @@ double defuzMaxOfMax(const FuzzyVariable &fs);
  */
 // implemented in fuzzyio.cc
 double defuzDCOG(const FuzzyVariable &fs);
+/**
+ * @ingroup fuzzy
+ * Defuzzification method "center-of-gravity" of functions clipped by fuzzy values
+ * and aggregated by maximum. Exact for triangles and trapezoids, other sets are
+ * sampled (see FuzzyVariable::setResolution).<br>
+ * Defuzifikan metoda "tit" funkc oznutch fuzzy hodnotami a sjednocench
+ * maximem. Pesn pro trojhelnky a lichobnky, ostatn mnoiny jsou vzorkovny
+ * (viz FuzzyVariable::setResolution).
+ */
+// implemented in fuzzyio.cc
+double defuzCOG(const FuzzyVariable &fs);
+/**
+ * @ingroup fuzzy
+ * Defuzzification method "center-of-gravity" computed always from samples of universum.<br>
+ * Defuzifikan metoda "tit" potan vdy ze vzork univerza.
+ */
+// implemented in fuzzyio.cc
+double defuzSampledCOG(const FuzzyVariable &fs);
+/**
+ * @ingroup fuzzy
+ * Defuzzification method "center-of-sums": center of gravity of the sum of clipped
+ * functions. Closed form for triangles, trapezoids and gaussians.<br>
+ * Defuzifikan metoda "sted sout": tit soutu oznutch funkc.
+ * Analyticky pro trojhelnky, lichobnky a gaussovsk funkce.
+ */
+// implemented in fuzzyio.cc
+double defuzCOS(const FuzzyVariable &fs);
 
 /////////////////////////////////////////////////////////////////////////////
 // FuzzyBlock --- base class for inference blocks
@@ -784,7 +910,7 @@ class FuzzyBlock
     FuzzyBlock *where;            /**< position in hierarchical structure */
     double lastTime;              /**< time of last evaluation */ 
     virtual void Behavior() = 0;  /**< user defined fuzzy rules */ 
-    dlist<FuzzyVariable*> vlist;  /**< all fuzzy variables in the block */ 
+    std::list<FuzzyVariable*> vlist; /**< all fuzzy variables in the block */
   public:
     /**
      * If inference rules are specified by FuzzyExpr way then you must call 
@@ -871,11 +997,21 @@ class FuzzySampledBlock
   
     FSampler *sampler;
 
+    double tolerance;             /**< relative size of input cell, 0 = sampling by time */
+    bool invalid;                 /**< evaluation forced by Invalidate() */
+    unsigned cacheSize;           /**< maximal number of cached cells */
+    unsigned long evaluations;    /**< number of evaluations of rules */
+    unsigned long hits;           /**< number of outputs taken from cache */
+    std::vector<long> cell;       /**< input cell of last evaluation */
+    std::map<std::vector<long>, std::vector<double> > cache; /**< output values of cells */
+
     /**
      * Will contain user defined inference rules.<br>
      * Bude obsahovat uivatelem definovan inferenn pravidla.
      */
     virtual void Behavior() = 0;  
+    // implemented in fuzzyrul.cc
+    void EvaluateRules();
   public:
     /**
      * It creates and initializes the sampler object.
@@ -885,7 +1021,9 @@ class FuzzySampledBlock
      * Jestlie jsou inferenn pravidla specifikovna pomoc FuzzyExpr, pak muste
      * zavolat metodu EndConstructor na konci konstruktoru.
      */
-    FuzzySampledBlock() { sampler = new FSampler(this); }
+    FuzzySampledBlock() 
+    : tolerance(0), invalid(false), cacheSize(0), evaluations(0), hits(0)
+    { sampler = new FSampler(this); }
     virtual ~FuzzySampledBlock() { TRACE(printf("~FuzzySampledBlock")); }
     /**
      * It sets the time step for sampling.<br>
@@ -894,11 +1032,53 @@ class FuzzySampledBlock
     void setTimeStep(double timeStep) { sampler->setTimeStep(timeStep); }
     /** It gets time step.<br> Vrt asov krok. */
     double getTimeStep() { return sampler->getTimeStep(); }
-    /** It starts sampling.<br> Nastartuje vzorkovn. */
-    void Start() { sampler->Activate(); }
     /**
-     * It evaluates fuzzy inference rules but only in sampled time steps.<br>
-     * Vyhodnot fuzzy inferenn pravidla, ale jenom ve vzorkovanch asovch okamicch.
+     * It starts sampling. Nothing is scheduled for zero time step (evaluation
+     * on demand, see setTolerance).<br>
+     * Nastartuje vzorkovn. Pro nulov asov krok se nic neplnuje
+     * (vyhodnocen na podn, viz setTolerance).
+     */
+    void Start() { if (getTimeStep() > 0) sampler->Activate(); }
+    /**
+     * It switches to change-driven evaluation. The universum of each input is divided
+     * into cells of size tolerance*(max-min) and the rules are evaluated only when some
+     * input moves into another cell (or after Invalidate), outputs hold their values
+     * otherwise. Zero tolerance means sampling by time step.<br>
+     * Pepne na vyhodnocen zen zmnou. Univerzum kadho vstupu je rozdleno
+     * na buky velikosti tolerance*(max-min) a pravidla se vyhodnot jen kdy se nkter
+     * vstup pesune do jin buky (nebo po Invalidate), jinak vstupy dr svou hodnotu.
+     * Nulov tolerance znamen vzorkovn podle asovho kroku.
+     */
+    // implemented in fuzzyrul.cc
+    void setTolerance(double tolerance);
+    /** Relative tolerance of inputs.<br>Relativn tolerance vstup. */
+    double getTolerance() const { return tolerance; }
+    /**
+     * It sets maximal number of input cells with cached output values (0 = no cache).
+     * When an input returns into a cached cell, outputs are restored without
+     * evaluation (fuzzy values of outputs are not restored).<br>
+     * Nastav maximln poet bunk vstup s uloenmi hodnotami vstup (0 = bez
+     * cache). Kdy se vstup vrt do uloen buky, vstupy se obnov bez vyhodnocen
+     * (fuzzy hodnoty vstup se neobnovuj).
+     */
+    // implemented in fuzzyrul.cc
+    void setCacheSize(unsigned cells);
+    /**
+     * It forces evaluation at next request and clears cache, use it e.g. in state
+     * event when rules depend on other values than inputs.<br>
+     * Vynut vyhodnocen pi dalm poadavku a vyprzdn cache, pouijte jej nap.
+     * ve stavov udlosti, kdy pravidla zvis i na jinch hodnotch ne na vstupech.
+     */
+    void Invalidate() { invalid = true; cache.clear(); }
+    /** Number of evaluations of rules.<br>Poet vyhodnocen pravidel. */
+    unsigned long getEvaluations() const { return evaluations; }
+    /** Number of evaluations replaced by cache.<br>Poet vyhodnocen nahrazench cache. */
+    unsigned long getCacheHits() const { return hits; }
+    /**
+     * It evaluates fuzzy inference rules but only in sampled time steps or after
+     * change of inputs (see setTolerance).<br>
+     * Vyhodnot fuzzy inferenn pravidla, ale jenom ve vzorkovanch asovch okamicch
+     * nebo po zmn vstup (viz setTolerance).
      */
     // implemented in fuzzyrul.cc
     virtual void Evaluate();
@@ -909,6 +1089,7 @@ class FuzzySampledBlock
 // 
 class FuzzyRule;
 class FuzzyRuleFactory;
+class FONode;
 
 /**
  * Abstract class for representation and evaluation of inference rules.
@@ -1137,6 +1318,34 @@ class FuzzyIIORules
               int in2WVIndex, 
               const char *outWordValue);
 
+    /**
+     * It precomputes control surface of the controller into table n1*n2 over universes
+     * of both inputs. Method evaluate then uses bilinear interpolation in the table
+     * instead of inference and defuzzification. The table is valid until rules or
+     * defuzzification method are changed.<br>
+     * Pedpot dic plochu regultoru do tabulky n1*n2 nad univerzy obou vstup.
+     * Metoda evaluate pak msto inference a defuzzifikace pouije bilinern interpolaci
+     * v tabulce. Tabulka plat, dokud se nezmn pravidla nebo metoda defuzzifikace.
+     * @param n1 Number of points for first input.<br>Poet bod pro prvn vstup.
+     * @param n2 Number of points for second input.<br>Poet bod pro druh vstup.
+     */
+    //implemented in rules.cc
+    void createLookupTable(unsigned n1 = 65, unsigned n2 = 65);
+    /** It removes lookup table, inference is used.<br>Zru tabulku, pouije se inference. */
+    void removeLookupTable() { table.clear(); }
+    /** It tests if lookup table is used.<br>Testuje, jestli se pouv tabulka. */
+    bool hasLookupTable() const { return !table.empty(); }
+
+    /** Number of added rules.<br>Poet pidanch pravidel. */
+    int getNumRules() const { return rules; }
+    /**
+     * Operation of i-th rule, i = in2WVIndex*in1->count() + in1WVIndex.<br>
+     * Operace i-tho pravidla, i = in2WVIndex*in1->count() + in1WVIndex.
+     */
+    Operations getOperation(int i) const { return operation[i]; }
+    /** Index of output word value of i-th rule.<br>Index vstupn slovn hodnoty i-tho pravidla. */
+    int getOutWV(int i) const { return outWV[i]; }
+
   protected:
     /** Array of indexes into FuzzyOutput variable.<br> Pole index do promnn FuzzyOutput. */
     int *outWV; 
@@ -1150,6 +1359,12 @@ class FuzzyIIORules
     /** Maximum number of variables.<br> Maximln poet promnnch. */
     static const int MAX_INPUTS = 2;
     static const int MAX_OUTPUTS = 1;
+    /** Lookup table of output values (by rows of second input).<br>Tabulka vstupnch hodnot. */
+    std::vector<double> table;
+    /** Size of table.<br>Rozmry tabulky. */
+    unsigned tableN1, tableN2;
+    /** Origin and steps of table.<br>Potek a kroky tabulky. */
+    double table1, tableStep1, table2, tableStep2;
     
     /** It tests if all arrays are allocated.<br>Testuje, jestli u jsou alokovna pole. */
     //implemented in rules.cc
@@ -1179,15 +1394,16 @@ class FuzzyIIORules
 class FuzzyGeneralRules
 : public FuzzyInferenceRules
 {
+  friend class FuzzyBlockArray;
   public:
+    /** Constructor.<br>Konstruktor. */
+    FuzzyGeneralRules() : compiled(false), version(0), profile(false), evaluations(0), evalTime(0) { }
     /**
-     * It destroys vector of rules
+     * It destroys vector of rules. Rules added with release are released.<br>
+     * Zru vektor pravidel. Pravidla vloen s release jsou uvolnna.
      */
-    ~FuzzyGeneralRules()
-    {
-      TRACE(printf("~FuzzyGeneralRules\n"));
-      rules.erase(rules.begin(), rules.end());
-    }
+    //implemented in rules.cc
+    ~FuzzyGeneralRules();
     /**
      * It returns true when all variables are assigned.<br>
      * Testuje, jestli u jsou piazeny vechny promnn.
@@ -1203,7 +1419,10 @@ class FuzzyGeneralRules
      * Pid dal pravidlo do seznamu. Pokud u je definovno pli pravidel, nastane chyba.
      * @param rule Inference rule who is represented by tree structure.<br>
      *             Inferenn pravidlo reprezentovan stromovou strukturou.
-     * @param release It has no meaning here.<br>Zde nem vznam.
+     * @param release Rule will be released by this object (destructor or prune).
+     *                Default it is true.<br>
+     *                Pravidlo uvoln tento objekt (destruktor nebo prune).
+     *                Implicitn nastaveno true.
      */
     //implemented in rules.cc
     virtual void add(FuzzyRule *rule, bool release=true);
@@ -1216,10 +1435,102 @@ class FuzzyGeneralRules
      */
     //implemented in rules.cc
     virtual void evaluate();
+
+    /**
+     * It translates rule trees into flat program (postfix code) for fast evaluation.
+     * It is called automatically by evaluate after change of rules.<br>
+     * Pelo stromy pravidel do plochho programu (postfixov kd) pro rychl 
+     * vyhodnocen. Vol se automaticky z evaluate po zmn pravidel.
+     */
+    //implemented in rules.cc
+    void compile();
+
+    /** Number of rules.<br>Poet pravidel. */
+    unsigned getNumRules() const { return rules.size(); }
+    /**
+     * It switches profiling of evaluate on/off. Profile contains number of activations
+     * and strength of each rule and time spent in evaluate.<br>
+     * Zapne/vypne profilovn funkce evaluate. Profil obsahuje poet aktivac a slu
+     * kadho pravidla a as strven ve funkci evaluate.
+     */
+    //implemented in rules.cc
+    void setProfiling(bool on);
+    /** It clears profile.<br>Vynuluje profil. */
+    //implemented in rules.cc
+    void clearProfile();
+    /** Number of profiled evaluations.<br>Poet profilovanch vyhodnocen. */
+    unsigned long getEvaluations() const { return evaluations; }
+    /** Time of profiled evaluations [s].<br>as profilovanch vyhodnocen [s]. */
+    double getEvaluateTime() const { return evalTime; }
+    /** Number of evaluations with nonzero strength of i-th rule.<br>Poet vyhodnocen s nenulovou silou i-tho pravidla. */
+    unsigned long getRuleActivations(unsigned i) const { return i < fired.size() ? fired[i] : 0; }
+    /** Mean strength of i-th rule.<br>Prmrn sla i-tho pravidla. */
+    double getRuleStrength(unsigned i) const 
+    { return (i < strength.size() && evaluations > 0) ? strength[i] / evaluations : 0; }
+    /** Maximal strength of i-th rule.<br>Maximln sla i-tho pravidla. */
+    double getRuleMaxStrength(unsigned i) const { return i < maxStrength.size() ? maxStrength[i] : 0; }
+    /** It prints profile.<br>Vytiskne profil. */
+    //implemented in rules.cc
+    void printProfile();
+    /**
+     * It removes rules which never reach strength above threshold on recorded input trace.
+     * Trace contains rows of values of all inputs (in order of addFuzzyInput). Profile
+     * is cleared. Removed rules are released only if they were added with release.
+     * It returns number of removed rules.<br>
+     * Odstran pravidla, jejich sla nikdy nepekro prh na zaznamenanm prbhu
+     * vstup. Zznam obsahuje dky hodnot vech vstup (v poad addFuzzyInput).
+     * Profil se vynuluje. Odstrann pravidla se uvoln, jen pokud byla vloena
+     * s release. Vrac poet odstrannch pravidel.
+     */
+    //implemented in rules.cc
+    unsigned prune(const std::vector<double> &trace, double threshold=0);
+    /**
+     * It returns true if some rule uses i-th word value of variable. Unused membership
+     * functions (e.g. after prune) can be removed from definition of fuzzy set.<br>
+     * Vrac true, kdy nkter pravidlo pouv i-tou slovn hodnotu promnn. Nepouit
+     * funkce pslunosti (nap. po prune) lze odstranit z definice fuzzy mnoiny.
+     */
+    //implemented in rules.cc
+    bool isUsed(const FuzzyVariable *var, unsigned i);
   protected:
     /** Vector of rules. */
     std::vector<FuzzyRule *> rules;
+    /** Rule is released by this object (see add).<br>Pravidlo uvoln tento objekt (viz add). */
+    std::vector<bool> owned;
+    /** 
+     * Instruction of compiled rules: operation and membership value of input word value
+     * (operand of LOAD).<br>
+     * Instrukce peloench pravidel: operace a hodnota pslunosti vstupn slovn
+     * hodnoty (operand instrukce LOAD).
+     */
+    struct Instruction {
+      int op;
+      const double *arg;
+    };
+    /** Program of all rules.<br>Program vech pravidel. */
+    std::vector<Instruction> code;
+    /** End of i-th rule in code.<br>Konec i-tho pravidla v kdu. */
+    std::vector<unsigned> codeEnd;
+    /** Membership values of output word values (consequents).<br>Hodnoty pslunosti konsekvent. */
+    std::vector<double *> target;
+    /** End of consequents of i-th rule in target.<br>Konec konsekvent i-tho pravidla. */
+    std::vector<unsigned> targetEnd;
+    /** Stack for evaluation.<br>Zsobnk pro vyhodnocen. */
+    std::vector<double> stack;
+    /** Code is up to date.<br>Kd je aktuln. */
+    bool compiled;
+    /** Number of changes of rules (add, prune).<br>Poet zmn pravidel (add, prune). */
+    unsigned long version;
+    /** Profiling is on.<br>Profilovn je zapnuto. */
+    bool profile;
+    unsigned long evaluations;          /**< number of profiled evaluations */
+    double evalTime;                    /**< time of profiled evaluations */
+    std::vector<unsigned long> fired;   /**< activations of rules */
+    std::vector<double> strength;       /**< sum of strength of rules */
+    std::vector<double> maxStrength;    /**< maximal strength of rules */
   private:
+    //implemented in rules.cc
+    void compile(FONode *node, unsigned &depth, unsigned &maxdepth);
 }; // FuzzyGeneralRules
 
 /**
@@ -1254,6 +1565,118 @@ class FuzzyRSBlock
     FuzzyInferenceRules &rules;
 }; // FuzzyRSBlock
 
+/////////////////////////////////////////////////////////////////////////////
+// FuzzyBlockArray --- many instances of one fuzzy controller
+//
+/**
+ * Array of instances of one fuzzy controller. All instances share the rule base,
+ * fuzzy sets and defuzzification methods of one FuzzyGeneralRules object (its inputs
+ * and outputs are used as patterns only). Each instance keeps only its input and
+ * output values. All instances are evaluated together, each operation of compiled
+ * rules runs over a block of instances. The rules must be complete before the array
+ * is created. Rules can be added or pruned later, the array is translated again before
+ * the next evaluation.<br>
+ * Pole instanc jednoho fuzzy regultoru. Vechny instance sdlej bzi pravidel,
+ * fuzzy mnoiny a defuzzifikan metody jednoho objektu FuzzyGeneralRules (jeho vstupy
+ * a vstupy slou pouze jako vzor). Kad instance m jen sv vstupn a vstupn
+ * hodnoty. Vechny instance se vyhodnocuj spolen, kad operace peloench
+ * pravidel probh nad blokem instanc. Pravidla mus bt pln ped vytvoenm pole.
+ * Pravidla lze pozdji pidat nebo proezat, pole se ped dalm vyhodnocenm
+ * pelo znovu.
+ * @ingroup fuzzy
+ */
+class FuzzyBlockArray
+{
+  public:
+    /**
+     * Continuous output of one instance.<br>Spojit vstup jedn instance.
+     */
+    class Out : public aContiBlock
+    {
+        FuzzyBlockArray *array;
+        unsigned inst, out;
+      public:
+        /**
+         * @param a Array of controllers.<br>Pole regultor.
+         * @param instance Index of instance.<br>Index instance.
+         * @param output Index of output variable.<br>Index vstupn promnn.
+         */
+        // implemented in fuzzyarray.cc
+        Out(FuzzyBlockArray &a, unsigned instance, unsigned output=0);
+        /** It evaluates array if needed.<br>Podle poteby vyhodnot pole. */
+        // implemented in fuzzyarray.cc
+        virtual double Value();
+    };
+    /**
+     * It creates n instances of controller given by rules.<br>
+     * Vytvo n instanc regultoru zadanho pravidly.
+     * @param rules Shared rule base.<br>Sdlen bze pravidel.
+     * @param n Number of instances.<br>Poet instanc.
+     */
+    // implemented in fuzzyarray.cc
+    FuzzyBlockArray(FuzzyGeneralRules &rules, unsigned n);
+    // implemented in fuzzyarray.cc
+    virtual ~FuzzyBlockArray();
+    /** Number of instances.<br>Poet instanc. */
+    unsigned size() const { return n; }
+    /** Number of inputs of one instance.<br>Poet vstup jedn instance. */
+    unsigned inputs() const { return nin; }
+    /** Number of outputs of one instance.<br>Poet vstup jedn instance. */
+    unsigned outputs() const { return nout; }
+    /**
+     * Sharp input value, it is used when no continuous input is set.<br>
+     * Ostr vstupn hodnota, pouije se, pokud nen nastaven spojit vstup.
+     */
+    double &input(unsigned instance, unsigned k) { return x[instance * nin + k]; }
+    /**
+     * It connects continuous input k of instance.<br>
+     * Pipoj spojit vstup k instance.
+     */
+    // implemented in fuzzyarray.cc
+    void setInput(unsigned instance, unsigned k, Input in);
+    /** Output value after last evaluation.<br>Vstupn hodnota po poslednm vyhodnocen. */
+    double output(unsigned instance, unsigned k=0) const { return y[instance * nout + k]; }
+    /**
+     * Minimal time between evaluations (0 = at every access in new time).<br>
+     * Minimln as mezi vyhodnocenmi (0 = pi kadm pstupu v novm ase).
+     */
+    void setTimeStep(double step) { timeStep = step; }
+    /**
+     * It evaluates all instances if the time step elapsed.<br>
+     * Vyhodnot vechny instance, pokud uplynul asov krok.
+     */
+    // implemented in fuzzyarray.cc
+    void Evaluate();
+    /** It evaluates all instances now.<br>Vyhodnot vechny instance nyn. */
+    // implemented in fuzzyarray.cc
+    void EvaluateAll();
+  protected:
+    enum { BLOCK = 64 };          /**< instances in one pass of code */
+    struct Instruction {
+      int op;                     /**< operation, -1 = load */
+      unsigned arg;               /**< row of membership values */
+    };
+    FuzzyGeneralRules &rules;     /**< shared rules */
+    unsigned n, nin, nout;        /**< instances, inputs, outputs */
+    std::vector<double> x;        /**< inputs (n*nin) */
+    std::vector<double> y;        /**< outputs (n*nout) */
+    std::vector<Input*> in;       /**< continuous inputs (n*nin) or empty */
+    std::vector<unsigned> inRow;  /**< first row of each input */
+    std::vector<unsigned> outRow; /**< first row of each output */
+    std::vector<Instruction> code;
+    std::vector<unsigned> codeEnd;
+    std::vector<unsigned> target; /**< rows of aggregated output values */
+    std::vector<unsigned> targetEnd;
+    std::vector<double> mu;       /**< rows of BLOCK membership values */
+    std::vector<double> stack;    /**< rows of BLOCK values */
+    double lastTime, timeStep;
+    unsigned long version;        /**< version of rules at last compile */
+    // implemented in fuzzyarray.cc
+    void compile();
+    // implemented in fuzzyarray.cc
+    void evaluate(unsigned first, unsigned count);
+}; // FuzzyBlockArray
+
 ///////////////////////////////////////////////////////////////////////////////////////////////
 // FuzzyRule
 // Reprezentace pravidla pomoc stromu objekt. Tento zpsob realizace pravidla nen pli
@@ -0,0 +1,293 @@
+// cz - pli luouk k pl belsk dy
+/////////////////////////////////////////////////////////////////////////////
+// fuzzyarray.cc
+//
+// Copyright (c) 2026 agent <agent@local>
+//
+// This library is licensed under GNU Library GPL. See the file COPYING.
+//
+// Warning: this is EXPERIMENTAL code, interfaces can be changed
+//
+// Fuzzy subsystem for SIMLIB
+// 
+/////////////////////////////////////////////////////////////////////////////
+// Implementation of array of fuzzy controllers with shared rules.
+// Membership values are stored by rows: row r of block contains value r
+// of all BLOCK instances, so each instruction is a simple loop over row.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "simlib.h"
+#include "fuzzy.h"
+#include "internal.h"
+#include <algorithm>
+
+namespace simlib3 {
+
+static const int opLOAD = -1;   // see FuzzyGeneralRules::compile()
+
+/////////////////////////////////////////////////////////////////////////////
+// FuzzyBlockArray::Out --- continuous output of one instance
+//
+FuzzyBlockArray::Out::Out(FuzzyBlockArray &a, unsigned instance, unsigned output)
+  : array(&a), inst(instance), out(output)
+{
+  if (instance >= a.size() || output >= a.outputs())
+    SIMLIB_error("FuzzyBlockArray::Out: index out of range!");
+}
+
+double FuzzyBlockArray::Out::Value()
+{
+  array->Evaluate();
+  return array->output(inst, out);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// FuzzyBlockArray
+//
+/**
+ * It creates n instances of controller given by rules. Inputs are set to the
+ * middle of universum.<br>
+ * Vytvo n instanc regultoru zadanho pravidly. Vstupy jsou nastaveny
+ * na sted univerza.
+ */
+FuzzyBlockArray::FuzzyBlockArray(FuzzyGeneralRules &r, unsigned _n)
+  : rules(r), n(_n), nin(r.in.size()), nout(r.out.size()),
+    x(n * nin), y(n * nout, 0.0), lastTime(-1), timeStep(0), version(0)
+{
+  if (n == 0 || nin == 0 || nout == 0)
+    SIMLIB_error("FuzzyBlockArray: no instances, inputs or outputs!");
+  for (unsigned i = 0; i < n; i++)
+    for (unsigned k = 0; k < nin; k++)
+      x[i * nin + k] = (rules.in[k]->getMin() + rules.in[k]->getMax()) / 2;
+  compile();
+}
+
+FuzzyBlockArray::~FuzzyBlockArray()
+{
+  TRACE(printf("~FuzzyBlockArray()\n"));
+  for (unsigned i = 0; i < in.size(); i++)
+    delete in[i];
+}
+
+/**
+ * It connects continuous input k of instance.<br>
+ * Pipoj spojit vstup k instance.
+ */
+void FuzzyBlockArray::setInput(unsigned instance, unsigned k, Input i)
+{
+  if (instance >= n || k >= nin)
+    SIMLIB_error("FuzzyBlockArray::setInput: index out of range!");
+  if (in.empty())
+    in.resize(n * nin, 0);
+  delete in[instance * nin + k];
+  in[instance * nin + k] = new Input(i);
+}
+
+/**
+ * It translates compiled shared rules: pointers to membership values
+ * of pattern variables are replaced by rows. It is called again after
+ * change of rules.<br>
+ * Pevede peloen sdlen pravidla: ukazatele na hodnoty pslunosti
+ * vzorovch promnnch jsou nahrazeny dky. Vol se znovu po zmn pravidel.
+ */
+void FuzzyBlockArray::compile()
+{
+  if (!rules.compiled)
+    rules.compile();
+  if (rules.in.size() != nin || rules.out.size() != nout)
+    SIMLIB_error("FuzzyBlockArray: number of inputs or outputs of rules changed!");
+  version = rules.version;
+  inRow.clear();
+  outRow.clear();
+  code.clear();
+  target.clear();
+  unsigned rows = 0;
+  for (unsigned k = 0; k < nin; k++)
+  {
+    inRow.push_back(rows);
+    rows += rules.in[k]->count();
+  }
+  for (unsigned k = 0; k < nout; k++)
+  {
+    outRow.push_back(rows);
+    rows += rules.out[k]->count();
+  }
+  for (unsigned pc = 0; pc < rules.code.size(); pc++)
+  {
+    Instruction i = { rules.code[pc].op, 0 };
+    if (i.op == opLOAD)
+    {
+      const double *p = rules.code[pc].arg;
+      unsigned k = 0;
+      while (k < nin && !(p >= rules.in[k]->values() &&
+                          p < rules.in[k]->values() + rules.in[k]->count()))
+        k++;
+      if (k == nin)
+        SIMLIB_error("FuzzyBlockArray: condition uses variable which is not input!");
+      i.arg = inRow[k] + (p - rules.in[k]->values());
+    }
+    code.push_back(i);
+  }
+  for (unsigned t = 0; t < rules.target.size(); t++)
+  {
+    const double *p = rules.target[t];
+    unsigned k = 0;
+    while (k < nout && !(p >= rules.out[k]->values() &&
+                         p < rules.out[k]->values() + rules.out[k]->count()))
+      k++;
+    if (k == nout)
+      SIMLIB_error("FuzzyBlockArray: consequent uses variable which is not output!");
+    target.push_back(outRow[k] + (p - rules.out[k]->values()));
+  }
+  codeEnd = rules.codeEnd;
+  targetEnd = rules.targetEnd;
+  mu.resize(rows * BLOCK);
+  stack.resize(rules.stack.size() * BLOCK);
+}
+
+/**
+ * It evaluates all instances if the time step elapsed.<br>
+ * Vyhodnot vechny instance, pokud uplynul asov krok.
+ */
+void FuzzyBlockArray::Evaluate()
+{
+  if (Time == lastTime || (Time > lastTime && Time - lastTime < timeStep))
+    return;
+  lastTime = Time;
+  EvaluateAll();
+}
+
+/** It evaluates all instances now.<br>Vyhodnot vechny instance nyn. */
+void FuzzyBlockArray::EvaluateAll()
+{
+  if (version != rules.version)
+    compile();                  // rules added or pruned
+  for (unsigned first = 0; first < n; first += BLOCK)
+    evaluate(first, std::min(unsigned(BLOCK), n - first));
+}
+
+/**
+ * It evaluates count instances from first: fuzzification, rules (Mamdani)
+ * and defuzzification.<br>
+ * Vyhodnot count instanc od first: fuzzifikace, pravidla (Mamdani)
+ * a defuzzifikace.
+ */
+void FuzzyBlockArray::evaluate(unsigned first, unsigned count)
+{
+  const unsigned B = BLOCK;
+  double *m = &mu[0];
+  double val[FuzzySet::MAX];
+  for (unsigned k = 0; k < nin; k++)
+  {
+    const FuzzySet *s = rules.in[k]->fuzzySet();
+    const unsigned c = s->count();
+    double *row = m + inRow[k] * B;
+    for (unsigned j = 0; j < count; j++)
+    {
+      unsigned i = (first + j) * nin + k;
+      if (!in.empty() && in[i] != 0)
+        x[i] = in[i]->Value();
+      if (x[i] > s->max() || x[i] < s->min())
+        SIMLIB_error("FuzzyBlockArray: value %g out of range in fuzzy set \"%s\" (instance %u)!",
+                     x[i], s->name(), first + j);
+      s->Membership(x[i], val);
+      for (unsigned t = 0; t < c; t++)
+        row[t * B + j] = val[t];
+    }
+  }
+  std::fill(m + outRow[0] * B, m + mu.size(), 0.0);
+  double *s = &stack[0];
+  unsigned pc = 0, t = 0;
+  for (unsigned r = 0; r < codeEnd.size(); r++)
+  {
+    unsigned sp = 0;            // empty stack
+    for ( ; pc < codeEnd[r]; pc++)
+    {
+      const Instruction &i = code[pc];
+      if (i.op == opLOAD)
+      {
+        std::copy(m + i.arg * B, m + i.arg * B + count, s + sp * B);
+        sp++;
+        continue;
+      }
+      if (i.op == FuzzyInferenceRules::opNOT)
+      {
+        double *a = s + (sp - 1) * B;
+        for (unsigned j = 0; j < count; j++)
+          a[j] = 1 - a[j];
+        continue;
+      }
+      sp--;
+      double *a = s + (sp - 1) * B;
+      const double *b = s + sp * B;
+      switch (i.op)
+      {
+        case FuzzyInferenceRules::opAND:
+          for (unsigned j = 0; j < count; j++) a[j] = a[j] < b[j] ? a[j] : b[j];
+          break;
+        case FuzzyInferenceRules::opOR:
+          for (unsigned j = 0; j < count; j++) a[j] = a[j] > b[j] ? a[j] : b[j];
+          break;
+        case FuzzyInferenceRules::opNAND:
+          for (unsigned j = 0; j < count; j++) a[j] = 1 - (a[j] < b[j] ? a[j] : b[j]);
+          break;
+        case FuzzyInferenceRules::opNOR:
+          for (unsigned j = 0; j < count; j++) a[j] = 1 - (a[j] > b[j] ? a[j] : b[j]);
+          break;
+        default:                // see FOperation::getValue()
+          for (unsigned j = 0; j < count; j++) a[j] = 0;
+          break;
+      }
+    }
+    for ( ; t < targetEnd[r]; t++)
+    {
+      double *o = m + target[t] * B;
+      for (unsigned j = 0; j < count; j++)
+        o[j] = o[j] > s[j] ? o[j] : s[j];
+    }
+  }
+  for (unsigned k = 0; k < nout; k++)
+  {
+    FuzzyOutput *o = rules.out[k];
+    const unsigned c = o->count();
+    const double *row = m + outRow[k] * B;
+    double *res = &y[first * nout + k];
+    if (o->defuzzify == defuzDCOG)
+    {                           // the same as defuzDCOG for all instances
+      const FuzzySet *fs = o->fuzzySet();
+      double sum[BLOCK], sumw[BLOCK];
+      std::fill(sum, sum + count, 0.0);
+      std::fill(sumw, sumw + count, 0.0);
+      for (unsigned t = 0; t < c; t++)
+      {
+        const double ct = fs->center(t);
+        const double *a = row + t * B;
+        for (unsigned j = 0; j < count; j++)
+        {
+          sum[j] += ct * a[j];
+          sumw[j] += a[j];
+        }
+      }
+      for (unsigned j = 0; j < count; j++)
+      {
+        if (sumw[j] <= 0)
+          SIMLIB_error("FuzzyBlockArray: empty output \"%s\" (instance %u)!",
+                       fs->name(), first + j);
+        res[j * nout] = sum[j] / sumw[j];
+      }
+    }
+    else
+    {                           // pattern variable, any method
+      for (unsigned j = 0; j < count; j++)
+      {
+        for (unsigned t = 0; t < c; t++)
+          (*o)[t] = row[t * B + j];
+        res[j * nout] = o->Defuzzify();
+      }
+    }
+  }
+}
+
+} // namespace
+
+// end of fuzzyarray.cc
@@ -23,6 +23,8 @@
 #include <cstdio>
 #include <cassert>
 #include <cmath>
+#include <algorithm>
+#include <vector>
 
 namespace simlib3 {
 
@@ -33,14 +35,11 @@ namespace simlib3 {
 /** Fuzzify all membership functions.<br>Fuzzifikuje vechny funkce pslunosti.*/
 void FuzzyVariable::Fuzzify(double x)
 {
-    // optimize !
-    // use m and count membership of x
   if ((x > m->max()) || (x < m->min()))
   {
     SIMLIB_error("Fuzzification error: value %lf out of range in fuzzy set \"%s\".", x, m->name());
   }
-  for( unsigned i = 0; i < count(); i++ ) 
-  { SetMembership(i,x); }
+  m->Membership(x, mval); // all membership functions at once
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -68,21 +67,24 @@ double i_g_centre(const FuzzyVariable &fs, double lim=0.0)
 // find maximum
 static double find_max(const FuzzyVariable &fs)
 {
+   const double *v = fs.values();
    double value = 0.0;
    for(unsigned i=0; i<fs.count(); i++) 
-      value = max(value, fs[i]);
+      value = max(value, v[i]);
    return value;
 }
 
 // mean-of-maximum 
 double defuzMeanOfMax(const FuzzyVariable &fs)
 {
+   const double *v = fs.values();
+   const FuzzySet *s = fs.fuzzySet();
    int n = 0;
    double up = 0.0;
    double top = find_max(fs); // height = maximum
    for(int i=fs.count()-1; i>=0; i--) {
-      if(fs[i] == top) { // maximum
-         up += fs.center(i);
+      if(v[i] == top) { // maximum
+         up += s->center(i);
          n++;
       }
    }
@@ -93,10 +95,11 @@ double defuzMeanOfMax(const FuzzyVariable &fs)
 // min-of-maximum 
 double defuzMinOfMax(const FuzzyVariable &fs)
 {
+   const double *v = fs.values();
    double top = find_max(fs); // height = maximum
    for(unsigned i=0; i<fs.count(); i++) {
-      if(fs[i] == top) { // first maximum
-         return fs.center(i);
+      if(v[i] == top) { // first maximum
+         return fs.fuzzySet()->center(i);
       }
    }
    assert(0);
@@ -105,10 +108,11 @@ double defuzMinOfMax(const FuzzyVariable &fs)
 // max-of-maximum
 double defuzMaxOfMax(const FuzzyVariable &fs)
 {
+   const double *v = fs.values();
    double top = find_max(fs); // height = maximum
    for(int i=fs.count()-1; i>=0; i--) {
-      if(fs[i] == top) { // last maximum
-         return fs.center(i);
+      if(v[i] == top) { // last maximum
+         return fs.fuzzySet()->center(i);
       }
    }
    assert(0);
@@ -117,16 +121,250 @@ double defuzMaxOfMax(const FuzzyVariable &fs)
 // Defuzzification method "discrete-center-of-gravity".
 double defuzDCOG(const FuzzyVariable &fs)
 {
+    const double *v = fs.values();
+    const FuzzySet *s = fs.fuzzySet();
     double sum=0.0;
     double sumw=0.0;
     for(unsigned i = 0; i < fs.count(); i++) {
-      double weight = fs[i];
-      double x = fs.center(i); // center of membership function
-      sum += x*weight;
-      sumw += weight;
+      sum += s->center(i)*v[i]; // center of membership function
+      sumw += v[i];
     }
     assert(sumw > 0.0);
     return sum/sumw;
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// center of gravity of functions clipped by fuzzy values
+//
+
+// area and first moment of linear function from (x1,y1) to (x2,y2)
+static inline void addLinear(double x1, double y1, double x2, double y2,
+                             double &area, double &moment)
+{
+  double dx = x2 - x1;
+  area += dx * (y1 + y2) / 2;
+  moment += dx * (x1 * (2*y1 + y2) + x2 * (y1 + 2*y2)) / 6;
+}
+
+// the same for part <lo,hi> of segment (x1,y1)-(x2,y2)
+static void addSegment(double x1, double y1, double x2, double y2,
+                       double lo, double hi, double &area, double &moment)
+{
+  if (x2 <= x1 || x2 <= lo || x1 >= hi)
+    return;
+  double k = (y2 - y1) / (x2 - x1);
+  if (x1 < lo) { y1 += k * (lo - x1); x1 = lo; }
+  if (x2 > hi) { y2 -= k * (x2 - hi); x2 = hi; }
+  addLinear(x1, y1, x2, y2, area, moment);
+}
+
+// area and first moment of exp(-(x-c)^2/p) on <l,r>
+static void addGauss(double c, double p, double l, double r,
+                     double &area, double &moment)
+{
+  if (r <= l || p <= 0)
+    return;
+  const double SQRT_PI = 1.7724538509055160273;
+  double sq = sqrt(p);
+  double a = sq * SQRT_PI / 2 * (erf((r - c) / sq) - erf((l - c) / sq));
+  area += a;
+  moment += c * a + p / 2 * (exp(-(l - c) * (l - c) / p) - exp(-(r - c) * (r - c) / p));
+}
+
+// vertices of triangle/trapezoid i clipped at height h
+static void clippedPolygon(const FuzzySet *s, int i, double h, double *px, double *py)
+{
+  const double *p = s->batchParams(i);
+  double a = p[0], b = p[1], c, d;
+  if (s->batchKind(i) == FuzzyMembershipFunction::mfTriangle) { c = p[1]; d = p[2]; }
+  else { c = p[2]; d = p[3]; }
+  if (h > 1) h = 1;
+  px[0] = a;               py[0] = 0;
+  px[1] = a + (b - a) * h; py[1] = h;
+  px[2] = d - (d - c) * h; py[2] = h;
+  px[3] = d;               py[3] = 0;
+}
+
+/**
+ * Center of gravity of maximum of clipped functions from samples of universum.
+ * Inner loops have no branches and can be vectorized by the compiler.
+ */
+double defuzSampledCOG(const FuzzyVariable &fs)
+{
+  static std::vector<double> agg; // aggregated function (no reallocation)
+  const FuzzySet *s = fs.fuzzySet();
+  const double *v = fs.values();
+  const unsigned N = s->resolution();
+  const double *mu = s->samples();
+  agg.assign(N, 0.0);
+  double *a = &agg[0];
+  for (unsigned i = 0; i < fs.count(); i++)
+  {
+    const double h = v[i];
+    if (h <= 0) continue;
+    const double *row = mu + i * N;
+    for (unsigned k = 0; k < N; k++)
+    {
+      double y = row[k] < h ? row[k] : h;
+      a[k] = a[k] < y ? y : a[k];
+    }
+  }
+  double s0 = (a[0] + a[N-1]) / 2;  // trapezoidal rule
+  double s1 = (N-1) * a[N-1] / 2;
+  for (unsigned k = 1; k < N-1; k++)
+  {
+    s0 += a[k];
+    s1 += k * a[k];
+  }
+  if (s0 <= 0) SIMLIB_error("defuzSampledCOG: empty fuzzy set \"%s\"!", s->name());
+  return s->min() + (s->max() - s->min()) / (N-1) * s1 / s0;
+}
+
+/**
+ * Center of gravity of maximum of clipped functions. The maximum of piecewise
+ * linear functions is linear between vertices and intersections of their
+ * segments, so it is integrated exactly. Other types are sampled.
+ */
+double defuzCOG(const FuzzyVariable &fs)
+{
+  const FuzzySet *s = fs.fuzzySet();
+  const double *v = fs.values();
+  const double lo = s->min(), hi = s->max();
+  double px[FuzzySet::MAX][4], py[FuzzySet::MAX][4];
+  unsigned na = 0;
+  for (unsigned i = 0; i < fs.count(); i++)
+  {
+    if (v[i] <= 0) continue;
+    int k = s->batchKind(i);
+    if (k != FuzzyMembershipFunction::mfTriangle && k != FuzzyMembershipFunction::mfTrapez)
+      return defuzSampledCOG(fs);
+    clippedPolygon(s, i, v[i], px[na], py[na]);
+    na++;
+  }
+  // breakpoints: limits, vertices and intersections of segments
+  double bp[2 + 4*FuzzySet::MAX + 9*FuzzySet::MAX*(FuzzySet::MAX-1)/2];
+  unsigned nb = 0;
+  bp[nb++] = lo;
+  bp[nb++] = hi;
+  for (unsigned j = 0; j < na; j++)
+    for (int t = 0; t < 4; t++)
+      if (px[j][t] > lo && px[j][t] < hi) bp[nb++] = px[j][t];
+  for (unsigned j = 0; j < na; j++)
+    for (unsigned l = j + 1; l < na; l++)
+      for (int sj = 0; sj < 3; sj++)
+        for (int sl = 0; sl < 3; sl++)
+        {
+          double x1 = px[j][sj], x2 = px[j][sj+1];
+          double x3 = px[l][sl], x4 = px[l][sl+1];
+          if (x2 <= x1 || x4 <= x3) continue;
+          double k1 = (py[j][sj+1] - py[j][sj]) / (x2 - x1);
+          double k2 = (py[l][sl+1] - py[l][sl]) / (x4 - x3);
+          if (k1 == k2) continue;
+          double x = (py[l][sl] - k2 * x3 - py[j][sj] + k1 * x1) / (k1 - k2);
+          if (x > std::max(x1, x3) && x < std::min(x2, x4) && x > lo && x < hi)
+            bp[nb++] = x;
+        }
+  std::sort(bp, bp + nb);
+  double area = 0, moment = 0;
+  for (unsigned q = 0; q + 1 < nb; q++)
+  {
+    const double xl = bp[q], xr = bp[q+1];
+    if (xr <= xl) continue;
+    const double mid = (xl + xr) / 2;
+    double best = 0, yl = 0, yr = 0;
+    for (unsigned j = 0; j < na; j++)
+      for (int t = 0; t < 3; t++)
+        if (px[j][t] <= mid && mid < px[j][t+1])
+        { // the same segment covers <xl,xr>
+          double k = (py[j][t+1] - py[j][t]) / (px[j][t+1] - px[j][t]);
+          double y = py[j][t] + k * (mid - px[j][t]);
+          if (y > best)
+          {
+            best = y;
+            yl = py[j][t] + k * (xl - px[j][t]);
+            yr = py[j][t] + k * (xr - px[j][t]);
+          }
+          break;
+        }
+    if (best > 0)
+      addLinear(xl, yl, xr, yr, area, moment);
+  }
+  if (area <= 0) SIMLIB_error("defuzCOG: empty fuzzy set \"%s\"!", s->name());
+  return moment / area;
+}
+
+/**
+ * Center of gravity of sum of clipped functions. Triangles, trapezoids
+ * and gaussians are integrated in closed form, other types from samples.
+ * Singletons have zero area.
+ */
+double defuzCOS(const FuzzyVariable &fs)
+{
+  const FuzzySet *s = fs.fuzzySet();
+  const double *v = fs.values();
+  const double lo = s->min(), hi = s->max();
+  double area = 0, moment = 0;
+  for (unsigned i = 0; i < fs.count(); i++)
+  {
+    double h = v[i];
+    if (h <= 0) continue;
+    if (h > 1) h = 1;
+    const double *p = s->batchParams(i);
+    int k = s->batchKind(i);
+    if (k == FuzzyMembershipFunction::mfGauss2 && p[0] > p[2])
+      k = FuzzyMembershipFunction::mfGeneral;     // product of both sides
+    switch (k)
+    {
+      case FuzzyMembershipFunction::mfSingleton:
+        break;
+      case FuzzyMembershipFunction::mfTriangle:
+      case FuzzyMembershipFunction::mfTrapez:
+      {
+        double px[4], py[4];
+        clippedPolygon(s, i, h, px, py);
+        for (int t = 0; t < 3; t++)
+          addSegment(px[t], py[t], px[t+1], py[t+1], lo, hi, area, moment);
+        break;
+      }
+      case FuzzyMembershipFunction::mfGauss:
+      case FuzzyMembershipFunction::mfGauss2:
+      {
+        // left side, top clipped at h, right side
+        double lc = p[0], lp = p[1], rc = p[0], rp = p[1];
+        if (k == FuzzyMembershipFunction::mfGauss2) { rc = p[2]; rp = p[3]; }
+        double l = lc, r = rc;
+        if (h < 1)
+        {
+          if (lp > 0) l -= sqrt(-lp * log(h));
+          if (rp > 0) r += sqrt(-rp * log(h));
+        }
+        addGauss(lc, lp, lo, std::min(l, hi), area, moment);
+        if (std::max(l, lo) < std::min(r, hi))
+          addLinear(std::max(l, lo), h, std::min(r, hi), h, area, moment);
+        addGauss(rc, rp, std::max(r, lo), hi, area, moment);
+        break;
+      }
+      default:
+      {
+        const unsigned N = s->resolution();
+        const double *row = s->samples() + i * N;
+        const double dx = (hi - lo) / (N - 1);
+        double s0 = 0, s1 = 0;
+        for (unsigned t = 0; t < N; t++)
+        {
+          double y = row[t] < h ? row[t] : h;
+          if (t == 0 || t == N-1) y /= 2;
+          s0 += y;
+          s1 += t * y;
+        }
+        area += dx * s0;
+        moment += dx * (lo * s0 + dx * s1);
+        break;
+      }
+    }
+  }
+  if (area <= 0) SIMLIB_error("defuzCOS: empty fuzzy set \"%s\"!", s->name());
+  return moment / area;
+}
+
 } // namespace
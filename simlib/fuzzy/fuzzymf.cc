@@ -77,6 +77,28 @@ FuzzyMembershipFunction::~FuzzyMembershipFunction()
 }
 
 
+/**
+ * Parameters for batch evaluation of membership degrees (see FuzzySet::Membership(x, result)).
+ * General function has no parameters, it is evaluated by Membership().<br>
+ * Parametry pro dvkov vyhodnocen stup pslunosti (viz FuzzySet::Membership(x, result)).
+ * Obecn funkce nem parametry, vyhodnocuje se metodou Membership().
+ * @return Kind of function (mfGeneral).<br>Druh funkce (mfGeneral).
+ */
+int FuzzyMembershipFunction::batchParams(double *) const
+{
+  return mfGeneral;
+}
+
+/**
+ * It returns definition value (see addDefValue). General function has no definition values.<br>
+ * Vrac definin hodnotu (viz addDefValue). Obecn funkce definin hodnoty nem.
+ */
+double FuzzyMembershipFunction::getDefValue(int) const
+{
+  SIMLIB_error("FuzzyMembershipFunction::getDefValue: not implemented for \"%s\"!", Name);
+  return 0;
+}
+
 /** Print of membership table.<br>Tisk tabulky pslunosti. */
 // debugging tool:
 void FuzzyMembershipFunction::Print(double a, double b) const 
@@ -129,6 +151,20 @@ FuzzySingleton *FuzzySingleton::clone() const
   return new FuzzySingleton(*this);
 }
 
+int FuzzySingleton::batchParams(double *p) const
+{
+  p[0] = x0;
+  return mfSingleton;
+}
+
+// definition values, see addDefValue
+double FuzzySingleton::getDefValue(int i) const
+{
+  const double v[1] = { x0 };
+  if (unsigned(i) >= 1) SIMLIB_error("FuzzySingleton::getDefValue: index out of range");
+  return v[i];
+}
+
 /** This adds next definition value.<br>Pid dal definin hodnotu. */
 void FuzzySingleton::addDefValue(double value)
 {
@@ -183,6 +219,20 @@ FuzzyTriangle *FuzzyTriangle::clone() const
   return new FuzzyTriangle(*this);
 }
 
+int FuzzyTriangle::batchParams(double *p) const
+{
+  p[0] = x0; p[1] = x1; p[2] = x2;
+  return mfTriangle;
+}
+
+// definition values, see addDefValue
+double FuzzyTriangle::getDefValue(int i) const
+{
+  const double v[3] = { x0, x1, x2 };
+  if (unsigned(i) >= 3) SIMLIB_error("FuzzyTriangle::getDefValue: index out of range");
+  return v[i];
+}
+
 /** This adds next definition value.<br>Pid dal definin hodnotu. */
 void FuzzyTriangle::addDefValue(double value)
 {
@@ -254,6 +304,20 @@ FuzzyTrapez *FuzzyTrapez::clone() const
   return new FuzzyTrapez(*this);
 }
 
+int FuzzyTrapez::batchParams(double *p) const
+{
+  p[0] = x0; p[1] = x1; p[2] = x2; p[3] = x3;
+  return mfTrapez;
+}
+
+// definition values, see addDefValue
+double FuzzyTrapez::getDefValue(int i) const
+{
+  const double v[4] = { x0, x1, x2, x3 };
+  if (unsigned(i) >= 4) SIMLIB_error("FuzzyTrapez::getDefValue: index out of range");
+  return v[i];
+}
+
 /** This adds next definition value.<br>Pid dal definin hodnotu. */
 void FuzzyTrapez::addDefValue(double value)
 {
@@ -324,6 +388,20 @@ FuzzyGauss *FuzzyGauss::clone() const
   return new FuzzyGauss(*this);
 }
 
+int FuzzyGauss::batchParams(double *p) const
+{
+  p[0] = c; p[1] = twoSqrSigma;
+  return mfGauss;
+}
+
+// definition values, see addDefValue
+double FuzzyGauss::getDefValue(int i) const
+{
+  const double v[2] = { c, 3*sigma };
+  if (unsigned(i) >= 2) SIMLIB_error("FuzzyGauss::getDefValue: index out of range");
+  return v[i];
+}
+
 /** This adds next definition value.<br>Pid dal definin hodnotu. */
 void FuzzyGauss::addDefValue(double value)
 {
@@ -392,6 +470,20 @@ FuzzyGauss2 *FuzzyGauss2::clone() const
   return new FuzzyGauss2(*this);
 }
 
+int FuzzyGauss2::batchParams(double *p) const
+{
+  p[0] = leftCenter; p[1] = twoSqrSigmaL; p[2] = rightCenter; p[3] = twoSqrSigmaR;
+  return mfGauss2;
+}
+
+// definition values, see addDefValue
+double FuzzyGauss2::getDefValue(int i) const
+{
+  const double v[4] = { leftCenter, 3*leftSigma, rightCenter, 3*rightSigma };
+  if (unsigned(i) >= 4) SIMLIB_error("FuzzyGauss2::getDefValue: index out of range");
+  return v[i];
+}
+
 /** It computes function value (membership).<br>Vypote funkn hodnotu (pslunost). */
 double FuzzyGauss2::Membership(double x) const 
 {
@@ -126,7 +126,7 @@ void Rules::addNewRule()
  * @param def Defuzzification function.<br>Defuzzifikan funkce.
  */
 FuzzyOutput::FuzzyOutput(const FuzzySet &t, double (*def)(const FuzzyVariable&)/*=0*/) 
-  : FuzzyVariable(t), defuzzify(def) 
+  : FuzzyVariable(t), defuzzify(def), preset(false) 
 {
   TRACE(printf("FuzzyOutput::FuzzyOutput()\n"));
   // default: zero all
@@ -179,6 +179,16 @@ double FuzzyOutput::Value()
   return value; // return value;
 }
 
+/**
+ * It sets sharp value directly, defuzzification in Done is skipped.<br>
+ * Nastav pmo ostrou hodnotu, defuzzifikace v Done se vynech.
+ */
+void FuzzyOutput::setValue(double v)
+{
+  value = v;
+  preset = true;
+}
+
 FuzzyOutput::~FuzzyOutput() { TRACE(printf("~FuzzyOutput()\n")); } 
 
 /////////////////////////////////////////////////////////////////////////////
@@ -319,7 +329,7 @@ void FuzzyBlock::Evaluate()
   if(lastTime==Time) return; // was already evaluated at this time
   lastTime = Time;
   // for_each
-  dlist<FuzzyVariable*>::iterator i;
+  std::list<FuzzyVariable*>::iterator i;
   for(i=vlist.begin(); i!=vlist.end(); i++)
      (*i)->Init(); // fuzzify input, init output
   Behavior(); // execute rules, aggregate output
@@ -337,17 +347,94 @@ void FuzzyBlock::Evaluate()
  */
 void FuzzySampledBlock::Evaluate()
 {
-  if ((Time - lastTime >= sampler->getTimeStep()) || (Time == 0))
+  if (tolerance <= 0)
   {
-    lastTime = Time;
-    dlist<FuzzyVariable*>::iterator i;
-    for (i = vlist.begin(); i != vlist.end(); i++)
-      (*i)->Init(); // fuzzify input, init output
-    Behavior();
+    if ((Time - lastTime >= sampler->getTimeStep()) || (Time == 0))
+    {
+      lastTime = Time;
+      EvaluateRules();
+    }
+    return;
+  }
+  // change-driven evaluation
+  if (lastTime == Time && !invalid) return;
+  lastTime = Time;
+  std::vector<long> c;
+  c.reserve(cell.size());
+  std::list<FuzzyVariable*>::iterator i;
+  for (i = vlist.begin(); i != vlist.end(); i++)
+  {
+    FuzzyInput *in = dynamic_cast<FuzzyInput *>(*i);
+    if (in == 0) continue;
+    double width = (in->getMax() - in->getMin()) * tolerance;
+    c.push_back(long(floor((in->Value() - in->getMin()) / width)));
+  }
+  if (!invalid && evaluations + hits > 0 && c == cell) 
+    return;     // all inputs in the same cell, outputs are valid
+  invalid = false;
+  cell.swap(c);
+  if (cacheSize > 0)
+  {
+    std::map<std::vector<long>, std::vector<double> >::const_iterator f = cache.find(cell);
+    if (f != cache.end())
+    {
+      unsigned k = 0;
+      for (i = vlist.begin(); i != vlist.end(); i++)
+      {
+        FuzzyOutput *out = dynamic_cast<FuzzyOutput *>(*i);
+        if (out != 0) out->value = f->second[k++];
+      }
+      hits++;
+      return;
+    }
+  }
+  EvaluateRules();
+  if (cacheSize > 0)
+  {
+    if (cache.size() >= cacheSize) cache.clear();
+    std::vector<double> &v = cache[cell];
     for (i = vlist.begin(); i != vlist.end(); i++)
-      (*i)->Done(); // defuzzify outputs
+    {
+      FuzzyOutput *out = dynamic_cast<FuzzyOutput *>(*i);
+      if (out != 0) v.push_back(out->value);
+    }
   }
 }
 
+/** It evaluates rules and defuzzifies outputs.<br>Vyhodnot pravidla a defuzzifikuje vstupy. */
+void FuzzySampledBlock::EvaluateRules()
+{
+  evaluations++;
+  std::list<FuzzyVariable*>::iterator i;
+  for (i = vlist.begin(); i != vlist.end(); i++)
+    (*i)->Init(); // fuzzify input, init output
+  Behavior();
+  for (i = vlist.begin(); i != vlist.end(); i++)
+    (*i)->Done(); // defuzzify outputs
+}
+
+/**
+ * It switches to change-driven evaluation (0 = sampling by time step).<br>
+ * Pepne na vyhodnocen zen zmnou (0 = vzorkovn podle asovho kroku).
+ */
+void FuzzySampledBlock::setTolerance(double tolerance)
+{
+  if (tolerance < 0 || tolerance > 1)
+    SIMLIB_error("FuzzySampledBlock::setTolerance: tolerance must be in range 0..1!");
+  this->tolerance = tolerance;
+  cell.clear();
+  Invalidate();
+}
+
+/**
+ * It sets maximal number of cached input cells (0 = no cache).<br>
+ * Nastav maximln poet uloench bunk vstup (0 = bez cache).
+ */
+void FuzzySampledBlock::setCacheSize(unsigned cells)
+{
+  cacheSize = cells;
+  cache.clear();
+}
+
 } // namespace 
 
@@ -20,7 +20,11 @@
 #include "fuzzy.h"
 #include <internal.h>
 #include <stdio.h>
+#include <time.h>
 #include <typeinfo>
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
 
 namespace simlib3 {
 
@@ -33,6 +37,11 @@ FuzzyRuleFactory * FuzzyInferenceRules::createRuleFactory()
   return new FuzzyRuleFactory(this);
 }
 
+/* pomocn funkce */
+inline double rmin(double x, double y) { return (x < y) ? x : y; }
+inline double rmax(double x, double y) { return (x > y) ? x : y; }
+inline unsigned rmin(unsigned x, unsigned y) { return (x < y) ? x : y; }
+
 /////////////////////////////////////////////////////////////////////////////////////////
 // FuzzyIIORules
 /////////////////////////////////////////////////////////////////////////////////////////
@@ -122,6 +131,8 @@ void FuzzyIIORules::init()
   out.reserve(1);
   in.reserve(2);
   inputs = outputs = rules = 0;
+  tableN1 = tableN2 = 0;
+  table1 = tableStep1 = table2 = tableStep2 = 0;
 }
 
 
@@ -190,7 +201,8 @@ void FuzzyIIORules::add (const FuzzyInferenceRules::Operations operation,
 {
 //  if (rules >= in[2]->count*in[1]->count()) // chyba
   rules++;
-  unsigned index = in2WVIndex*in[1]->count()+in1WVIndex;
+  table.clear();  // control surface changed
+  unsigned index = in2WVIndex*in[0]->count()+in1WVIndex;   // see evaluate()
   this->operation[index] = operation;
   this->outWV[index] = outWVIndex;
 //  printf("add (in1WVIndex=%d, in2WVIndex=%d, outWVIndex=%d) at index %d\n", in1WVIndex, in2WVIndex, outWVIndex, index);
@@ -228,16 +240,28 @@ void FuzzyIIORules::add (const FuzzyInferenceRules::Operations operation,
   add(operation, in1WVIndex, in2WVIndex, out[0]->search(outWordValue));
 }
 
-/* pomocn funkce */
-inline double rmin(double x, double y) { return (x < y) ? x : y; }
-inline double rmax(double x, double y) { return (x > y) ? x : y; }
-
 /**
  * It evaluates the rules.<br>
  * Vyhodnot pravidla.
  */
 void FuzzyIIORules::evaluate()
 {
+  if (!table.empty())
+  {
+    // bilinear interpolation in lookup table
+    double u = (in[0]->Value() - table1) / tableStep1;
+    double v = (in[1]->Value() - table2) / tableStep2;
+    u = rmax(0.0, rmin(u, double(tableN1 - 1)));
+    v = rmax(0.0, rmin(v, double(tableN2 - 1)));
+    unsigned i = rmin(unsigned(u), tableN1 - 2);
+    unsigned j = rmin(unsigned(v), tableN2 - 2);
+    u -= i;
+    v -= j;
+    const double *t = &table[j*tableN1 + i];
+    out[0]->setValue((1-v)*((1-u)*t[0] + u*t[1]) + 
+                     v*((1-u)*t[tableN1] + u*t[tableN1+1]));
+    return;
+  }
 //  if (rules >= in[2]->count*in[1]->count()) // chyba
   for (int i = 0; i < rules; i++)
   {
@@ -267,6 +291,43 @@ void FuzzyIIORules::evaluate()
     }
   }
 }
+
+/**
+ * It precomputes control surface into lookup table. Values in grid points are computed 
+ * by inference and defuzzification method of output variable.<br>
+ * Pedpot dic plochu do tabulky. Hodnoty v uzlech mky se potaj inferenc
+ * a defuzzifikan metodou vstupn promnn.
+ */
+void FuzzyIIORules::createLookupTable(unsigned n1, unsigned n2)
+{
+  if (!isComplete())
+    SIMLIB_error("FuzzyIIORules::createLookupTable: fuzzy variables are not complete!");
+  if (n1 < 2 || n2 < 2)
+    SIMLIB_error("FuzzyIIORules::createLookupTable: bad size of table!");
+  table.clear();   // evaluate uses inference
+  table1 = in[0]->getMin();
+  table2 = in[1]->getMin();
+  tableStep1 = (in[0]->getMax() - table1) / (n1 - 1);
+  tableStep2 = (in[1]->getMax() - table2) / (n2 - 1);
+  std::vector<double> t(n1*n2);
+  for (unsigned j = 0; j < n2; j++)
+  {
+    double y = (j == n2-1) ? in[1]->getMax() : table2 + j*tableStep2;
+    for (unsigned i = 0; i < n1; i++)
+    {
+      double x = (i == n1-1) ? in[0]->getMax() : table1 + i*tableStep1;
+      in[0]->Fuzzify(x);
+      in[1]->Fuzzify(y);
+      out[0]->Init();
+      evaluate();
+      t[j*n1 + i] = out[0]->Defuzzify();
+    }
+  }
+  tableN1 = n1;
+  tableN2 = n2;
+  table.swap(t);
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////
 // FuzzyGeneralRules
 /////////////////////////////////////////////////////////////////////////////////////////
@@ -281,17 +342,110 @@ bool FuzzyGeneralRules::isComplete()
   return (in.size() > 0) && (out.size() > 0);
 }
 
+/**
+ * It destroys vector of rules. Rules added with release are released.<br>
+ * Zru vektor pravidel. Pravidla vloen s release jsou uvolnna.
+ */
+FuzzyGeneralRules::~FuzzyGeneralRules()
+{
+  TRACE(printf("~FuzzyGeneralRules\n"));
+  for (unsigned r = 0; r < rules.size(); r++)
+    if (owned[r]) delete rules[r];
+  rules.erase(rules.begin(), rules.end());
+}
+
 /**
  * It adds next rule into list. When it is too much rules here, error is indicated.<br>
  * 
  * Pid dal pravidlo do seznamu. Pokud u je definovno pli pravidel, nastane chyba.
  * @param rule Inference rule who is represented by tree structure.
  *             Inferenn pravidlo reprezentovan stromovou strukturou.
- * @param release It has no meaning here.<br>Zde nem vznam.
+ * @param release Rule will be released by this object (destructor or prune).<br>
+ *                Pravidlo uvoln tento objekt (destruktor nebo prune).
  */
 void FuzzyGeneralRules::add(FuzzyRule *rule, bool release/*=true*/)
 {
   rules.push_back(rule);
+  owned.push_back(release);
+  compiled = false;
+  version++;
+}
+
+/** Instruction: push membership value.<br>Instrukce: ulo hodnotu pslunosti. */
+static const int opLOAD = -1;
+
+/** Clock for profiling [s].<br>Hodiny pro profilovn [s]. */
+static double profileClock()
+{
+#if defined(_POSIX_TIMERS) && _POSIX_TIMERS > 0
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + 1e-9 * t.tv_nsec;
+#else
+  return double(clock()) / CLOCKS_PER_SEC;
+#endif
+}
+
+/**
+ * It translates tree of condition into postfix code.<br>
+ * Pelo strom podmnky do postfixovho kdu.
+ */
+void FuzzyGeneralRules::compile(FONode *node, unsigned &depth, unsigned &maxdepth)
+{
+  Instruction i;
+  FPair *pair = dynamic_cast<FPair *>(node);
+  if (pair != NULL)
+  {
+    i.op = opLOAD;              // the same value as FPair::getValue()
+    i.arg = &(*pair->var)[pair->indexWV];
+    code.push_back(i);
+    if (++depth > maxdepth) maxdepth = depth;
+    return;
+  }
+  FOperation *operation = dynamic_cast<FOperation *>(node);
+  if (operation == NULL || operation->L == NULL || 
+      (operation->R == NULL && operation->op != opNOT))
+    SIMLIB_error("FuzzyGeneralRules::compile: Tree in rule has bad structure!");
+  compile(operation->L, depth, maxdepth);
+  if (operation->op != opNOT)
+  {
+    compile(operation->R, depth, maxdepth);
+    depth--;
+  }
+  i.op = operation->op;
+  i.arg = NULL;
+  code.push_back(i);
+}
+
+/**
+ * It translates all rules into one program. Each rule is a sequence of instructions
+ * which leaves the value of condition on the stack.<br>
+ * Pelo vechna pravidla do jednoho programu. Kad pravidlo je posloupnost instrukc,
+ * kter ponech hodnotu podmnky na zsobnku.
+ */
+void FuzzyGeneralRules::compile()
+{
+  code.clear();
+  codeEnd.clear();
+  target.clear();
+  targetEnd.clear();
+  unsigned maxdepth = 1;
+  for (unsigned r = 0; r < rules.size(); r++)
+  {
+    if (rules[r]->left == NULL)
+      SIMLIB_error("FuzzyGeneralRules::compile: rule without condition!");
+    unsigned depth = 0;
+    compile(rules[r]->left, depth, maxdepth);
+    codeEnd.push_back(code.size());
+    for (unsigned k = 0; k < rules[r]->right.size(); k++)
+    {
+      FPair *c = rules[r]->right[k];
+      target.push_back(&(*c->var)[c->indexWV]);
+    }
+    targetEnd.push_back(target.size());
+  }
+  stack.resize(maxdepth);
+  compiled = true;
 }
 
 /**
@@ -302,10 +456,146 @@ void FuzzyGeneralRules::add(FuzzyRule *rule, bool release/*=true*/)
  */
 void FuzzyGeneralRules::evaluate()
 {
-  for (unsigned int i = 0; i < rules.size(); i++)
+  if (!compiled) compile();
+  if (profile && fired.size() != rules.size()) clearProfile();   // rules added
+  double start = profile ? profileClock() : 0;
+  double *s = &stack[0];
+  unsigned pc = 0, t = 0;
+  for (unsigned r = 0; r < codeEnd.size(); r++)
+  {
+    unsigned sp = 0;            // empty stack
+    for ( ; pc < codeEnd[r]; pc++)
+    {
+      const Instruction &i = code[pc];
+      switch (i.op)
+      {
+        case opLOAD: s[sp++] = *i.arg; break;
+        case opAND:  sp--; s[sp-1] = rmin(s[sp-1], s[sp]); break;
+        case opOR:   sp--; s[sp-1] = rmax(s[sp-1], s[sp]); break;
+        case opNAND: sp--; s[sp-1] = 1 - rmin(s[sp-1], s[sp]); break;
+        case opNOR:  sp--; s[sp-1] = 1 - rmax(s[sp-1], s[sp]); break;
+        case opNOT:  s[sp-1] = 1 - s[sp-1]; break;
+        default:     sp--; s[sp-1] = 0; break;  // see FOperation::getValue()
+      }
+    }
+    double alpha = s[0];        // Mamdani: max of min
+    for ( ; t < targetEnd[r]; t++)
+      *target[t] = rmax(*target[t], alpha);
+    if (profile)
+    {
+      if (alpha > 0) fired[r]++;
+      strength[r] += alpha;
+      maxStrength[r] = rmax(maxStrength[r], alpha);
+    }
+  }
+  if (profile)
+  {
+    evaluations++;
+    evalTime += profileClock() - start;
+  }
+}
+
+/** It switches profiling on/off.<br>Zapne/vypne profilovn. */
+void FuzzyGeneralRules::setProfiling(bool on)
+{
+  profile = on;
+  if (fired.size() != rules.size()) clearProfile();
+}
+
+/** It clears profile.<br>Vynuluje profil. */
+void FuzzyGeneralRules::clearProfile()
+{
+  evaluations = 0;
+  evalTime = 0;
+  fired.assign(rules.size(), 0);
+  strength.assign(rules.size(), 0.0);
+  maxStrength.assign(rules.size(), 0.0);
+}
+
+/** It prints profile.<br>Vytiskne profil. */
+void FuzzyGeneralRules::printProfile()
+{
+  Print("+----------------------------------------------------------+\n");
+  Print("| Fuzzy rules profile                                      |\n");
+  Print("+----------------------------------------------------------+\n");
+  Print("|  evaluations = %-10lu  mean time = %-12g [s] |\n", 
+        evaluations, evaluations ? evalTime / evaluations : 0.0);
+  Print("+----------------------------------------------------------+\n");
+  Print("| rule  activations   mean strength  max strength  output\n");
+  for (unsigned r = 0; r < rules.size(); r++)
+  {
+    Print("| %4u  %11lu  %14.6f  %12.6f ", r, getRuleActivations(r), 
+          getRuleStrength(r), getRuleMaxStrength(r));
+    for (unsigned k = 0; k < rules[r]->right.size(); k++)
+    {
+      FPair *c = rules[r]->right[k];
+      Print(" %s=%s", c->var->fuzzySet()->name(), c->var->wordValue(c->indexWV));
+    }
+    Print("\n");
+  }
+  for (unsigned v = 0; v < in.size() + out.size(); v++)
   {
-    (*rules[i]).evaluate();
+    FuzzyVariable *var = (v < in.size()) ? (FuzzyVariable *)in[v] : out[v - in.size()];
+    for (unsigned i = 0; i < var->count(); i++)
+      if (!isUsed(var, i))
+        Print("| unused word value %s=%s\n", var->fuzzySet()->name(), var->wordValue(i));
   }
+  Print("+----------------------------------------------------------+\n");
+}
+
+/**
+ * It removes rules which never reach strength above threshold on recorded input trace.<br>
+ * Odstran pravidla, jejich sla nikdy nepekro prh na zaznamenanm prbhu vstup.
+ */
+unsigned FuzzyGeneralRules::prune(const std::vector<double> &trace, double threshold)
+{
+  const unsigned n = in.size();
+  if (n == 0 || trace.size() % n != 0)
+    SIMLIB_error("FuzzyGeneralRules::prune: trace must contain rows of all inputs!");
+  bool on = profile;
+  profile = true;
+  clearProfile();
+  for (unsigned row = 0; row < trace.size(); row += n)
+  {
+    for (unsigned k = 0; k < n; k++)
+      in[k]->Fuzzify(trace[row + k]);
+    for (unsigned k = 0; k < out.size(); k++)
+      out[k]->Init();
+    evaluate();
+  }
+  unsigned removed = 0, j = 0;
+  for (unsigned r = 0; r < rules.size(); r++)
+  {
+    if (maxStrength[r] > threshold)
+    {
+      owned[j] = owned[r];
+      rules[j++] = rules[r];
+    }
+    else
+    {
+      if (owned[r]) delete rules[r];  // else only detached
+      removed++;
+    }
+  }
+  rules.resize(j);
+  owned.resize(j);
+  compiled = false;
+  version++;
+  clearProfile();
+  profile = on;
+  return removed;
+}
+
+/** It returns true if some rule uses i-th word value of variable.<br>Vrac true, kdy nkter pravidlo pouv i-tou slovn hodnotu promnn. */
+bool FuzzyGeneralRules::isUsed(const FuzzyVariable *var, unsigned i)
+{
+  if (!compiled) compile();
+  const double *value = &(*var)[i];
+  for (unsigned pc = 0; pc < code.size(); pc++)
+    if (code[pc].op == opLOAD && code[pc].arg == value) return true;
+  for (unsigned t = 0; t < target.size(); t++)
+    if (target[t] == value) return true;
+  return false;
 }
 
 } // namespace
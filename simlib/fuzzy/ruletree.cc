@@ -152,7 +152,7 @@ void del(FPair *p) { delete p; }
  */
 FuzzyRule::~FuzzyRule()
 {
-  if (left != NULL)
+  if (left != NULL) delete left;   // condition tree
   for_each(right.begin(), right.end(), del);
   right.erase(right.begin(), right.end());
   TRACE(printf("~FuzzyRule\n")); 
@@ -0,0 +1,166 @@
+// fuzzy-array-test.cc
+//
+// this tests FuzzyBlockArray of SIMLIB/C++ fuzzy module
+// N instances of controller with shared rules are compared with
+// N separate evaluations of the rules (the same inputs)
+// 1) DCOG output (vectorized defuzzification)
+// 2) COG output (pattern variable, any defuzzification method)
+// 3) continuous inputs and output block FuzzyBlockArray::Out
+// 4) rules pruned after creation of array (array is translated again)
+//
+
+#include "simlib.h"
+#include "fuzzy.h"
+#include <cmath>
+#include <ctime>
+#include <vector>
+
+using namespace simlib3;
+
+const unsigned N = 1000;                // number of instances
+const double tolerance = 1e-12;
+
+// 9 rules: AND of inputs, some with OR/NOT/NOR subtrees
+void AddRules(FuzzyGeneralRules &g, FuzzyInput &a, FuzzyInput &b,
+              FuzzyOutput &o) {
+  const char *w[3] = { "neg", "zero", "pos" };
+  FuzzyRuleFactory *f = g.createRuleFactory();
+  for(int i=0; i<3; i++)
+    for(int j=0; j<3; j++) {
+      FONode *c = f->createNode(f->createNode(&a, w[i]), f->createNode(&b, w[j]),
+                                FuzzyInferenceRules::opAND);
+      if(i==1)
+        c = f->createNode(c, f->createNode(f->createNode(&b, "zero"),
+                                           FuzzyInferenceRules::opNOT),
+                          FuzzyInferenceRules::opOR);
+      if(j==2)
+        c = f->createNode(c, f->createNode(&a, "pos"), FuzzyInferenceRules::opNOR);
+      f->addCondition((FOperation*)c);
+      f->addConsequent(f->createNode(&o, w[2-(i+j)/2]));
+      g.add(f->createRule());
+    }
+  delete f;
+}
+
+// inputs of instance i
+double InputA(unsigned i) { return -10 + 20.0*((i*37)%N)/(N-1); }
+double InputB(unsigned i) { return -10 + 20.0*((i*53)%N)/(N-1); }
+
+double seconds(clock_t t0, clock_t t1) { return double(t1-t0)/CLOCKS_PER_SEC; }
+
+int main()
+{
+  SetOutput("fuzzy-array-test.out");
+  Print("# FuzzyBlockArray: %u instances vs separate evaluations\n", N);
+  int errors = 0;
+  FuzzySet s1("e", -10, 10, FuzzyTrapez("neg", -10, -10, -5, 0),
+              FuzzyTriangle("zero", -5, 0, 5), FuzzyTrapez("pos", 0, 5, 10, 10));
+  FuzzySet s2("de", -10, 10, FuzzyGauss("neg", -10, 10), FuzzyGauss("zero", 0, 6),
+              FuzzyGauss2("pos", 8, 9, 10, 1));
+  FuzzySet so("u", -1, 1, FuzzyTriangle("neg", -1, -0.5, 0),
+              FuzzyTriangle("zero", -0.5, 0, 0.5), FuzzyTriangle("pos", 0, 0.5, 1));
+  FuzzyInput a(s1), b(s2);
+  FuzzyOutput o(so, defuzDCOG);
+  FuzzyGeneralRules g;
+  g.addFuzzyInput(&a);
+  g.addFuzzyInput(&b);
+  g.addFuzzyOutput(&o);
+  AddRules(g, a, b, o);
+
+  // 1), 2) array vs separate evaluations
+  static double ref[N];
+  const char *method[2] = { "DCOG", "COG" };
+  for(int m=0; m<2; m++) {
+    o.SetDefuzzifyMethod(m == 0 ? defuzDCOG : defuzCOG);
+    FuzzyBlockArray array(g, N);
+    for(unsigned i=0; i<N; i++) {
+      array.input(i, 0) = InputA(i);
+      array.input(i, 1) = InputB(i);
+    }
+    const int R = m == 0 ? 200 : 20;    // repetitions
+    clock_t t0 = clock();
+    for(int r=0; r<R; r++)
+      array.EvaluateAll();
+    clock_t t1 = clock();
+    for(int r=0; r<R; r++)
+      for(unsigned i=0; i<N; i++) {
+        a.Fuzzify(InputA(i));
+        b.Fuzzify(InputB(i));
+        o.Init();
+        g.evaluate();
+        ref[i] = o.Defuzzify();
+      }
+    clock_t t2 = clock();
+    double maxd = 0;
+    for(unsigned i=0; i<N; i++)
+      maxd = fmax(maxd, fabs(array.output(i) - ref[i]));
+    Print("# %s: max |array-separate| = %.2g (tolerance %g): %s\n", method[m],
+          maxd, tolerance, maxd < tolerance ? "OK" : "FAILED");
+    Print("# time %d x %u evaluations: array %.3f s, separate %.3f s\n",
+          R, N, seconds(t0, t1), seconds(t1, t2));
+    errors += maxd >= tolerance;
+  }
+
+  // 3) continuous inputs, output block of one instance
+  {
+    o.SetDefuzzifyMethod(defuzDCOG);
+    const unsigned n = 3;
+    Variable x[n], y[n];
+    FuzzyBlockArray array(g, n);
+    for(unsigned i=0; i<n; i++) {
+      array.setInput(i, 0, x[i]);
+      array.setInput(i, 1, y[i]);
+      x[i] = InputA(i);
+      y[i] = InputB(i);
+    }
+    FuzzyBlockArray::Out out(array, n-1);
+    double v = out.Value();
+    a.Fuzzify(InputA(n-1));
+    b.Fuzzify(InputB(n-1));
+    o.Init();
+    g.evaluate();
+    double d = fabs(v - o.Defuzzify());
+    Print("# continuous inputs: |Out-separate| = %.2g: %s\n",
+          d, d < tolerance ? "OK" : "FAILED");
+    errors += d >= tolerance;
+  }
+
+  // 4) rules changed after creation of array
+  {
+    o.SetDefuzzifyMethod(defuzDCOG);
+    FuzzyGeneralRules g2;
+    g2.addFuzzyInput(&a);
+    g2.addFuzzyInput(&b);
+    g2.addFuzzyOutput(&o);
+    AddRules(g2, a, b, o);
+    FuzzyBlockArray array(g2, N);
+    for(unsigned i=0; i<N; i++) {
+      array.input(i, 0) = InputA(i);
+      array.input(i, 1) = InputB(i);
+    }
+    array.EvaluateAll();
+    std::vector<double> before(N), trace;
+    for(unsigned i=0; i<N; i++)
+      before[i] = array.output(i);
+    for(int k=0; k<100; k++) {          // e positive: rules with e=neg removed
+      trace.push_back(5 + 5*sin(0.1*k));
+      trace.push_back(10*cos(0.07*k));
+    }
+    unsigned removed = g2.prune(trace);
+    array.EvaluateAll();
+    double maxd = 0, changed = 0;
+    for(unsigned i=0; i<N; i++) {
+      a.Fuzzify(InputA(i));
+      b.Fuzzify(InputB(i));
+      o.Init();
+      g2.evaluate();
+      maxd = fmax(maxd, fabs(array.output(i) - o.Defuzzify()));
+      changed = fmax(changed, fabs(array.output(i) - before[i]));
+    }
+    bool ok = removed > 0 && changed > 0 && maxd < tolerance;
+    Print("# %u rules pruned: max |array-separate| = %.2g, max change %.2g: %s\n",
+          removed, maxd, changed, ok ? "OK" : "FAILED");
+    errors += !ok;
+  }
+  return errors ? 1 : 0;
+}
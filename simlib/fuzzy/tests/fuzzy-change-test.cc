@@ -0,0 +1,91 @@
+// fuzzy-change-test.cc
+//
+// this tests change-driven evaluation of FuzzySampledBlock of SIMLIB/C++
+// inputs of controller are given by oscillator (periodic trajectory),
+// output is integrated, the same simulation is run with
+// 1) evaluation at each request (reference)
+// 2) change-driven evaluation (tolerance)
+// 3) change-driven evaluation with cache of input cells
+// 4) sampling by time step (last: sampler is deleted with calendar)
+// number of evaluations of rules and deviation from reference are printed
+//
+
+#include "simlib.h"
+#include "fuzzy.h"
+#include <cmath>
+
+using namespace simlib3;
+
+const double TEnd = 20;                 // simulation time
+const double step = 0.01;               // time step of sampling
+const double tolerance = 0.005;         // relative size of input cell
+const double max_error = 0.02;          // max |s-reference|
+
+// oscillator: amplitude 9, period 2*pi
+struct Oscillator {
+  Integrator x1, x2;
+  Oscillator(): x1(x2, 9), x2(-x1, 0) {}
+} osc;
+Integrator &x1 = osc.x1;
+Integrator &x2 = osc.x2;
+
+FuzzySet s1("e", -10, 10, FuzzyTrapez("neg", -10, -10, -5, 0),
+            FuzzyTriangle("zero", -5, 0, 5), FuzzyTrapez("pos", 0, 5, 10, 10));
+FuzzySet s2("de", -10, 10, FuzzyGauss("neg", -10, 10), FuzzyGauss("zero", 0, 6),
+            FuzzyGauss2("pos", 8, 9, 10, 1));
+FuzzySet so("u", -1, 1, FuzzyTriangle("neg", -1, -0.5, 0),
+            FuzzyTriangle("zero", -0.5, 0, 0.5), FuzzyTriangle("pos", 0, 0.5, 1));
+FuzzyInput a(x1, s1), b(x2, s2);
+FuzzyOutput o(so, defuzDCOG);
+FuzzyIIORules r(&a, &b, &o);
+FuzzyRSBlock block(r);
+
+Integrator s(o, 0);                     // integral of controller output
+
+unsigned long evaluations;              // evaluations of rules in last run
+
+// simulation run, returns s(TEnd)
+double Simulate(const char *mode, double timestep, double tol, unsigned cache,
+                double reference)
+{
+  unsigned long e0 = block.getEvaluations(), h0 = block.getCacheHits();
+  block.setTimeStep(timestep);
+  block.setTolerance(tol);
+  block.setCacheSize(cache);
+  Init(0, TEnd);
+  block.Start();
+  Run();
+  double d = fabs(s.Value() - reference);
+  evaluations = block.getEvaluations() - e0;
+  Print("# %-22s evaluations %7lu, cache hits %6lu, s(T) = %.6f, "
+        "|s-reference| = %.2g\n", mode, evaluations,
+        block.getCacheHits() - h0, s.Value(), reference < 0 ? 0 : d);
+  return s.Value();
+}
+
+int main()
+{
+  SetOutput("fuzzy-change-test.out");
+  Print("# change-driven evaluation of fuzzy block\n");
+  const char *w[3] = { "neg", "zero", "pos" };
+  for(int i=0; i<3; i++)
+    for(int j=0; j<3; j++)
+      r.add(FuzzyInferenceRules::opAND, w[i], w[j], w[2-(i+j)/2]);
+  block.EndConstructor();
+  a.registerOwner(&block);
+  b.registerOwner(&block);
+  o.registerOwner(&block);
+  SetStep(1e-3, step);
+  SetAccuracy(1e-3);            // output of controller is piecewise constant
+  double ref = Simulate("each request", 0, 0, 0, -1);
+  double tc = Simulate("tolerance", 0, tolerance, 0, ref);
+  unsigned long etc = evaluations;
+  double tcc = Simulate("tolerance and cache", 0, tolerance, 10000, ref);
+  bool ok = evaluations < etc;
+  double ts = Simulate("time step", step, 0, 0, ref);
+  ok = ok && fabs(ts - ref) < max_error && fabs(tc - ref) < max_error &&
+       fabs(tcc - ref) < max_error;
+  Print("# max |s-reference| < %g, fewer evaluations with cache: %s\n",
+        max_error, ok ? "OK" : "FAILED");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+// fuzzy-defuz-test.cc
+//
+// this tests centroid defuzzification of SIMLIB/C++ fuzzy module
+// closed-form defuzCOG (max aggregation) and defuzCOS (sum aggregation)
+// are compared with numeric integration of clipped membership functions,
+// defuzSampledCOG (101 samples) is shown for comparison
+// piecewise linear (triangle, trapezoid) and Gaussian output sets,
+// COG of Gaussian sets has no closed form (sampled, shown only)
+//
+
+#include "simlib.h"
+#include "fuzzy.h"
+#include <cmath>
+#include <ctime>
+
+using namespace simlib3;
+
+const double tolerance = 1e-6;  // closed form vs numeric integration
+
+// numeric integration (midpoint rule, n intervals) of clipped functions
+// aggregated by max (sum=false) or sum (sum=true)
+double NumericCOG(const FuzzyVariable &v, bool sum, int n = 200000)
+{
+  const FuzzySet *s = v.fuzzySet();
+  const double lo = s->min(), hi = s->max(), dx = (hi - lo) / n;
+  double area = 0, moment = 0;
+  for(int k=0; k<n; k++) {
+    double x = lo + (k + 0.5) * dx, y = 0;
+    for(int i=0; i<s->count(); i++) {
+      double m = fmin(v[i], (*s)[i]->Membership(x));
+      y = sum ? y + m : fmax(y, m);
+    }
+    area += y;
+    moment += x * y;
+  }
+  return moment / area;
+}
+
+// pseudorandom activation of word values (some of them zero)
+unsigned seed = 1;
+void Activate(FuzzyOutput &o)
+{
+  for(unsigned i=0; i<o.count(); i++) {
+    seed = seed * 1103515245 + 12345;
+    o[i] = (seed >> 16) % 3 == 0 ? 0 : ((seed >> 8) % 1000) / 999.0;
+  }
+  o[1] += 0.01;                 // nonempty output
+}
+
+double seconds(clock_t t0, clock_t t1) { return double(t1-t0)/CLOCKS_PER_SEC; }
+
+int main()
+{
+  SetOutput("fuzzy-defuz-test.out");
+  Print("# centroid defuzzification: closed form vs numeric integration\n");
+  FuzzySet lin("u", -1, 1, FuzzyTrapez("nb", -1, -1, -0.7, -0.4),
+               FuzzyTriangle("neg", -0.8, -0.4, 0), FuzzyTriangle("zero", -0.4, 0, 0.4),
+               FuzzyTriangle("pos", 0, 0.4, 0.8), FuzzyTrapez("pb", 0.4, 0.7, 1, 1));
+  FuzzySet gauss("g", -1, 1, FuzzyGauss("neg", -0.5, 0.6), FuzzyGauss("zero", 0, 0.5),
+                 FuzzyGauss2("pos", 0.3, 0.4, 0.8, 0.5), FuzzyGauss2("pb", 0.6, 0.3, 0.8, 0.2));
+  FuzzyOutput a(lin), b(gauss);
+  double cog_lin = 0, cos_lin = 0, cos_gauss = 0, sampled_lin = 0, cog_gauss = 0;
+  for(int t=0; t<50; t++) {
+    Activate(a);
+    Activate(b);
+    cog_lin = fmax(cog_lin, fabs(defuzCOG(a) - NumericCOG(a, false)));
+    cos_lin = fmax(cos_lin, fabs(defuzCOS(a) - NumericCOG(a, true)));
+    sampled_lin = fmax(sampled_lin, fabs(defuzSampledCOG(a) - NumericCOG(a, false)));
+    cos_gauss = fmax(cos_gauss, fabs(defuzCOS(b) - NumericCOG(b, true)));
+    cog_gauss = fmax(cog_gauss, fabs(defuzCOG(b) - NumericCOG(b, false)));
+  }
+  Print("# max |closed form-numeric|, 50 random activations:\n");
+  Print("#   COG piecewise linear %.2g\n", cog_lin);
+  Print("#   COS piecewise linear %.2g\n", cos_lin);
+  Print("#   COS Gaussian         %.2g\n", cos_gauss);
+  Print("#   COG Gaussian         %.2g (sampled, no closed form)\n", cog_gauss);
+  Print("#   sampled COG (101 samples) piecewise linear %.2g\n", sampled_lin);
+  bool ok = cog_lin < tolerance && cos_lin < tolerance && cos_gauss < tolerance;
+  Print("# closed form (tolerance %g): %s\n", tolerance, ok ? "OK" : "FAILED");
+  const int R = 300000;
+  double sum = 0;
+  clock_t t0 = clock();
+  for(int k=0; k<R; k++) { a[k%5] = (k%7)/6.0 + 0.01; sum += defuzCOG(a); }
+  clock_t t1 = clock();
+  for(int k=0; k<R; k++) { a[k%5] = (k%7)/6.0 + 0.01; sum += defuzSampledCOG(a); }
+  clock_t t2 = clock();
+  for(int k=0; k<R; k++) { b[k%4] = (k%7)/6.0 + 0.01; sum += defuzCOS(b); }
+  clock_t t3 = clock();
+  for(int k=0; k<R; k++) { a[k%5] = (k%7)/6.0 + 0.01; sum += defuzDCOG(a); }
+  clock_t t4 = clock();
+  Print("# time %d defuzzifications: COG %.3f s, sampled COG %.3f s, "
+        "COS Gaussian %.3f s, DCOG %.3f s (%g)\n", R, seconds(t0, t1),
+        seconds(t1, t2), seconds(t2, t3), seconds(t3, t4), sum);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,226 @@
+// fuzzy-loader-test.cc
+//
+// this tests loading of fuzzy models of SIMLIB/C++ fuzzy module
+// (needs MODULES="fuzzy loader")
+// 1) XML definition of controller and fuzzy set in memory (FuzzyLoader)
+//    is compared with the same model built by constructors
+// 2) binary image round trip: FuzzyImageWriter::save, FuzzyImage::create
+// 3) time of XML analysis vs creation from image
+// 4) malformed XML is reported
+//
+
+#include "simlib.h"
+#include "fuzzy.h"
+#include "fuzzyloader.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+using namespace simlib3;
+
+const double tolerance = 1e-12;
+const char *image = "fuzzy-loader-test.img";
+
+// controller: inputs e, de, output u, rule u = w[2-(i+j)/2],
+// row j of behavior is word value j of de
+const char *classXML =
+  "<?xml version=\"1.0\"?>\n"
+  "<!DOCTYPE fuzzyclass SYSTEM \"fuzzy.dtd\">\n"
+  "<!-- fuzzy PD controller -->\n"
+  "<fuzzyclass>\n"
+  " <fuzzytype typename=\"e\" minrange=\"-10\" maxrange=\"10\">\n"
+  "  <fuzzymf mftype=\"FuzzyTrapez\" wordvalue=\"neg\">\n"
+  "   <value value=\"-10\"/><value value=\"-10\"/><value value=\"-5\"/><value value=\"0\"/>\n"
+  "  </fuzzymf>\n"
+  "  <fuzzymf mftype=\"FuzzyTriangle\" wordvalue=\"zero\">\n"
+  "   <value value=\"-5\"/><value value=\"0\"/><value value=\"5\"/>\n"
+  "  </fuzzymf>\n"
+  "  <fuzzymf mftype=\"FuzzyTrapez\" wordvalue=\"pos\">\n"
+  "   <value value=\"0\"/><value value=\"5\"/><value value=\"10\"/><value value=\"10\"/>\n"
+  "  </fuzzymf>\n"
+  " </fuzzytype>\n"
+  " <fuzzytype typename=\"de\" minrange=\"-10\" maxrange=\"10\">\n"
+  "  <fuzzymf mftype=\"FuzzyGauss\" wordvalue=\"neg\">\n"
+  "   <value value=\"-10\"/><value value=\"10\"/>\n"
+  "  </fuzzymf>\n"
+  "  <fuzzymf mftype=\"FuzzyGauss\" wordvalue=\"zero\">\n"
+  "   <value value=\"0\"/><value value=\"6\"/>\n"
+  "  </fuzzymf>\n"
+  "  <fuzzymf mftype=\"FuzzyGauss2\" wordvalue=\"pos\">\n"
+  "   <value value=\"8\"/><value value=\"9\"/><value value=\"10\"/><value value=\"1\"/>\n"
+  "  </fuzzymf>\n"
+  " </fuzzytype>\n"
+  " <fuzzytype typename=\"u\" minrange=\"-1\" maxrange=\"1\">\n"
+  "  <fuzzymf mftype=\"FuzzyTriangle\" wordvalue=\"neg\">\n"
+  "   <value value=\"-1\"/><value value=\"-0.5\"/><value value=\"0\"/>\n"
+  "  </fuzzymf>\n"
+  "  <fuzzymf mftype=\"FuzzyTriangle\" wordvalue=\"zero\">\n"
+  "   <value value=\"-0.5\"/><value value=\"0\"/><value value=\"0.5\"/>\n"
+  "  </fuzzymf>\n"
+  "  <fuzzymf mftype=\"FuzzyTriangle\" wordvalue=\"pos\">\n"
+  "   <value value=\"0\"/><value value=\"0.5\"/><value value=\"1\"/>\n"
+  "  </fuzzymf>\n"
+  " </fuzzytype>\n"
+  " <behavior>\n"
+  "  <row><outvalue value=\"pos\"/><outvalue value=\"pos\"/><outvalue value=\"zero\"/></row>\n"
+  "  <row><outvalue value=\"pos\"/><outvalue value=\"zero\"/><outvalue value=\"zero\"/></row>\n"
+  "  <row><outvalue value=\"zero\"/><outvalue value=\"zero\"/><outvalue value=\"neg\"/></row>\n"
+  " </behavior>\n"
+  "</fuzzyclass>\n";
+
+// single fuzzy set
+const char *setXML =
+  "<fuzzytype typename=\"temperature\" minrange=\"0\" maxrange=\"100\">\n"
+  " <fuzzymf mftype=\"FuzzyTriangle\" wordvalue=\"cold\">\n"
+  "  <value value=\"0\"/><value value=\"0\"/><value value=\"40\"/>\n"
+  " </fuzzymf>\n"
+  " <fuzzymf mftype=\"FuzzyGauss2\" wordvalue=\"warm\">\n"
+  "  <value value=\"40\"/><value value=\"15\"/><value value=\"60\"/><value value=\"20\"/>\n"
+  " </fuzzymf>\n"
+  " <fuzzymf mftype=\"FuzzyTrapez\" wordvalue=\"hot\">\n"
+  "  <value value=\"60\"/><value value=\"80\"/><value value=\"100\"/><value value=\"100\"/>\n"
+  " </fuzzymf>\n"
+  "</fuzzytype>\n";
+
+// max difference of outputs of two controllers (DCOG) on grid
+double CompareClass(FuzzyData &d1, FuzzyData &d2)
+{
+  FuzzyData *d[2] = { &d1, &d2 };
+  double maxd = 0;
+  for(int k=0; k<2; k++)
+    d[k]->getOutput()->SetDefuzzifyMethod(defuzDCOG);
+  for(double x=-10; x<=10; x+=0.37)
+    for(double y=-10; y<=10; y+=0.41) {
+      double u[2];
+      for(int k=0; k<2; k++) {
+        d[k]->getInput1()->Fuzzify(x);
+        d[k]->getInput2()->Fuzzify(y);
+        d[k]->getOutput()->Init();
+        d[k]->getRules()->evaluate();
+        u[k] = d[k]->getOutput()->Defuzzify();
+      }
+      maxd = fmax(maxd, fabs(u[0] - u[1]));
+    }
+  return maxd;
+}
+
+// max difference of memberships and names of two fuzzy sets
+double CompareSet(const FuzzySet &s1, const FuzzySet &s2)
+{
+  if(s1.count() != s2.count() || strcmp(s1.name(), s2.name()) != 0 ||
+     s1.min() != s2.min() || s1.max() != s2.max())
+    return 1;
+  double maxd = 0;
+  for(int i=0; i<s1.count(); i++) {
+    if(strcmp(s1.wordValue(i), s2.wordValue(i)) != 0)
+      return 1;
+    for(double x=s1.min(); x<=s1.max(); x+=(s1.max()-s1.min())/997)
+      maxd = fmax(maxd, fabs(s1[i]->Membership(x) - s2[i]->Membership(x)));
+  }
+  return maxd;
+}
+
+// analysis of XML text, NULL after error
+FuzzyData *Load(const char *text)
+{
+  FuzzyLoader loader;
+  loader.analyze(text, strlen(text), "fuzzy-loader-test");
+  if(loader.getNumErrors() > 0)
+    return NULL;
+  return (FuzzyData *)loader.getAnalyzedData();
+}
+
+double seconds(clock_t t0, clock_t t1) { return double(t1-t0)/CLOCKS_PER_SEC; }
+
+int main()
+{
+  SetOutput("fuzzy-loader-test.out");
+  Print("# loading of fuzzy models: XML and binary image\n");
+  int errors = 0;
+
+  // 1) XML vs constructors
+  FuzzySet s1("e", -10, 10, FuzzyTrapez("neg", -10, -10, -5, 0),
+              FuzzyTriangle("zero", -5, 0, 5), FuzzyTrapez("pos", 0, 5, 10, 10));
+  FuzzySet s2("de", -10, 10, FuzzyGauss("neg", -10, 10), FuzzyGauss("zero", 0, 6),
+              FuzzyGauss2("pos", 8, 9, 10, 1));
+  FuzzySet so("u", -1, 1, FuzzyTriangle("neg", -1, -0.5, 0),
+              FuzzyTriangle("zero", -0.5, 0, 0.5), FuzzyTriangle("pos", 0, 0.5, 1));
+  FuzzySet st("temperature", 0, 100, FuzzyTriangle("cold", 0, 0, 40),
+              FuzzyGauss2("warm", 40, 15, 60, 20), FuzzyTrapez("hot", 60, 80, 100, 100));
+  FuzzyInput *a = new FuzzyInput(s1), *b = new FuzzyInput(s2);
+  FuzzyOutput *o = new FuzzyOutput(so);
+  FuzzyIIORules *r = new FuzzyIIORules(a, b, o);
+  const char *w[3] = { "neg", "zero", "pos" };
+  for(int i=0; i<3; i++)
+    for(int j=0; j<3; j++)
+      r->add(FuzzyInferenceRules::opAND, w[i], w[j], w[2-(i+j)/2]);
+  FuzzyData built(a, b, o, r);
+  FuzzyData *cls = Load(classXML), *set = Load(setXML);
+  if(cls == NULL || set == NULL || !cls->isClass() || set->isClass()) {
+    Print("# XML analysis: FAILED\n");
+    return 1;
+  }
+  double dc = CompareClass(built, *cls), ds = CompareSet(st, *set->getFuzzySet());
+  Print("# XML controller: max |xml-constructors| = %.2g: %s\n",
+        dc, dc < tolerance ? "OK" : "FAILED");
+  Print("# XML fuzzy set: max |xml-constructors| = %.2g: %s\n",
+        ds, ds < tolerance ? "OK" : "FAILED");
+  errors += (dc >= tolerance) + (ds >= tolerance);
+
+  // 2) binary image
+  FuzzyImageWriter writer;
+  writer.add(*cls);
+  writer.add(*set);
+  writer.save(image);
+  {
+    FuzzyImage img(image);
+    bool ok = img.count() == 2 && img.isClass(0) && !img.isClass(1);
+    FuzzyData *ic = ok ? img.create(0) : 0, *is = ok ? img.create(1) : 0;
+    FuzzySet *fs = ok ? img.createSet(1) : 0;
+    if(ok) {
+      dc = CompareClass(*cls, *ic);
+      ds = fmax(CompareSet(*set->getFuzzySet(), *is->getFuzzySet()),
+                CompareSet(*set->getFuzzySet(), *fs));
+      ok = dc < tolerance && ds < tolerance;
+    }
+    Print("# image round trip (%u items): controller %.2g, set %.2g: %s\n",
+          img.count(), dc, ds, ok ? "OK" : "FAILED");
+    errors += !ok;
+    delete ic;
+    delete is;
+    delete fs;
+  }
+
+  // 3) time of analysis vs image
+  {
+    const int R = 2000;
+    clock_t t0 = clock();
+    for(int k=0; k<R; k++)
+      delete Load(classXML);
+    clock_t t1 = clock();
+    FuzzyImage img(image);
+    for(int k=0; k<R; k++)
+      delete img.create(0);
+    clock_t t2 = clock();
+    Print("# time %d loads of controller: XML %.3f s, image %.3f s\n",
+          R, seconds(t0, t1), seconds(t1, t2));
+  }
+  remove(image);
+
+  // 4) error in XML
+  {
+    FuzzyLoader loader;
+    const char *bad = "<fuzzytype typename=\"x\" minrange=\"0\" maxrange=\"1\">\n"
+                      " <fuzzymf mftype=\"FuzzyCircle\" wordvalue=\"a\"/>\n"
+                      "</fuzzytype>\n";
+    loader.analyze(bad, strlen(bad), "bad");
+    bool ok = loader.getNumErrors() > 0 && loader.getAnalyzedData() == NULL;
+    Print("# malformed XML (%d errors): %s\n", loader.getNumErrors(),
+          ok ? "OK" : "FAILED");
+    errors += !ok;
+  }
+  delete cls;
+  delete set;
+  return errors ? 1 : 0;
+}
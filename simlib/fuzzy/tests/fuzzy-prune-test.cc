@@ -0,0 +1,107 @@
+// fuzzy-prune-test.cc
+//
+// this tests profiling and pruning of FuzzyGeneralRules of SIMLIB/C++
+// 9 rules, input e stays positive on recorded trace, so 3 rules with
+// e=neg never fire and are removed by prune
+// 1) profile of evaluations on trace
+// 2) prune: outputs on trace are not changed, e=neg is unused
+// 3) rules added without release are only detached by prune,
+//    caller releases them
+//
+
+#include "simlib.h"
+#include "fuzzy.h"
+#include <cmath>
+#include <vector>
+
+using namespace simlib3;
+
+const double tolerance = 1e-12;
+
+// evaluation of rules for all rows of trace, outputs stored in u
+void EvaluateTrace(FuzzyGeneralRules &g, FuzzyInput &a, FuzzyInput &b,
+                   FuzzyOutput &o, const std::vector<double> &trace,
+                   std::vector<double> &u)
+{
+  u.clear();
+  for(unsigned row=0; row<trace.size(); row+=2) {
+    a.Fuzzify(trace[row]);
+    b.Fuzzify(trace[row+1]);
+    o.Init();
+    g.evaluate();
+    u.push_back(o.Defuzzify());
+  }
+}
+
+int main()
+{
+  SetOutput("fuzzy-prune-test.out");
+  Print("# profiling and pruning of fuzzy rules\n");
+  int errors = 0;
+  FuzzySet s1("e", -10, 10, FuzzyTrapez("neg", -10, -10, -5, 0),
+              FuzzyTriangle("zero", -5, 0, 5), FuzzyTrapez("pos", 0, 5, 10, 10));
+  FuzzySet s2("de", -10, 10, FuzzyGauss("neg", -10, 10), FuzzyGauss("zero", 0, 6),
+              FuzzyGauss2("pos", 8, 9, 10, 1));
+  FuzzySet so("u", -1, 1, FuzzyTriangle("neg", -1, -0.5, 0),
+              FuzzyTriangle("zero", -0.5, 0, 0.5), FuzzyTriangle("pos", 0, 0.5, 1));
+  FuzzyInput a(s1), b(s2);
+  FuzzyOutput o(so, defuzDCOG);
+  FuzzyGeneralRules g;
+  g.addFuzzyInput(&a);
+  g.addFuzzyInput(&b);
+  g.addFuzzyOutput(&o);
+  const char *w[3] = { "neg", "zero", "pos" };
+  FuzzyRule *detached[3];               // rules with e=neg, owned by caller
+  FuzzyRuleFactory *f = g.createRuleFactory();
+  for(int i=0; i<3; i++)
+    for(int j=0; j<3; j++) {
+      f->addCondition((FOperation*)f->createNode(f->createNode(&a, w[i]),
+                                                 f->createNode(&b, w[j]),
+                                                 FuzzyInferenceRules::opAND));
+      f->addConsequent(f->createNode(&o, w[2-(i+j)/2]));
+      FuzzyRule *rule = f->createRule();
+      if(i==0)
+        detached[j] = rule;
+      g.add(rule, i!=0);
+    }
+  delete f;
+
+  // trace: e in <0,10>, de in <-10,10>
+  std::vector<double> trace, before, after;
+  for(int k=0; k<500; k++) {
+    trace.push_back(5 + 5*sin(0.05*k));
+    trace.push_back(10*cos(0.031*k));
+  }
+
+  // 1) profile
+  g.setProfiling(true);
+  EvaluateTrace(g, a, b, o, trace, before);
+  g.printProfile();
+  unsigned silent = 0;
+  for(unsigned r=0; r<g.getNumRules(); r++)
+    silent += g.getRuleActivations(r) == 0;
+  bool ok = g.getEvaluations() == trace.size()/2 && silent == 3;
+  Print("# profile: %lu evaluations, %u rules never active: %s\n",
+        g.getEvaluations(), silent, ok ? "OK" : "FAILED");
+  errors += !ok;
+
+  // 2) prune
+  unsigned removed = g.prune(trace);
+  EvaluateTrace(g, a, b, o, trace, after);
+  double maxd = 0;
+  for(unsigned k=0; k<before.size(); k++)
+    maxd = fmax(maxd, fabs(before[k] - after[k]));
+  ok = removed == 3 && g.getNumRules() == 6 && maxd < tolerance &&
+       !g.isUsed(&a, 0) && g.isUsed(&a, 1) && g.isUsed(&b, 0);
+  Print("# prune: %u rules removed, %u left, max |after-before| = %.2g, "
+        "e=neg %s: %s\n", removed, g.getNumRules(), maxd,
+        g.isUsed(&a, 0) ? "used" : "unused", ok ? "OK" : "FAILED");
+  errors += !ok;
+  g.printProfile();
+
+  // 3) detached rules are released by caller
+  for(int j=0; j<3; j++)
+    delete detached[j];
+  Print("# detached rules released by caller: OK\n");
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,202 @@
+// fuzzy-rules-test.cc
+//
+// this tests fast evaluation of fuzzy rules of SIMLIB/C++
+// 1) batch membership FuzzySet::Membership(x, result) vs per-call
+//    evaluation of membership functions
+// 2) compiled postfix code of FuzzyGeneralRules vs evaluation of
+//    rule trees
+// 3) lookup table of FuzzyIIORules vs inference
+//
+
+#include "simlib.h"
+#include "fuzzy.h"
+#include <cmath>
+#include <ctime>
+
+using namespace simlib3;
+
+const double tolerance = 1e-12;         // batch and compiled evaluation
+const double table_tolerance = 0.02;    // 129x129 table (range of u is 2)
+
+// rules evaluated by trees (as before compilation)
+class TreeRules : public FuzzyGeneralRules {
+ public:
+  void evaluateTree() {
+    for(unsigned i=0; i<rules.size(); i++)
+      rules[i]->evaluate();
+  }
+};
+
+// 9 rules: AND of inputs, some with OR/NOT/NOR subtrees
+void AddRules(FuzzyGeneralRules &g, FuzzyInput &a, FuzzyInput &b,
+              FuzzyOutput &o) {
+  const char *w[3] = { "neg", "zero", "pos" };
+  FuzzyRuleFactory *f = g.createRuleFactory();
+  for(int i=0; i<3; i++)
+    for(int j=0; j<3; j++) {
+      FONode *c = f->createNode(f->createNode(&a, w[i]), f->createNode(&b, w[j]),
+                                FuzzyInferenceRules::opAND);
+      if(i==1)
+        c = f->createNode(c, f->createNode(f->createNode(&b, "zero"),
+                                           FuzzyInferenceRules::opNOT),
+                          FuzzyInferenceRules::opOR);
+      if(j==2)
+        c = f->createNode(c, f->createNode(&a, "pos"), FuzzyInferenceRules::opNOR);
+      f->addCondition((FOperation*)c);
+      f->addConsequent(f->createNode(&o, w[2-(i+j)/2]));
+      g.add(f->createRule());
+    }
+  delete f;
+}
+
+double seconds(clock_t t0, clock_t t1) { return double(t1-t0)/CLOCKS_PER_SEC; }
+
+int main()
+{
+  SetOutput("fuzzy-rules-test.out");
+  Print("# fast evaluation of fuzzy rules\n");
+  int errors = 0;
+  FuzzySet s1("e", -10, 10, FuzzyTrapez("neg", -10, -10, -5, 0),
+              FuzzyTriangle("zero", -5, 0, 5), FuzzyTrapez("pos", 0, 5, 10, 10));
+  FuzzySet s2("de", -10, 10, FuzzyGauss("neg", -10, 10), FuzzyGauss("zero", 0, 6),
+              FuzzyGauss2("pos", 8, 9, 10, 1));
+  FuzzySet so("u", -1, 1, FuzzyTriangle("neg", -1, -0.5, 0),
+              FuzzyTriangle("zero", -0.5, 0, 0.5), FuzzyTriangle("pos", 0, 0.5, 1));
+
+  // 1) batch membership
+  {
+    const FuzzySet *s[2] = { &s1, &s2 };
+    double m[FuzzySet::MAX], maxd = 0;
+    for(double x=-10; x<=10; x+=0.01)
+      for(int k=0; k<2; k++) {
+        s[k]->Membership(x, m);
+        for(int i=0; i<s[k]->count(); i++)
+          maxd = fmax(maxd, fabs(m[i] - (*s[k])[i]->Membership(x)));
+      }
+    Print("# batch membership: max |batch-per call| = %.2g (tolerance %g): %s\n",
+          maxd, tolerance, maxd < tolerance ? "OK" : "FAILED");
+    errors += maxd >= tolerance;
+    const int R = 1000000;
+    for(int k=0; k<2; k++) {
+      double sum = 0;
+      clock_t t0 = clock();
+      for(int r=0; r<R; r++) {
+        s[k]->Membership(-10 + 20.0*(r%1001)/1000, m);
+        sum += m[0] + m[1] + m[2];
+      }
+      clock_t t1 = clock();
+      for(int r=0; r<R; r++) {
+        double x = -10 + 20.0*(r%1001)/1000;
+        for(int i=0; i<s[k]->count(); i++)
+          sum += (*s[k])[i]->Membership(x);
+      }
+      clock_t t2 = clock();
+      Print("# time %d evaluations of set %s: batch %.3f s, per call %.3f s (%g)\n",
+            R, s[k]->name(), seconds(t0, t1), seconds(t1, t2), sum);
+    }
+  }
+
+  // 2) compiled rules vs trees
+  {
+    FuzzyInput a(s1), b(s2);
+    FuzzyOutput o(so, defuzDCOG);
+    TreeRules g;
+    g.addFuzzyInput(&a);
+    g.addFuzzyInput(&b);
+    g.addFuzzyOutput(&o);
+    AddRules(g, a, b, o);
+    double maxd = 0;
+    for(double x=-10; x<=10; x+=0.37)
+      for(double y=-10; y<=10; y+=0.41) {
+        a.Fuzzify(x);
+        b.Fuzzify(y);
+        o.Init();
+        g.evaluate();
+        double c[3] = { o[0], o[1], o[2] };
+        o.Init();
+        g.evaluateTree();
+        for(int k=0; k<3; k++)
+          maxd = fmax(maxd, fabs(c[k] - o[k]));
+      }
+    const int R = 300000;
+    double sum = 0;
+    clock_t t0 = clock();
+    for(int r=0; r<R; r++) {
+      a.Fuzzify(-10 + 20.0*(r%997)/996);
+      b.Fuzzify(-10 + 20.0*(r%991)/990);
+      o.Init();
+      g.evaluate();
+      sum += o[0];
+    }
+    clock_t t1 = clock();
+    for(int r=0; r<R; r++) {
+      a.Fuzzify(-10 + 20.0*(r%997)/996);
+      b.Fuzzify(-10 + 20.0*(r%991)/990);
+      o.Init();
+      g.evaluateTree();
+      sum += o[0];
+    }
+    clock_t t2 = clock();
+    Print("# compiled rules: max |compiled-tree| = %.2g (tolerance %g): %s\n",
+          maxd, tolerance, maxd < tolerance ? "OK" : "FAILED");
+    Print("# time %d evaluations: compiled %.3f s, tree %.3f s (%g)\n",
+          R, seconds(t0, t1), seconds(t1, t2), sum);
+    errors += maxd >= tolerance;
+  }
+
+  // 3) lookup table of IIO controller vs inference
+  {
+    Variable x, y;
+    FuzzyInput a(x, s1), b(y, s2);
+    FuzzyOutput o(so, defuzDCOG);
+    FuzzyIIORules r(&a, &b, &o);
+    const char *w[3] = { "neg", "zero", "pos" };
+    for(int i=0; i<3; i++)
+      for(int j=0; j<3; j++)
+        r.add(FuzzyInferenceRules::opAND, w[i], w[j], w[2-(i+j)/2]);
+    FuzzyRSBlock block(r);
+    block.EndConstructor();
+    a.registerOwner(&block);
+    b.registerOwner(&block);
+    o.registerOwner(&block);
+    const int N = 60;
+    static double ref[N][N];
+    for(int i=0; i<N; i++)
+      for(int j=0; j<N; j++) {
+        x = -10 + 20*i/(N-0.7);
+        y = -10 + 20*j/(N-0.3);
+        ref[i][j] = o.Value();
+      }
+    r.createLookupTable(129, 129);
+    double maxd = 0;
+    for(int i=0; i<N; i++)
+      for(int j=0; j<N; j++) {
+        x = -10 + 20*i/(N-0.7);
+        y = -10 + 20*j/(N-0.3);
+        maxd = fmax(maxd, fabs(o.Value() - ref[i][j]));
+      }
+    const int R = 300000;
+    double sum = 0;
+    clock_t t0 = clock();
+    for(int k=0; k<R; k++) {
+      x = -10 + 20.0*(k%997)/996;
+      y = -10 + 20.0*(k%991)/990;
+      sum += o.Value();
+    }
+    clock_t t1 = clock();
+    r.removeLookupTable();
+    for(int k=0; k<R; k++) {
+      x = -10 + 20.0*(k%997)/996;
+      y = -10 + 20.0*(k%991)/990;
+      sum += o.Value();
+    }
+    clock_t t2 = clock();
+    Print("# IIO lookup table 129x129: max |table-inference| = %.2g "
+          "(tolerance %g): %s\n",
+          maxd, table_tolerance, maxd < table_tolerance ? "OK" : "FAILED");
+    Print("# time %d evaluations: table %.3f s, inference %.3f s (%g)\n",
+          R, seconds(t0, t1), seconds(t1, t2), sum);
+    errors += maxd >= table_tolerance;
+  }
+  return errors ? 1 : 0;
+}
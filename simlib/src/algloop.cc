@@ -15,6 +15,8 @@
 #include "internal.h"
 
 #include <cmath>
+#include <vector>
+#include <algorithm>
 
 //#define LOOP_DEBUG
 
@@ -503,6 +505,334 @@ double Newton::Value()
   return root;
 } // Newton::Value
 
+
+////////////////////////////////////////////////////////////////////////////
+// NewtonKrylov  --  vector algebraic loop
+//
+/* Formula:
+
+   r(x) = x - f(x)                      -- residual
+   J*dx = -r(x),  J*v ~ (r(x+h*v)-r(x))/h   -- GMRES, without matrix J
+   x[n+1] = x[n] + lambda*dx            -- lambda = 1, 1/2, ... (damping)
+
+   GMRES is right-preconditioned by LU of finite-difference Jacobian,
+   which is computed only when Newton iterations converge slowly
+*/
+
+/// output block of the loop: component of solution
+class NewtonKrylov::output : public aContiBlock {
+  NewtonKrylov *loop;
+  unsigned index;
+ public:
+  output(NewtonKrylov *l, unsigned i): loop(l), index(i) {}
+  virtual double Value() { return loop->Value(index); }
+};
+
+/// vector operations
+static double dot(const std::vector<double> &a, const std::vector<double> &b)
+{
+  double s = 0;
+  for(unsigned i=0; i<a.size(); i++)
+    s += a[i]*b[i];
+  return s;
+}
+
+static double norm(const std::vector<double> &a)
+{
+  return sqrt(dot(a,a));
+}
+
+static double maxnorm(const std::vector<double> &a)
+{
+  double m = 0;
+  for(unsigned i=0; i<a.size(); i++)
+    m = max(m, fabs(a[i]));
+  return m;
+}
+
+NewtonKrylov::NewtonKrylov(unsigned _n, double eps, unsigned long max_it) :
+  n(_n),
+  Eps(eps),
+  MaxIt(max_it),
+  in(_n, Input(0.0)),
+  out(_n),
+  x(_n, 0.0),
+  cur(0),
+  lu(_n*_n),
+  piv(_n),
+  jac_valid(false),
+  solving(false),
+  stamp(SIMLIB_EvalCount-1),
+  icount(0), fcount(0), jcount(0)
+{
+  if(n==0)
+    SIMLIB_error(AL_BadDimension);
+  for(unsigned i=0; i<n; i++)
+    out[i] = new output(this, i);
+}
+
+NewtonKrylov::~NewtonKrylov()
+{
+  for(unsigned i=0; i<n; i++)
+    delete out[i];
+}
+
+void NewtonKrylov::Set(double eps, unsigned long max_it)
+{
+  Eps = eps;
+  MaxIt = max_it;
+}
+
+void NewtonKrylov::SetInput(unsigned i, Input inp)
+{
+  in[i].Set(inp);
+  jac_valid = false;
+}
+
+void NewtonKrylov::Init(unsigned i, double x0)
+{
+  x[i] = x0;
+  stamp = SIMLIB_EvalCount-1;          // solution is not valid
+}
+
+Input NewtonKrylov::operator[] (unsigned i)
+{
+  return out[i];
+}
+
+/// get name of object
+const char *NewtonKrylov::Name() const
+{
+  if (HasName())
+    return _name;
+  else
+    return SIMLIB_create_tmp_name("NewtonKrylov{%p}", this);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// NewtonKrylov::Value  --  returned value
+//
+// the solution is computed once per model evaluation (in dynamic section),
+// outputs return the trial value when loop inputs are evaluated
+//
+double NewtonKrylov::Value(unsigned i)
+{
+  if(solving)
+    return cur[i];                     // inside loop: trial solution
+  if(!SIMLIB_DynamicFlag || stamp!=SIMLIB_EvalCount) {
+    stamp = SIMLIB_EvalCount;
+    Solve();
+  }
+  return x[i];
+}
+
+////////////////////////////////////////////////////////////////////////////
+// NewtonKrylov::Residual  --  r = t - f(t)
+//
+void NewtonKrylov::Residual(const double *t, double *r)
+{
+  const double *save = cur;
+  cur = t;
+  for(unsigned i=0; i<n; i++)
+    r[i] = t[i] - in[i].Value();       // go through loop
+  cur = save;
+  fcount++;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// NewtonKrylov::Jacobian  --  finite differences + LU decomposition
+//
+void NewtonKrylov::Jacobian(const double *r)
+{
+  std::vector<double> t(x), rt(n);
+  jcount++;
+  for(unsigned k=0; k<n; k++) {       // column k
+    const double h = 1e-7 * max(1.0, fabs(x[k]));
+    t[k] = x[k] + h;
+    Residual(&t[0], &rt[0]);
+    t[k] = x[k];
+    for(unsigned i=0; i<n; i++)
+      lu[i*n+k] = (rt[i] - r[i]) / h;
+  }
+  // LU decomposition with partial pivoting
+  jac_valid = true;
+  for(unsigned k=0; k<n; k++) {
+    unsigned p = k;
+    for(unsigned i=k+1; i<n; i++)
+      if(fabs(lu[i*n+k]) > fabs(lu[p*n+k]))
+        p = i;
+    piv[k] = p;
+    if(lu[p*n+k] == 0.0) {             // singular: no preconditioning
+      jac_valid = false;
+      return;
+    }
+    if(p != k)
+      for(unsigned j=0; j<n; j++)
+        std::swap(lu[k*n+j], lu[p*n+j]);
+    for(unsigned i=k+1; i<n; i++) {
+      const double m = (lu[i*n+k] /= lu[k*n+k]);
+      for(unsigned j=k+1; j<n; j++)
+        lu[i*n+j] -= m * lu[k*n+j];
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////
+// NewtonKrylov::Precondition  --  v = inverse(J)*v  (using old LU)
+//
+void NewtonKrylov::Precondition(double *v)
+{
+  if(!jac_valid)
+    return;
+  for(unsigned k=0; k<n; k++) {
+    std::swap(v[k], v[piv[k]]);
+    for(unsigned i=k+1; i<n; i++)
+      v[i] -= lu[i*n+k] * v[k];
+  }
+  for(unsigned k=n; k-- > 0; ) {
+    for(unsigned j=k+1; j<n; j++)
+      v[k] -= lu[k*n+j] * v[j];
+    v[k] /= lu[k*n+k];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////
+// NewtonKrylov::GMRES  --  solve J*dx = -r  (inexact: relative tol. 0.1)
+//
+// returns false if required precision was not reached
+//
+bool NewtonKrylov::GMRES(const double *r, double *dx)
+{
+  const unsigned m = n<50 ? n : 50;    // max. Krylov subspace dimension
+  std::vector< std::vector<double> > V(m+1, std::vector<double>(n));
+  std::vector< std::vector<double> > H(m+1, std::vector<double>(m, 0.0));
+  std::vector<double> cs(m), sn(m), g(m+1, 0.0);
+  std::vector<double> z(n), t(n), rt(n);
+  for(unsigned i=0; i<n; i++)
+    V[0][i] = -r[i];
+  const double beta = norm(V[0]);
+  const double tol = 0.1 * beta;
+  for(unsigned i=0; i<n; i++)
+    V[0][i] /= beta;
+  g[0] = beta;
+  const double xnorm = norm(x);
+  unsigned k = 0;                      // dimension of solution
+  while(k<m) {
+    // w = J * inverse(M) * V[k]
+    z = V[k];
+    Precondition(&z[0]);
+    const double znorm = norm(z);
+    const double h = 1e-7 * max(1.0, xnorm) / (znorm>0 ? znorm : 1);
+    for(unsigned i=0; i<n; i++)
+      t[i] = x[i] + h*z[i];
+    Residual(&t[0], &rt[0]);
+    std::vector<double> &w = V[k+1];
+    for(unsigned i=0; i<n; i++)
+      w[i] = (rt[i] - r[i]) / h;
+    // Arnoldi (modified Gram-Schmidt)
+    for(unsigned j=0; j<=k; j++) {
+      H[j][k] = dot(w, V[j]);
+      for(unsigned i=0; i<n; i++)
+        w[i] -= H[j][k] * V[j][i];
+    }
+    H[k+1][k] = norm(w);
+    // Givens rotations
+    for(unsigned j=0; j<k; j++) {
+      const double a = cs[j]*H[j][k] + sn[j]*H[j+1][k];
+      H[j+1][k] = -sn[j]*H[j][k] + cs[j]*H[j+1][k];
+      H[j][k] = a;
+    }
+    const double d = sqrt(H[k][k]*H[k][k] + H[k+1][k]*H[k+1][k]);
+    if(d == 0.0)
+      break;                           // breakdown
+    cs[k] = H[k][k] / d;
+    sn[k] = H[k+1][k] / d;
+    const double wnorm = H[k+1][k];
+    H[k][k] = d;
+    H[k+1][k] = 0.0;
+    g[k+1] = -sn[k] * g[k];
+    g[k] = cs[k] * g[k];
+    k++;
+    if(fabs(g[k]) <= tol || wnorm == 0.0)
+      break;                           // converged
+    for(unsigned i=0; i<n; i++)
+      w[i] /= wnorm;
+  }
+  // y = inverse(H) * g,  dx = inverse(M) * V * y
+  std::vector<double> y(k);
+  for(unsigned j=k; j-- > 0; ) {
+    double s = g[j];
+    for(unsigned l=j+1; l<k; l++)
+      s -= H[j][l] * y[l];
+    y[j] = s / H[j][j];
+  }
+  for(unsigned i=0; i<n; i++) {
+    double s = 0;
+    for(unsigned j=0; j<k; j++)
+      s += V[j][i] * y[j];
+    dx[i] = s;
+  }
+  Precondition(dx);
+  return fabs(g[k]) <= tol;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// NewtonKrylov::Solve  --  damped inexact Newton iterations
+//
+void NewtonKrylov::Solve()
+{
+  std::vector<double> r(n), dx(n), t(n), rt(n);
+  solving = true;
+  Residual(&x[0], &r[0]);              // warm start: previous solution
+  unsigned long count = 0;
+  while(maxnorm(r) > Eps) {
+    if(count >= MaxIt) {
+      SIMLIB_warning(AL_MaxCount);
+      break;
+    }
+    count++;
+    icount++;
+    if(!jac_valid)
+      Jacobian(&r[0]);
+    if(!GMRES(&r[0], &dx[0]))
+      jac_valid = false;               // bad preconditioner
+    // damping: residual should decrease
+    const double rnorm = norm(r);
+    double lambda = 1.0;
+    double rtnorm;
+    for(int i=0; ; i++) {
+      for(unsigned j=0; j<n; j++)
+        t[j] = x[j] + lambda*dx[j];
+      Residual(&t[0], &rt[0]);
+      rtnorm = norm(rt);
+      if(rtnorm < rnorm || i >= 5)
+        break;
+      lambda *= 0.5;
+    }
+    if(rtnorm > 0.5*rnorm)
+      jac_valid = false;               // slow convergence: new Jacobian
+    x = t;
+    r = rt;
+  }
+  dbgprnt(("NewtonKrylov-count: %lu\n",count));
+  solving = false;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// NewtonKrylov::Output  --  print statistics
+//
+void NewtonKrylov::Output() const
+{
+  Print("+----------------------------------------------------------+\n");
+  Print("| NEWTON-KRYLOV %-42s |\n", Name());
+  Print("+----------------------------------------------------------+\n");
+  Print("|  Dimension = %-10u                                  |\n", n);
+  Print("|  Newton iterations = %-10lu                          |\n", icount);
+  Print("|  Loop evaluations = %-10lu                           |\n", fcount);
+  Print("|  Jacobian evaluations = %-10lu                       |\n", jcount);
+  Print("+----------------------------------------------------------+\n");
+}
+
 }
 
 // end
@@ -0,0 +1,244 @@
+/////////////////////////////////////////////////////////////////////////////
+//! \file batchmeans.cc  Steady-state output analysis
+//
+// Copyright (c) 2026 agent <agent@local>
+//
+// This library is licensed under GNU Library GPL. See the file COPYING.
+//
+
+//
+// description:
+//    implementation of class BatchMeans
+//    - periodic sampling of Stat/TStat (sums and weights of intervals)
+//    - MSER-5 warm-up detection (K. P. White, 1997)
+//    - batch means confidence interval of steady-state mean
+//    - stops simulation run when required precision is reached
+//
+
+////////////////////////////////////////////////////////////////////////////
+// interface
+//
+
+#include "simlib.h"
+#include "internal.h"
+
+#include <cmath>
+
+
+////////////////////////////////////////////////////////////////////////////
+// implementation
+//
+
+namespace simlib3 {
+
+SIMLIB_IMPLEMENTATION;
+
+////////////////////////////////////////////////////////////////////////////
+// NormalQuantile --- inverse of standard normal distribution function
+// (P. J. Acklam's rational approximation, relative error < 1.2e-9)
+//
+static double NormalQuantile(double p)
+{
+  static const double a[6] = { -3.969683028665376e+01, 2.209460984245205e+02,
+    -2.759285104469687e+02, 1.383577518672690e+02, -3.066479806614716e+01,
+     2.506628277459239e+00 };
+  static const double b[5] = { -5.447609879822406e+01, 1.615858368580409e+02,
+    -1.556989798598866e+02, 6.680131188771972e+01, -1.328068155288572e+01 };
+  static const double c[6] = { -7.784894002430293e-03, -3.223964580411365e-01,
+    -2.400758277161838e+00, -2.549732539343734e+00, 4.374664141464968e+00,
+     2.938163982698783e+00 };
+  static const double d[4] = { 7.784695709041462e-03, 3.224671290700398e-01,
+     2.445134137142996e+00, 3.754408661907416e+00 };
+  if (p < 0.02425) {                  // lower tail
+    double q = sqrt(-2*log(p));
+    return (((((c[0]*q+c[1])*q+c[2])*q+c[3])*q+c[4])*q+c[5]) /
+           ((((d[0]*q+d[1])*q+d[2])*q+d[3])*q+1);
+  }
+  if (p > 1 - 0.02425)                // upper tail
+    return -NormalQuantile(1 - p);
+  double q = p - 0.5, r = q*q;
+  return (((((a[0]*r+a[1])*r+a[2])*r+a[3])*r+a[4])*r+a[5])*q /
+         (((((b[0]*r+b[1])*r+b[2])*r+b[3])*r+b[4])*r+1);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// StudentQuantile --- quantile of t distribution with df degrees of freedom
+// (Cornish-Fisher expansion, Abramowitz & Stegun 26.7.5)
+//
+static double StudentQuantile(double p, double df)
+{
+  double z = NormalQuantile(p), z2 = z*z;
+  double g1 = (z2 + 1) * z / 4;
+  double g2 = ((5*z2 + 16)*z2 + 3) * z / 96;
+  double g3 = (((3*z2 + 19)*z2 + 17)*z2 - 15) * z / 384;
+  double g4 = ((((79*z2 + 776)*z2 + 1482)*z2 - 1920)*z2 - 945) * z / 92160;
+  return z + (g1 + (g2 + (g3 + g4/df)/df)/df)/df;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// constructors
+//
+BatchMeans::BatchMeans(const Stat &s, double dt, double prec, double lev) :
+  Sampler(0, dt),
+  stat(&s),
+  tstat(0)
+{
+  Dprintf(("BatchMeans::BatchMeans(Stat,%g,%g,%g)", dt, prec, lev));
+  Init(dt, prec, lev);
+}
+
+BatchMeans::BatchMeans(const TStat &s, double dt, double prec, double lev) :
+  Sampler(0, dt),
+  stat(0),
+  tstat(&s)
+{
+  Dprintf(("BatchMeans::BatchMeans(TStat,%g,%g,%g)", dt, prec, lev));
+  Init(dt, prec, lev);
+}
+
+void BatchMeans::Init(double dt, double prec, double lev)
+{
+  if (dt <= 0 || prec <= 0 || lev <= 0 || lev >= 1)
+    SIMLIB_error(BatchMeansError);
+  precision = prec;
+  level = lev;
+  nbatches = 20;
+  stop = true;
+  Clear();
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Clear --- forget all samples and results
+//
+void BatchMeans::Clear()
+{
+  started = false;
+  lastsum = lastw = lasttime = 0;
+  obs.clear();
+  weights.clear();
+  times.clear();
+  warmup = 0;
+  mean = halfwidth = 0;
+  precise = false;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// SetBatches --- number of batches for confidence interval
+//
+void BatchMeans::SetBatches(unsigned n)
+{
+  if (n < 5)
+    SIMLIB_error(BatchMeansError);
+  nbatches = n;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// WarmUpTime --- time of the end of warm-up period (last analysis)
+//
+double BatchMeans::WarmUpTime() const
+{
+  if (times.empty())
+    return Time;
+  return warmup < times.size() ? times[warmup] : times.back();
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Behavior --- sample mean of the last interval, analyze, stop run
+//
+void BatchMeans::Behavior()
+{
+  Dprintf(("BatchMeans::Behavior()"));
+  if (last < 0)                       // first sample of the run
+    Clear();
+  Sample();
+  double s, w;                        // cumulative sum and weight
+  if (stat) {
+    s = stat->Sum();
+    w = stat->Number();
+  } else {
+    s = tstat->Sum() + tstat->LastValue() * (double(Time) - tstat->LastTime());
+    w = double(Time) - tstat->StartTime();
+  }
+  if (started && w > lastw) {         // not empty and not cleared
+    obs.push_back(s - lastsum);
+    weights.push_back(w - lastw);
+    times.push_back(lasttime);
+    if (obs.size() % 5 == 0)
+      Analyze();
+  }
+  started = true;
+  lastsum = s;
+  lastw = w;
+  lasttime = Time;
+  if (precise && stop)
+    ::simlib3::Stop();                // end of simulation run
+  if (on && step > 0.0)
+    Activate(Time + step);            // schedule next sample
+  else
+    Passivate();
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Analyze --- MSER-5 truncation + batch means
+//
+void BatchMeans::Analyze()
+{
+  const unsigned m = obs.size() / 5;  // MSER-5 batches
+  precise = false;
+  if (m < 2 * nbatches / 5 + 2)
+    return;                           // too few data
+  // z[j] = mean of 5 intervals, sums from the end
+  std::vector<double> z(m);
+  for (unsigned j = 0; j < m; j++) {
+    double s = 0, w = 0;
+    for (unsigned i = 5 * j; i < 5 * j + 5; i++) {
+      s += obs[i];
+      w += weights[i];
+    }
+    z[j] = s / w;
+  }
+  double s1 = 0, s2 = 0, best = -1;
+  unsigned d = 0;
+  std::vector<double> mser(m);
+  for (unsigned j = m; j-- > 0; ) {
+    s1 += z[j];
+    s2 += z[j] * z[j];
+    double k = m - j;
+    mser[j] = (s2 - s1 * s1 / k) / (k * k);
+  }
+  for (unsigned j = 0; j <= m / 2; j++)
+    if (best < 0 || mser[j] < best) {
+      best = mser[j];
+      d = j;
+    }
+  warmup = 5 * d;
+  if (d >= m / 2)                     // minimum in second half: too short
+    return;
+  // batch means of data after warm-up
+  const unsigned r = obs.size() - warmup;
+  const unsigned bs = r / nbatches;   // batch size
+  if (bs == 0)
+    return;
+  unsigned i = obs.size() - bs * nbatches;
+  double sum = 0, sum2 = 0;
+  for (unsigned b = 0; b < nbatches; b++) {
+    double s = 0, w = 0;
+    for (unsigned e = i + bs; i < e; i++) {
+      s += obs[i];
+      w += weights[i];
+    }
+    double y = s / w;                 // ratio estimator of batch mean
+    sum += y;
+    sum2 += y * y;
+  }
+  mean = sum / nbatches;
+  double var = (sum2 - sum * mean) / (nbatches - 1);
+  if (var < 0) var = 0;
+  halfwidth = StudentQuantile((1 + level) / 2, nbatches - 1) *
+              sqrt(var / nbatches);
+  precise = halfwidth <= precision * fabs(mean);
+}
+
+} // namespace
+
+// end of batchmeans.cc
@@ -34,20 +34,22 @@ aCondition *aCondition::First = 0;       // condition list
 // aCondition implementation
 //
 aCondition::aCondition() :
-  Next(First)
+  Next(First),
+  Prev(0)
 {
+  if (First)
+    First->Prev = this;
   First = this;
 }
 
 aCondition::~aCondition() {
-  if (this==First)
-    First = Next;
+  // double linked list: O(1) removal
+  if (Prev)
+    Prev->Next = Next;
   else
-  {
-    aCondition *i;
-    for(i=First; i && i->Next!=this; i=i->Next) { /*empty*/ }
-    if (i) i->Next = Next;
-  }
+    First = Next;
+  if (Next)
+    Next->Prev = Prev;
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -150,6 +152,144 @@ void SIMLIB_DoConditions()
   }
 }
 
+////////////////////////////////////////////////////////////////////////////
+// ConditionGroup implementation
+//
+ConditionGroup::ConditionGroup(Input i) :
+    in(i),
+    x(0),
+    xl(0),
+    first(true)
+{
+}
+
+ConditionGroup::~ConditionGroup()
+{
+  // thresholds stay alive, but they are not tested any more
+  for(container_t::iterator i=thresholds.begin(); i!=thresholds.end(); ++i)
+    i->second->group = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// ConditionGroup::Init -- initialize
+//
+void ConditionGroup::Init()
+{
+  x = xl = 0;
+  first = true;                // no crossing at initial state evaluation
+}
+
+////////////////////////////////////////////////////////////////////////////
+// ConditionGroup::SetNewStatus -- set new status of all thresholds
+//
+void ConditionGroup::SetNewStatus()
+{
+  xl = x;
+  first = false;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// ConditionGroup::Crossed -- is there any threshold in (xl,x] or (x,xl]?
+//
+bool ConditionGroup::Crossed()
+{
+  if(first || x==xl)
+    return false;
+  // condition "x>=level" changes for all levels in interval (min,max]
+  container_t::iterator i = thresholds.upper_bound(min(x,xl));
+  return i!=thresholds.end() && i->first <= max(x,xl);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// ConditionGroup::Test -- single test for all thresholds: O(log n)
+//
+bool ConditionGroup::Test()
+{
+  x = in.Value();
+  if(SIMLIB_DynamicFlag)       // inside numerical integration step
+  {
+    if(Crossed()) {            // is change of status?
+      SIMLIB_ConditionFlag = true;  // global change flag
+      ContractStep();          // need to step contraction
+    }
+    return false;              // test only
+  }
+  return Crossed();            // do actions if changed
+}
+
+////////////////////////////////////////////////////////////////////////////
+// ConditionGroup::Action -- state events of all crossed thresholds
+//
+void ConditionGroup::Action()
+{
+  if(!Crossed())
+    return;
+  const bool up = xl < x;
+  container_t::iterator i = thresholds.upper_bound(min(x,xl));
+  container_t::iterator end = thresholds.upper_bound(max(x,xl));
+  pending.clear();
+  for( ; i!=end; ++i) {
+    ThresholdCondition *t = i->second;
+    t->up = up;
+    if(t->direction & (up ? ThresholdCondition::UP : ThresholdCondition::DOWN))
+      pending.push_back(t);
+  }
+  // actions can create/move/delete thresholds (see ~ThresholdCondition)
+  for(unsigned k=0; k<pending.size(); k++)
+    if(pending[k])
+      pending[k]->Action();
+  pending.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// get name of object
+const char *ConditionGroup::Name() const {
+  if(HasName()) return _name;
+  else return SIMLIB_create_tmp_name("ConditionGroup{%p}", this);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// ThresholdCondition implementation
+//
+ThresholdCondition::ThresholdCondition(ConditionGroup &g, double _level,
+                                       Direction d) :
+    group(&g),
+    level(_level),
+    up(false),
+    direction(d)
+{
+  pos = group->thresholds.insert(std::make_pair(level, this)); // O(log n)
+}
+
+ThresholdCondition::~ThresholdCondition()
+{
+  if(!group)
+    return;
+  group->thresholds.erase(pos);                                 // O(1)
+  for(unsigned k=0; k<group->pending.size(); k++)  // deleted by Action
+    if(group->pending[k]==this)
+      group->pending[k] = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// ThresholdCondition::SetLevel -- move the threshold
+//
+void ThresholdCondition::SetLevel(double newlevel)
+{
+  level = newlevel;
+  if(!group)
+    return;
+  group->thresholds.erase(pos);
+  pos = group->thresholds.insert(std::make_pair(level, this));
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// get name of object
+const char *ThresholdCondition::Name() const {
+  if(HasName()) return _name;
+  else return SIMLIB_create_tmp_name("ThresholdCondition{%p}", this);
+}
+
 ////////////////////////////////////////////////////////////////////////////
 /// get name of object
 const char *Condition::Name() const {
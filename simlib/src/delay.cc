@@ -16,7 +16,7 @@
 //
 // LIMITS:
 //     dt <= MaxStep --- problem with too small delay time
-//     increasing dt --- problem with buffer length
+//     increasing dt --- old samples can be already removed
 //
 
 ////////////////////////////////////////////////////////////////////////////
@@ -27,7 +27,7 @@
 #include "delay.h"              // extra header, TODO: move to simlib.h
 #include "internal.h"
 
-#include <deque>                // for buffer implementation
+#include <algorithm>            // std::rotate
 #include <list>                 // for registration list of all delay blocks
 
 
@@ -101,74 +101,158 @@ struct Delay::Buffer {
 ///
 /// This buffer inherits interface from Delay::Buffer (we can use various
 /// implementations later)
-/// method get() does linear interpolation ? TODO: should be split
+///
+/// Samples are stored in a contiguous ring buffer (no allocation per sample),
+/// capacity is power of 2 estimated from dt/MaxStep and it grows up to
+/// dt/MinStep (max. MAXCAPACITY). If the buffer is full at maximal capacity,
+/// every second sample is dropped and minimal distance of stored samples
+/// is doubled (adaptive subsampling), so the memory is bounded.
+/// Method get() does linear interpolation, the position of the last lookup
+/// is cached (typical access is sequential), binary search is used otherwise.
 ///
 class SIMLIB_DelayBuffer : public Delay::Buffer { // memory for delayed signal
-    /// pair (t,val) for storing in buffer TODO: use std::tuple
+    /// pair (t,val) for storing in buffer
     struct Pair {
         double time;    //<! sample time
         double value;   //<! sampled value
-        Pair(double t, double v) : time(t), value(v) {}
-        bool operator == (Pair &p) { return p.time==time && p.value==value; }
+        Pair(double t=0, double v=0) : time(t), value(v) {}
+        bool operator == (const Pair &p) const {
+            return p.time==time && p.value==value;
+        }
     };
-    std::deque<Pair> buf;       //!< storage for samples
+    static const unsigned MINCAPACITY = 16;     //!< (power of 2)
+    static const unsigned MAXCAPACITY = 1<<16;  //!< (power of 2)
+    const double &dt;           //!< delay time (parameter of Delay block)
+    Pair *buf;                  //!< storage for samples (ring buffer)
+    unsigned capacity;          //!< allocated size (power of 2)
+    unsigned head;              //!< index of the oldest sample
+    unsigned n;                 //!< number of samples
+    unsigned cursor;            //!< position of last lookup (from head)
+    double spacing;             //!< minimal distance of samples (subsampling)
     Pair last_insert;           //!< last inserted value (for optimization)
 
+    Pair &at(unsigned i) { return buf[(head+i) & (capacity-1)]; }
+
+    /// power of 2 in the range MINCAPACITY..MAXCAPACITY
+    static unsigned Capacity(double samples) {
+        unsigned c = MINCAPACITY;
+        while(c < MAXCAPACITY && c < samples)
+            c <<= 1;
+        return c;
+    }
+
+    /// change size of storage, content is preserved
+    void Resize(unsigned newcap) {
+        Pair *p = new Pair[newcap];
+        for(unsigned i=0; i<n; i++)
+            p[i] = at(i);
+        delete [] buf;
+        buf = p;
+        capacity = newcap;
+        head = 0;
+    }
+
+    /// full buffer: allocate more memory or drop every second sample
+    void MakeRoom() {
+        unsigned limit = Capacity(dt/SIMLIB_MinStep + 4);
+        if(capacity < limit) {
+            Resize(capacity*2);
+            return;
+        }
+        // subsampling: keep the oldest and the newest sample
+        std::rotate(buf, buf+head, buf+capacity); // buffer is full
+        head = 0;
+        unsigned j = 0;
+        for(unsigned i = 0; i<n-1; i+=2)
+            buf[j++] = buf[i];
+        buf[j++] = buf[n-1];
+        n = j;
+        cursor = 0;
+        spacing = (n>1) ? 2*(buf[n-1].time - buf[0].time)/(n-1) : 0;
+    }
+
+    /// find i: at(i).time <= time < at(i+1).time, (time >= at(0).time)
+    unsigned Search(double time) {
+        if(cursor+1 < n && at(cursor).time <= time) { // try last position
+            if(time < at(cursor+1).time)
+                return cursor;
+            if(cursor+2 < n && time < at(cursor+2).time)
+                return cursor+1;
+        }
+        unsigned lo = 0, hi = n-1; // binary search
+        while(hi-lo > 1) {
+            unsigned mid = (lo+hi)/2;
+            if(at(mid).time <= time) lo = mid;
+            else hi = mid;
+        }
+        return lo;
+    }
+
  public:
 
-    SIMLIB_DelayBuffer(): buf(), last_insert(-2,0) { /*empty*/ }
+    SIMLIB_DelayBuffer(const double &_dt):
+        dt(_dt), buf(0), capacity(0), head(0), n(0), cursor(0),
+        spacing(0), last_insert(-2,0)
+    {
+        Resize(MINCAPACITY);
+    }
+
+    virtual ~SIMLIB_DelayBuffer() { delete [] buf; }
 
     virtual void clear() {
         last_insert = Pair(-2,0); // we need it for optimization
-        buf.clear();            // empty buffer
+        head = n = cursor = 0;    // empty buffer
+        spacing = 0;
+        unsigned c = Capacity(dt/SIMLIB_MaxStep + 4);
+        if(c != capacity) {       // estimated size changed
+            delete [] buf;
+            buf = new Pair[capacity = c];
+        }
     }
 
     virtual void put(double value, double time) {
         Pair p(time,value);
 #ifndef NO_DELAY_OPTIMIZATION
-        // TODO: can be improved using interpolation
         if( last_insert == p )  // do not allow duplicate records
             return;
         last_insert = p;
 #endif
-        buf.push_back(p);       // add at buffer end
+        if(n>=2 && time - at(n-2).time < spacing) {
+            at(n-1) = p;        // subsampling: replace the newest sample
+            return;
+        }
+        if(n == capacity)
+            MakeRoom();
+        at(n++) = p;            // add at buffer end
     }
 
     virtual double get(double time) // get delayed value (with interpolation)
     {
-        // TODO: this code is EXPERIMENTAL ### (needs optimization)
-        Pair p(-1,0);
-        Pair l(-1,0);
-        std::deque<Pair>::iterator i;
-        int n; // number of records (samples) skipped
         // ASSERT: there should be at least one record in the buffer
-        for( n=0, i=buf.begin(); i!=buf.end(); ++i ) {
-            l = p;
-            p = *i;
-            n++;
-            if( p.time > time ) break;
+        if( n < 2 || time < at(0).time ) // time before first recorded sample
+            return at(0).value;          // use first buffer value as default
+        if( at(n-1).time < time )        // delay too small ###
+            SIMLIB_error(DelayTimeErr);  // TODO: ### do it better
+        unsigned i = Search(time);
+        if( i+1 == n )                   // time of the newest sample
+            return at(i).value;
+        // remove old items in buffer (rejected integration steps can go
+        // back at most MaxStep)
+        while( i > 0 && at(1).time <= time - SIMLIB_MaxStep ) {
+            head = (head+1) & (capacity-1);
+            n--;
+            i--;
         }
-        // ASSERT: n>0
-        if( n < 2 )     // we want time before first recorded sample
-            return p.value;     // use first buffer value as default
-        else {          // there are at least two samples recorded
-            if( p.time < time ) {          // delay too small ###
-                SIMLIB_error(DelayTimeErr);// TODO: ### do it better
-            }
-            // standard situation
-            const int LIMIT=2; // >=2  --- allows change of delay if bigger
-                               // WARNING: slow for bigger LIMIT
-            // remove old items in buffer
-            for(; n>LIMIT; n--)
-                buf.pop_front(); // remove front records
-            // linear interpolation
-            double dt = p.time - l.time;
-            double dy = p.value - l.value;
-            if( dt <= 0.0) { // ASSERT: dt > 0
-                SIMLIB_error(DelayTimeErr);
-            }
-            return l.value + dy*(time-l.time)/dt;
+        cursor = i;
+        // linear interpolation
+        const Pair &l = at(i);
+        const Pair &p = at(i+1);
+        double dtime = p.time - l.time;
+        double dy = p.value - l.value;
+        if( dtime <= 0.0) { // ASSERT: dtime > 0
+            SIMLIB_error(DelayTimeErr);
         }
+        return l.value + dy*(time-l.time)/dtime;
     } // get
 }; // class SIMLIB_DelayBuffer
 
@@ -179,11 +263,12 @@ Delay::Delay(Input i, double _dt, double ival) :
     aContiBlock1( i ),                  // input block-expression
     last_time( Time ),                  // last sample time
     last_value( ival ),                 // last sample value
-    buffer( new SIMLIB_DelayBuffer ),   // allocate delay buffer
+    buffer( 0 ),
     dt( _dt ),                          // Parameter: delay time
     initval( ival )                     // initial value of delay block
 {
     Dprintf(("Delay::Delay(in=%p, dt=%g, ival=%g)", &i, _dt, ival));
+    buffer = new SIMLIB_DelayBuffer(dt); // allocate delay buffer
     SIMLIB_Delay::Register( this );     // register delay in list of delays
     Init(); // initialize -- important for dynamically created delays
 }
@@ -33,6 +33,7 @@ unsigned long Entity::_Number = 0L;     // # of entity creations
 Entity::Entity(Priority_t p) :
   _Ident(SIMLIB_Entity_Count++), // unique identification
   _MarkTime(0.0),
+  _QueueKey(0),
   _SPrio(0),
   Priority(p),
   _evn(0) // pointer to calendar item
@@ -35,63 +35,78 @@ static char _Errors[] = {
 /* 21 */ "Procesis is not initialized\0"
 /* 22 */ "Bad histogram step (step<=0)\0"
 /* 23 */ "Bad histogram interval count (max=10000)\0"
-/* 24 */ "List does not have active item\0"
-/* 25 */ "Empty list\0"
-/* 26 */ "Bad queue reference\0"
-/* 27 */ "Empty WaitUntilList - can't Get() (internal error)\0"
-/* 28 */ "Bad entity reference\0"
-/* 29 */ "Entity not scheduled\0"
-/* 30 */ "Time statistic not initialized\0"
-/* 31 */ "Can't create new integrator in dynamic section\0"
-/* 32 */ "Can't destroy integrator in dynamic section\0"
-/* 33 */ "Can't create new status variable in dynamic section\0"
-/* 34 */ "Can't destroy status variable in dynamic section\0"
-/* 35 */ "Seize(): Can't interrupt facility service\0"
-/* 36 */ "Release(): Facility is released by other than currently serviced process\0"
-/* 37 */ "Release(): Can't release empty facility\0"
-/* 38 */ "Enter() request exceeded the store capacity\0"
-/* 39 */ "Leave() leaves more than currently used\0"
-/* 40 */ "SetCapacity(): can't reduce store capacity\0"
-/* 41 */ "SetQueue(): deleted (old) queue is not empty\0"
-/* 42 */ "Weibul(): lambda<=0.0 or alfa<=1.0\0"
-/* 43 */ "Erlang(): beta<1\0"
-/* 44 */ "NegBin(): q<=0 or k<=0\0"
-/* 45 */ "NegBinM(): m<=0\0"
-/* 46 */ "NegBinM(): p not in range 0..1\0"
-/* 47 */ "Poisson(lambda): lambda<=0\0"
-/* 48 */ "Geom(): q<=0\0"
-/* 49 */ "HyperGeom(): m<=0\0"
-/* 50 */ "HyperGeom(): p not in range 0..1\0"
-/* 51 */ "Can't write output file\0"
-/* 52 */ "Output file can't be open between Init() and Run()\0"
-/* 53 */ "Can't open output file\0"
-/* 54 */ "Can't close output file\0"
-/* 55 */ "Algebraic loop detected\0"
-/* 56 */ "Parameter low>=high\0"
-/* 57 */ "Parameter of quantizer <= 0\0"
-/* 58 */ "Library and header (simlib.h) version mismatch \0"
-/* 59 */ "Semaphore::V() -- bad call\0"
-/* 60 */ "Uniform(l,h) -- bad arguments\0"
-/* 61 */ "Stat::MeanValue()  No record in statistics\0"
-/* 62 */ "Stat::Disp()  Can't compute (n<2)\0"
-/* 63 */ "AlgLoop: t_min>=t_max\0"
-/* 64 */ "AlgLoop: t0 not in  <t_min,t_max>\0"
-/* 65 */ "AlgLoop: method not convergent\0"
-/* 66 */ "AlgLoop: iteration limit exceeded\0"
-/* 67 */ "AlgLoop: iterative block is not in loop\0"
-/* 68 */ "Unknown integration method\0"
-/* 69 */ "Integration method name not unique\0"
-/* 70 */ "Integration step <=0\0"
-/* 71 */ "Start-method is not single-step\0"
-/* 72 */ "Method is not multi-step\0"
-/* 73 */ "Can't switch methods in dynamic section\0"
-/* 74 */ "Can't switch start-methods in dynamic section\0"
-/* 75 */ "Rline: argument n<2\0"
-/* 76 */ "Rline: array is not sorted\0"
-/* 77 */ "Library compiled without debugging support\0"
-/* 78 */ "Dealy is too small (<=MaxStep)\0"
-/* 79 */ "Parameter can not be changed during simulation run\0"
-/* 80 */ "General error\0"
+/* 24 */ "LogHistogram: bad unit (<=0) or precision (1..16)\0"
+/* 25 */ "LogHistogram: different unit or precision\0"
+/* 26 */ "LogHistogram: bad serialized data\0"
+/* 27 */ "List does not have active item\0"
+/* 28 */ "Empty list\0"
+/* 29 */ "Bad queue reference\0"
+/* 30 */ "Empty WaitUntilList - can't Get() (internal error)\0"
+/* 31 */ "Bad entity reference\0"
+/* 32 */ "Entity not scheduled\0"
+/* 33 */ "Time statistic not initialized\0"
+/* 34 */ "Can't create new integrator in dynamic section\0"
+/* 35 */ "Can't destroy integrator in dynamic section\0"
+/* 36 */ "Can't create new status variable in dynamic section\0"
+/* 37 */ "Can't destroy status variable in dynamic section\0"
+/* 38 */ "Seize(): Can't interrupt facility service\0"
+/* 39 */ "Release(): Facility is released by other than currently serviced process\0"
+/* 40 */ "Release(): Can't release empty facility\0"
+/* 41 */ "Enter() request exceeded the store capacity\0"
+/* 42 */ "Leave() leaves more than currently used\0"
+/* 43 */ "SetCapacity(): can't reduce store capacity\0"
+/* 44 */ "SetQueue(): deleted (old) queue is not empty\0"
+/* 45 */ "MultiFacility: number of servers must be > 0\0"
+/* 46 */ "MultiFacility: server index out of range\0"
+/* 47 */ "Weibul(): lambda<=0.0 or alfa<=1.0\0"
+/* 48 */ "Erlang(): beta<1\0"
+/* 49 */ "NegBin(): q<=0 or k<=0\0"
+/* 50 */ "NegBinM(): m<=0\0"
+/* 51 */ "NegBinM(): p not in range 0..1\0"
+/* 52 */ "Poisson(lambda): lambda<=0\0"
+/* 53 */ "Geom(): q<=0\0"
+/* 54 */ "HyperGeom(): m<=0\0"
+/* 55 */ "HyperGeom(): p not in range 0..1\0"
+/* 56 */ "Binom(): n<0 or p not in range 0..1\0"
+/* 57 */ "EmpiricalDiscrete: bad weights\0"
+/* 58 */ "Can't write output file\0"
+/* 59 */ "Output file can't be open between Init() and Run()\0"
+/* 60 */ "Can't open output file\0"
+/* 61 */ "Can't close output file\0"
+/* 62 */ "Algebraic loop detected\0"
+/* 63 */ "Parameter low>=high\0"
+/* 64 */ "Parameter of quantizer <= 0\0"
+/* 65 */ "Library and header (simlib.h) version mismatch \0"
+/* 66 */ "Semaphore::V() -- bad call\0"
+/* 67 */ "Uniform(l,h) -- bad arguments\0"
+/* 68 */ "Stat::MeanValue()  No record in statistics\0"
+/* 69 */ "Stat::Disp()  Can't compute (n<2)\0"
+/* 70 */ "BatchMeans: bad parameter (dt<=0, precision<=0, level or batches)\0"
+/* 71 */ "Quantile(): quantiles not enabled (use EnableQuantiles)\0"
+/* 72 */ "Quantile(): q not in range 0..1 or no record\0"
+/* 73 */ "StatExport: can not open output file\0"
+/* 74 */ "AlgLoop: t_min>=t_max\0"
+/* 75 */ "AlgLoop: t0 not in  <t_min,t_max>\0"
+/* 76 */ "AlgLoop: method not convergent\0"
+/* 77 */ "AlgLoop: iteration limit exceeded\0"
+/* 78 */ "AlgLoop: iterative block is not in loop\0"
+/* 79 */ "AlgLoop: zero dimension of vector loop\0"
+/* 80 */ "Unknown integration method\0"
+/* 81 */ "Integration method name not unique\0"
+/* 82 */ "Integration step <=0\0"
+/* 83 */ "Start-method is not single-step\0"
+/* 84 */ "Method is not multi-step\0"
+/* 85 */ "Can't switch methods in dynamic section\0"
+/* 86 */ "Can't switch start-methods in dynamic section\0"
+/* 87 */ "Rline: argument n<2\0"
+/* 88 */ "Rline: array is not sorted\0"
+/* 89 */ "Library compiled without debugging support\0"
+/* 90 */ "Dealy is too small (<=MaxStep)\0"
+/* 91 */ "Tracer: can not open output file\0"
+/* 92 */ "Tracer: Add() after start of tracing\0"
+/* 93 */ "Parameter can not be changed during simulation run\0"
+/* 94 */ "Vector arrays have different sizes\0"
+/* 95 */ "General error\0"
 };
 
 char *_ErrMsg(enum _ErrEnum N)
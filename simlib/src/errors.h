@@ -31,63 +31,78 @@ enum _ErrEnum {
 /* 21 */ ProcessNotInitialized,
 /* 22 */ HistoStepError,
 /* 23 */ HistoCountError,
-/* 24 */ ListActivityError,
-/* 25 */ ListEmptyError,
-/* 26 */ QueueRefError,
-/* 27 */ EmptyWUListError,
-/* 28 */ EntityRefError,
-/* 29 */ EntityIsNotScheduled,
-/* 30 */ TStatNotInitialized,
-/* 31 */ CantCreateIntg,
-/* 32 */ CantDestroyIntg,
-/* 33 */ CantCreateStatus,
-/* 34 */ CantDestroyStatus,
-/* 35 */ FacInterruptError,
-/* 36 */ ReleaseError,
-/* 37 */ ReleaseNotSeized,
-/* 38 */ EnterCapError,
-/* 39 */ LeaveManyError,
-/* 40 */ SetCapacityError,
-/* 41 */ SetQueueError,
-/* 42 */ WeibullError,
-/* 43 */ ErlangError,
-/* 44 */ NegBinError,
-/* 45 */ NegBinMError1,
-/* 46 */ NegBinMError2,
-/* 47 */ PoissonError,
-/* 48 */ GeomError,
-/* 49 */ HyperGeomError1,
-/* 50 */ HyperGeomError2,
-/* 51 */ OutFilePutError,
-/* 52 */ OutFileOpenError,
-/* 53 */ CantOpenOutFile,
-/* 54 */ CantCloseOutFile,
-/* 55 */ AlgLoopDetected,
-/* 56 */ LowGreaterHigh,
-/* 57 */ BadQntzrStep,
-/* 58 */ InconsistentHeader,
-/* 59 */ SemaphoreError,
-/* 60 */ BadUniformParam,
-/* 61 */ StatNoRecError,
-/* 62 */ StatDispError,
-/* 63 */ AL_BadBounds,
-/* 64 */ AL_BadInitVal,
-/* 65 */ AL_Diverg,
-/* 66 */ AL_MaxCount,
-/* 67 */ AL_NotInLoop,
-/* 68 */ NI_UnknownMeth,
-/* 69 */ NI_MultDefMeth,
-/* 70 */ NI_IlStepSize,
-/* 71 */ NI_NotSingleStep,
-/* 72 */ NI_NotMultiStep,
-/* 73 */ NI_CantSetMethod,
-/* 74 */ NI_CantSetStarter,
-/* 75 */ RlineErr1,
-/* 76 */ RlineErr2,
-/* 77 */ NoDebugErr,
-/* 78 */ DelayTimeErr,
-/* 79 */ ParameterChangeErr,
-/* 80 */ UserError,
+/* 24 */ LogHistoParamError,
+/* 25 */ LogHistoMergeError,
+/* 26 */ LogHistoFormatError,
+/* 27 */ ListActivityError,
+/* 28 */ ListEmptyError,
+/* 29 */ QueueRefError,
+/* 30 */ EmptyWUListError,
+/* 31 */ EntityRefError,
+/* 32 */ EntityIsNotScheduled,
+/* 33 */ TStatNotInitialized,
+/* 34 */ CantCreateIntg,
+/* 35 */ CantDestroyIntg,
+/* 36 */ CantCreateStatus,
+/* 37 */ CantDestroyStatus,
+/* 38 */ FacInterruptError,
+/* 39 */ ReleaseError,
+/* 40 */ ReleaseNotSeized,
+/* 41 */ EnterCapError,
+/* 42 */ LeaveManyError,
+/* 43 */ SetCapacityError,
+/* 44 */ SetQueueError,
+/* 45 */ ServerCountError,
+/* 46 */ ServerIndexError,
+/* 47 */ WeibullError,
+/* 48 */ ErlangError,
+/* 49 */ NegBinError,
+/* 50 */ NegBinMError1,
+/* 51 */ NegBinMError2,
+/* 52 */ PoissonError,
+/* 53 */ GeomError,
+/* 54 */ HyperGeomError1,
+/* 55 */ HyperGeomError2,
+/* 56 */ BinomError,
+/* 57 */ EmpiricalError,
+/* 58 */ OutFilePutError,
+/* 59 */ OutFileOpenError,
+/* 60 */ CantOpenOutFile,
+/* 61 */ CantCloseOutFile,
+/* 62 */ AlgLoopDetected,
+/* 63 */ LowGreaterHigh,
+/* 64 */ BadQntzrStep,
+/* 65 */ InconsistentHeader,
+/* 66 */ SemaphoreError,
+/* 67 */ BadUniformParam,
+/* 68 */ StatNoRecError,
+/* 69 */ StatDispError,
+/* 70 */ BatchMeansError,
+/* 71 */ QuantileNotEnabled,
+/* 72 */ QuantileRangeError,
+/* 73 */ ExportFileError,
+/* 74 */ AL_BadBounds,
+/* 75 */ AL_BadInitVal,
+/* 76 */ AL_Diverg,
+/* 77 */ AL_MaxCount,
+/* 78 */ AL_NotInLoop,
+/* 79 */ AL_BadDimension,
+/* 80 */ NI_UnknownMeth,
+/* 81 */ NI_MultDefMeth,
+/* 82 */ NI_IlStepSize,
+/* 83 */ NI_NotSingleStep,
+/* 84 */ NI_NotMultiStep,
+/* 85 */ NI_CantSetMethod,
+/* 86 */ NI_CantSetStarter,
+/* 87 */ RlineErr1,
+/* 88 */ RlineErr2,
+/* 89 */ NoDebugErr,
+/* 90 */ DelayTimeErr,
+/* 91 */ TracerFileError,
+/* 92 */ TracerAddError,
+/* 93 */ ParameterChangeErr,
+/* 94 */ ArraySizeError,
+/* 95 */ UserError,
 };
 
 extern char *_ErrMsg(enum _ErrEnum N);
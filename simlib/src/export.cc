@@ -0,0 +1,283 @@
+/////////////////////////////////////////////////////////////////////////////
+//! \file export.cc  Machine-readable export of statistics
+//
+// Copyright (c) 2026 agent <agent@local>
+//
+// This library is licensed under GNU Library GPL. See the file COPYING.
+//
+
+//
+// description:
+//    implementation of class StatExport
+//    - JSON lines: one object per line, snapshots appended to file
+//    - whole snapshot is formatted into memory buffer and written
+//      by single fwrite() (fast enough for frequent checkpoints)
+//
+
+////////////////////////////////////////////////////////////////////////////
+// interface
+//
+
+#include "simlib.h"
+#include "internal.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
+
+////////////////////////////////////////////////////////////////////////////
+// implementation
+//
+
+namespace simlib3 {
+
+SIMLIB_IMPLEMENTATION;
+
+////////////////////////////////////////////////////////////////////////////
+// constructor --- open output file
+//
+StatExport::StatExport(const char *filename, double dt) :
+  Sampler(0, dt),
+  file(0),
+  snapshots(0)
+{
+  Dprintf(("StatExport::StatExport(\"%s\",%g)", filename, dt));
+  file = fopen(filename, "w");
+  if (!file)
+    SIMLIB_error(ExportFileError);
+  buf.reserve(1 << 16);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// destructor --- close output file
+//
+StatExport::~StatExport()
+{
+  Dprintf(("StatExport::~StatExport()"));
+  if (file)
+    fclose(file);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Add --- register object
+//
+void StatExport::Add(ItemType t, const SimObject *o)
+{
+  Item i = { t, o };
+  items.push_back(i);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Put --- append JSON string (quoted, escaped)
+//
+void StatExport::Put(const char *s)
+{
+  buf += '"';
+  for ( ; *s; s++) {
+    unsigned char c = *s;
+    if (c == '"' || c == '\\') {
+      buf += '\\';
+      buf += c;
+    } else if (c < 0x20) {
+      char e[8];
+      sprintf(e, "\\u%04x", c);
+      buf += e;
+    } else
+      buf += c;
+  }
+  buf += '"';
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Put --- append JSON number (shortest of %.15g/%.17g, which reads back
+// exactly; infinity and NaN are not JSON numbers: null)
+//
+void StatExport::Put(double x)
+{
+  if (x != x || x == HUGE_VAL || x == -HUGE_VAL) {
+    buf += "null";
+    return;
+  }
+  char s[32];
+  sprintf(s, "%.15g", x);
+  if (strtod(s, 0) != x)
+    sprintf(s, "%.17g", x);
+  buf += s;
+}
+
+void StatExport::Put(const char *key, double x)
+{
+  buf += ",\"";
+  buf += key;
+  buf += "\":";
+  Put(x);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// PutStat, PutTStat, PutQueue --- append members of JSON object
+//
+void StatExport::PutStat(const Stat &s)
+{
+  Put("n", s.Number());
+  Put("sum", s.Sum());
+  Put("sum2", s.SumSquare());
+  if (s.Number() > 0) {
+    Put("min", s.Min());
+    Put("max", s.Max());
+    Put("mean", s.MeanValue());
+  }
+  if (s.Number() > 1)
+    Put("stddev", s.StdDev());
+  if (s.Quantiles() && s.Number() > 0) {
+    Put("p50", s.Quantile(0.5));
+    Put("p90", s.Quantile(0.9));
+    Put("p99", s.Quantile(0.99));
+  }
+}
+
+void StatExport::PutTStat(const TStat &s)
+{
+  Put("n", s.Number());
+  Put("start", s.StartTime());
+  Put("sum", s.Sum());
+  Put("sum2", s.SumSquare());
+  if (s.Number() > 0) {
+    Put("min", s.Min());
+    Put("max", s.Max());
+    Put("last", s.LastValue());
+    if (Time > s.StartTime())
+      Put("mean", s.MeanValue());
+  }
+  if (s.Quantiles() && Time > s.StartTime()) {
+    Put("p50", s.Quantile(0.5));
+    Put("p90", s.Quantile(0.9));
+    Put("p99", s.Quantile(0.99));
+  }
+}
+
+void StatExport::PutQueue(const Queue &q)
+{
+  Put("length", const_cast<Queue&>(q).Length());
+  buf += ",\"len\":{\"type\":\"TStat\"";
+  PutTStat(q.StatN);
+  buf += "},\"wait\":{\"type\":\"Stat\"";
+  PutStat(q.StatDT);
+  buf += '}';
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Write --- one line for each registered object
+//
+void StatExport::Write()
+{
+  static const char *type[] = { "Stat", "TStat", "Histogram", "LogHistogram",
+    "Queue", "Facility", "Store", "MultiFacility" };
+  Dprintf(("StatExport::Write() // %u objects", unsigned(items.size())));
+  buf.clear();
+  for (unsigned k = 0; k < items.size(); k++) {
+    const SimObject *o = items[k].obj;
+    buf += "{\"snapshot\":";
+    Put(snapshots);
+    Put("time", Time);
+    buf += ",\"type\":";
+    Put(type[items[k].type]);
+    buf += ",\"name\":";
+    Put(o->Name());
+    switch (items[k].type) {
+      case STAT:
+        PutStat(*static_cast<const Stat*>(o));
+        break;
+      case TSTAT:
+        PutTStat(*static_cast<const TStat*>(o));
+        break;
+      case HISTOGRAM: {
+        const Histogram &h = *static_cast<const Histogram*>(o);
+        Put("low", h.Low());
+        Put("step", h.Step());
+        buf += ",\"counts\":[";     // underflow, count intervals, overflow
+        for (unsigned i = 0; i <= h.Count() + 1; i++) {
+          if (i) buf += ',';
+          Put(h[i]);
+        }
+        buf += "],\"stat\":{\"type\":\"Stat\"";
+        PutStat(h.stat);
+        buf += '}';
+        break;
+      }
+      case LOGHISTOGRAM: {
+        const LogHistogram &h = *static_cast<const LogHistogram*>(o);
+        Put("unit", h.Unit());
+        Put("precision", h.Precision());
+        Put("n", h.Number());
+        if (h.Number() > 0) {
+          Put("min", h.Min());
+          Put("max", h.Max());
+          Put("mean", h.MeanValue());
+          Put("p50", h.Quantile(0.5));
+          Put("p90", h.Quantile(0.9));
+          Put("p99", h.Quantile(0.99));
+          Put("p999", h.Quantile(0.999));
+        }
+        break;
+      }
+      case QUEUE:
+        PutQueue(*static_cast<const Queue*>(o));
+        break;
+      case FACILITY: {
+        const Facility &f = *static_cast<const Facility*>(o);
+        Put("busy", f.Busy());
+        buf += ",\"util\":{\"type\":\"TStat\"";
+        PutTStat(f.tstat);
+        buf += "},\"queue\":{\"type\":\"Queue\"";
+        PutQueue(*f.Q1);
+        buf += '}';
+        break;
+      }
+      case STORE: {
+        const Store &s = *static_cast<const Store*>(o);
+        Put("capacity", s.Capacity());
+        Put("used", s.Used());
+        buf += ",\"usage\":{\"type\":\"TStat\"";
+        PutTStat(s.tstat);
+        buf += "},\"queue\":{\"type\":\"Queue\"";
+        PutQueue(*s.Q);
+        buf += '}';
+        break;
+      }
+      case MULTIFACILITY: {
+        const MultiFacility &f = *static_cast<const MultiFacility*>(o);
+        Put("servers", f.Size());
+        Put("used", f.Used());
+        buf += ",\"usage\":{\"type\":\"TStat\"";
+        PutTStat(f.tstat);
+        buf += "},\"queue\":{\"type\":\"Queue\"";
+        PutQueue(*f.Q);
+        buf += '}';
+        break;
+      }
+    }
+    buf += "}\n";
+  }
+  fwrite(buf.data(), 1, buf.size(), file);      // single write
+  fflush(file);
+  snapshots++;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Behavior --- periodic snapshot (not at dt=0)
+//
+void StatExport::Behavior()
+{
+  Dprintf(("StatExport::Behavior()"));
+  Sample();
+  if (on && step > 0.0) {
+    Write();
+    Activate(Time + step);      // schedule next snapshot
+  } else
+    Passivate();
+}
+
+} // namespace
+
+// end of export.cc
@@ -205,39 +205,8 @@ void Facility::QueueIn(Entity * e, ServicePriority_t sp)
     Dprintf((" %s --> Q1 of %s ", e->Name(), Name()));
     CHECKENTITY(e);
     e->_SPrio = sp;
-#if  0                          // _INS_FROM_BEGIN_SLOWER
-    Queue::iterator p = Q1->begin();
-    Queue::iterator end = Q1->end();
-    ServicePriority_t Sprio = e->_SPrio;
-    for (; p != end && static_cast<Entity *>(*p)->_SPrio > Sprio;       // higher service priority first
-         ++p);
-    ServicePriority_t prio = e->Priority;
-    for (; p != end && static_cast<Entity *>(*p)->_SPrio == Sprio && static_cast<Entity *>(*p)->Priority >= prio;       // higher priority first
-         ++p);
-#else
-    Queue::iterator begin = Q1->begin();
-    Queue::iterator p = Q1->end();
-    ServicePriority_t Sprio = e->_SPrio;
-    while (p != begin) {
-        Queue::iterator q = p;
-        --p;
-        if (static_cast<Entity *>(*p)->_SPrio >= Sprio) {       // higher service priority first
-            p = q;
-            break;
-        }
-    }
-    ServicePriority_t prio = e->Priority;
-    while (p != begin) {
-        Queue::iterator q = p;
-        --p;
-        if (static_cast<Entity *>(*p)->_SPrio > Sprio ||
-            static_cast<Entity *>(*p)->Priority >= prio) { // higher priority first
-            p = q;
-            break;
-        }
-    }
-#endif
-    Q1->PredIns(e, p);
+    // higher service priority first, then higher priority first
+    Q1->SortedIns(e, Queue::BY_SERVICE_PRIORITY);
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -246,18 +215,9 @@ void Facility::QueueIn(Entity * e, ServicePriority_t sp)
 void Facility::QueueIn2(Entity * e)
 {
     Dprintf((" %s --> Q2 of %s", e->Name(), Name()));
-    ServicePriority_t ps = e->_SPrio;
-    Queue::iterator p = Q2->begin();
-    for (; p != Q2->end()
-            && static_cast<Entity *>(*p)->_SPrio > ps;    // higher service priority first
-         ++p) { /*empty*/ }
-    ServicePriority_t prio = e->Priority;
-    for (; p != Q2->end()
-            && static_cast<Entity *>(*p)->_SPrio == ps
-            && static_cast<Entity *>(*p)->Priority >= prio;    // higher priority first
-         ++p) { /*empty*/ }
+    // higher service priority first, then higher priority first
     // next sorting -- _RestTime????###
-    Q2->PredIns(e, p);
+    Q2->SortedIns(e, Queue::BY_SERVICE_PRIORITY);
 }
 
 ////////////////////////////////////////////////////////////////////////////
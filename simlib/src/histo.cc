@@ -17,6 +17,9 @@
 #include "simlib.h"
 #include "internal.h"
 
+#include <cmath>
+#include <cstring>
+
 ////////////////////////////////////////////////////////////////////////////
 // implementation
 //
@@ -148,6 +151,363 @@ void Histogram::Clear()
   stat.Clear();
 }
 
+
+////////////////////////////////////////////////////////////////////////////
+// LogHistogram
+//
+
+typedef unsigned long long u64;
+
+// atomic operations (relaxed ordering, counters only)
+#ifdef __GNUC__
+#define ATOMIC_ADD(p,v)  __atomic_fetch_add((p), (v), __ATOMIC_RELAXED)
+#else
+#define ATOMIC_ADD(p,v)  (*(p) += (v))
+#endif
+
+static void AtomicAdd(double *p, double x)
+{
+#ifdef __GNUC__
+  double old, nw;
+  __atomic_load(p, &old, __ATOMIC_RELAXED);
+  do nw = old + x;
+  while (!__atomic_compare_exchange(p, &old, &nw, true,
+                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+#else
+  *p += x;
+#endif
+}
+
+// update *p = x if x<*p (less) or x>*p (!less)
+static void AtomicMinMax(double *p, double x, bool less)
+{
+#ifdef __GNUC__
+  double old;
+  __atomic_load(p, &old, __ATOMIC_RELAXED);
+  while ((less ? x < old : x > old) &&
+         !__atomic_compare_exchange(p, &old, &x, true,
+                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    { /*empty*/ }
+#else
+  if (less ? x < *p : x > *p) *p = x;
+#endif
+}
+
+// index of the highest nonzero bit of v (v!=0)
+static inline unsigned HighBit(u64 v)
+{
+#ifdef __GNUC__
+  return 63 - __builtin_clzll(v);
+#else
+  unsigned e = 0;
+  while (v >>= 1) e++;
+  return e;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  constructors
+//
+LogHistogram::LogHistogram(double u, unsigned p) :
+  blocks(0)
+{
+  Dprintf(("LogHistogram::LogHistogram(%g,%u)", u, p));
+  Init(u, p);
+}
+
+LogHistogram::LogHistogram(const char *name, double u, unsigned p) :
+  blocks(0)
+{
+  Dprintf(("LogHistogram::LogHistogram(\"%s\",%g,%u)", name, u, p));
+  SetName(name);
+  Init(u, p);
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  destructor
+//
+LogHistogram::~LogHistogram()
+{
+  Dprintf(("LogHistogram::~LogHistogram() // \"%s\" ", Name()));
+  for (unsigned k = 0; k < 2*nblocks; k++)
+    delete [] blocks[k];
+  delete [] blocks;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  Init --- set unit and precision, free all buckets
+//
+void LogHistogram::Init(double u, unsigned p)
+{
+  if (!(u > 0) || p < 1 || p > 16)
+    SIMLIB_error(LogHistoParamError);
+  if (blocks) {
+    for (unsigned k = 0; k < 2*nblocks; k++)
+      delete [] blocks[k];
+    delete [] blocks;
+  }
+  unit = u;
+  runit = 1/u;
+  prec = p;
+  nblocks = 65 - p;          // linear block + 64-p exponents
+  blocks = new unsigned long*[2*nblocks];
+  for (unsigned k = 0; k < 2*nblocks; k++)
+    blocks[k] = 0;
+  Clear();
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  Block --- sub-buckets of block k (allocated on first use)
+//
+unsigned long *LogHistogram::Block(unsigned k) const
+{
+  unsigned long *b;
+#ifdef __GNUC__
+  b = __atomic_load_n(&blocks[k], __ATOMIC_ACQUIRE);
+  if (!b) {
+    unsigned long *nb = new unsigned long[1u << prec]();
+    if (__atomic_compare_exchange_n(&blocks[k], &b, nb, false,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+      b = nb;
+    else
+      delete [] nb;          // allocated by other thread
+  }
+#else
+  b = blocks[k];
+  if (!b)
+    b = blocks[k] = new unsigned long[1u << prec]();
+#endif
+  return b;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  Bound --- low bound of |x| in sub-bucket i of block b
+//
+double LogHistogram::Bound(unsigned b, unsigned long i) const
+{
+  if (b == 0)
+    return i * unit;
+  return ldexp(double((1ul << prec) + i), b - 1) * unit;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  operator () --- record value
+//
+void LogHistogram::operator () (double x)
+{
+  double a = (x < 0 ? -x : x) * runit;
+  u64 v = a < 18446744073709551615.0 ? u64(a) : ~u64(0); // saturate
+  unsigned b;
+  unsigned long i;
+  if (v < (u64(1) << prec)) {         // linear part
+    b = 0;
+    i = (unsigned long)v;
+  } else {                            // 2^prec sub-buckets of 2^e..2^(e+1)
+    unsigned e = HighBit(v);
+    b = e - prec + 1;
+    i = (unsigned long)(v >> (e - prec)) - (1ul << prec);
+  }
+  ATOMIC_ADD(&Block((x < 0 ? 0 : nblocks) + b)[i], 1ul);
+  ATOMIC_ADD(&n, 1ul);
+  AtomicMinMax(&min, x, true);
+  AtomicMinMax(&max, x, false);
+  AtomicAdd(&sum, x);
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  Merge --- add records of histogram with the same unit and precision
+//
+void LogHistogram::Merge(const LogHistogram &h)
+{
+  if (h.unit != unit || h.prec != prec)
+    SIMLIB_error(LogHistoMergeError);
+  unsigned long hn = h.n;
+  if (hn == 0)
+    return;
+  const unsigned m = 1u << prec;
+  for (unsigned k = 0; k < 2*nblocks; k++) {
+    const unsigned long *hb = h.blocks[k];
+    if (!hb)
+      continue;
+    unsigned long *b = Block(k);
+    for (unsigned i = 0; i < m; i++)
+      if (hb[i])
+        ATOMIC_ADD(&b[i], hb[i]);
+  }
+  double hmin = h.min, hmax = h.max, hsum = h.sum;
+  ATOMIC_ADD(&n, hn);
+  AtomicMinMax(&min, hmin, true);
+  AtomicMinMax(&max, hmax, false);
+  AtomicAdd(&sum, hsum);
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  Clear --- zero all buckets
+//
+void LogHistogram::Clear()
+{
+  Dprintf(("LogHistogram::Clear()"));
+  for (unsigned k = 0; k < 2*nblocks; k++)
+    if (blocks[k])
+      for (unsigned i = 0; i < (1u << prec); i++)
+        blocks[k][i] = 0;
+  n = 0;
+  sum = 0;
+  min = HUGE_VAL;            // no record
+  max = -HUGE_VAL;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  MeanValue
+//
+double LogHistogram::MeanValue() const
+{
+  if (n == 0) SIMLIB_error(StatNoRecError);
+  return sum / n;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  Quantile --- midpoint of bucket containing q-quantile
+//
+double LogHistogram::Quantile(double q) const
+{
+  if (q < 0 || q > 1 || n == 0)
+    SIMLIB_error(QuantileRangeError);
+  const unsigned m = 1u << prec;
+  double rank = ceil(q * n);
+  if (rank < 1) rank = 1;
+  double cum = 0;
+  double x = max;
+  for (int k = 0; k < int(2*nblocks); k++) {
+    // negative values from the most negative, then positive ones
+    bool neg = k < int(nblocks);
+    unsigned b = neg ? nblocks - 1 - k : k - nblocks;
+    const unsigned long *bp = blocks[neg ? b : nblocks + b];
+    if (!bp)
+      continue;
+    for (unsigned j = 0; j < m; j++) {
+      unsigned i = neg ? m - 1 - j : j;
+      cum += bp[i];
+      if (bp[i] && cum >= rank) {
+        x = (Bound(b, i) + Bound(b, i + 1)) / 2;
+        if (neg) x = -x;
+        k = 2*nblocks;       // stop
+        break;
+      }
+    }
+  }
+  if (x < min) x = min;
+  if (x > max) x = max;
+  return x;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  serialization
+//  format: "LH1", precision (1 byte), unit, n, sum, min, max,
+//  for negative and positive values: pairs (index distance, count)
+//  of nonzero buckets, terminated by 0; numbers are stored as variable
+//  length integers (7 bits per byte), doubles as 8 bytes little endian
+//
+static void PutVar(std::string &s, u64 v)
+{
+  while (v >= 0x80) {
+    s += char((v & 0x7f) | 0x80);
+    v >>= 7;
+  }
+  s += char(v);
+}
+
+static void PutDouble(std::string &s, double d)
+{
+  u64 v;
+  memcpy(&v, &d, sizeof(v));
+  for (int i = 0; i < 8; i++, v >>= 8)
+    s += char(v & 0xff);
+}
+
+static u64 GetVar(const std::string &s, size_t &pos)
+{
+  u64 v = 0;
+  for (unsigned shift = 0; ; shift += 7) {
+    if (pos >= s.size() || shift > 63)
+      SIMLIB_error(LogHistoFormatError);
+    unsigned char c = s[pos++];
+    v |= u64(c & 0x7f) << shift;
+    if (!(c & 0x80))
+      return v;
+  }
+}
+
+static double GetDouble(const std::string &s, size_t &pos)
+{
+  if (pos + 8 > s.size())
+    SIMLIB_error(LogHistoFormatError);
+  u64 v = 0;
+  for (int i = 7; i >= 0; i--)
+    v = (v << 8) | (unsigned char)s[pos + i];
+  pos += 8;
+  double d;
+  memcpy(&d, &v, sizeof(d));
+  return d;
+}
+
+std::string LogHistogram::Serialize() const
+{
+  std::string s("LH1");
+  s += char(prec);
+  PutDouble(s, unit);
+  PutVar(s, n);
+  PutDouble(s, sum);
+  PutDouble(s, min);
+  PutDouble(s, max);
+  const unsigned m = 1u << prec;
+  for (unsigned sign = 0; sign < 2; sign++) {
+    u64 last = 0;                      // index+1 of last nonzero bucket
+    for (unsigned b = 0; b < nblocks; b++) {
+      const unsigned long *bp = blocks[sign * nblocks + b];
+      if (!bp)
+        continue;
+      for (unsigned i = 0; i < m; i++)
+        if (bp[i]) {
+          u64 idx = u64(b) * m + i + 1;
+          PutVar(s, idx - last);
+          PutVar(s, bp[i]);
+          last = idx;
+        }
+    }
+    PutVar(s, 0);
+  }
+  return s;
+}
+
+void LogHistogram::Deserialize(const std::string &s)
+{
+  if (s.size() < 4 || s.compare(0, 3, "LH1") != 0)
+    SIMLIB_error(LogHistoFormatError);
+  size_t pos = 3;
+  unsigned p = (unsigned char)s[pos++];
+  double u = GetDouble(s, pos);
+  if (p != prec || u != unit)
+    Init(u, p);                       // use unit and precision of data
+  else
+    Clear();
+  n = GetVar(s, pos);
+  sum = GetDouble(s, pos);
+  min = GetDouble(s, pos);
+  max = GetDouble(s, pos);
+  const unsigned m = 1u << prec;
+  for (unsigned sign = 0; sign < 2; sign++) {
+    u64 idx = 0;
+    for (u64 d; (d = GetVar(s, pos)) != 0; ) {
+      idx += d;
+      if (idx > u64(nblocks) * m)
+        SIMLIB_error(LogHistoFormatError);
+      unsigned b = unsigned((idx - 1) / m);
+      Block(sign * nblocks + b)[(idx - 1) % m] = GetVar(s, pos);
+    }
+  }
+}
+
 }
 // end
 
@@ -192,6 +192,7 @@ extern int SIMLIB_ERRNO;                    // error number
 extern bool SIMLIB_ConditionFlag;           // change of condition vector
 extern bool SIMLIB_ContractStepFlag;        // requests shorter step
 extern double SIMLIB_ContractStep;          // requested step size
+extern unsigned long SIMLIB_EvalCount;      // # of model evaluations
 
 extern double SIMLIB_StepStartTime;         // last step time
 extern double SIMLIB_DeltaTime;             // Time-s_StepStartTime
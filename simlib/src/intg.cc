@@ -18,6 +18,7 @@
 
 #include "simlib.h"
 #include "internal.h"
+#include "multirate.h"
 
 #include <cmath>
 
@@ -57,6 +58,7 @@ bool SIMLIB_DynamicFlag = false;          //!< in dynamic section
 
 bool SIMLIB_ContractStepFlag = false;     //!< requests shorter step
 double  SIMLIB_ContractStep = SIMLIB_MAXTIME;    //!< requested step size
+unsigned long SIMLIB_EvalCount = 0;       //!< changes at each model evaluation
 
 
 ////////////////////////////////////////////////////////////////////////////
@@ -214,6 +216,8 @@ Integrator::~Integrator()
     SIMLIB_error(CantDestroyIntg);  // can't in 'dynamic section' !!!
   }
   IntegratorContainer::Erase(it_list);  // remove integrator from list
+  for(unsigned k=0; k<Subsystem::Count(); k++)
+    Subsystem::Get(k)->Remove(*this);   // no dangling pointer in subsystem
 }
 
 
@@ -261,12 +265,85 @@ const char *Integrator::Name() const
         return SIMLIB_create_tmp_name("Integrator{%p}", this);
 }
 
+/*************************************************/
+/*****  Outline members of aIntegratorArray  *****/
+/*************************************************/
+
+
+////////////////////////////////////////////////////////////////////////////
+/// constructor: empty array, derived class provides state arrays (Bind)
+aIntegratorArray::aIntegratorArray() :
+  registered(false), n(0), ss(0), ssl(0), dd(0), ddl(0)
+{
+  Dprintf(("aIntegratorArray[%p]::aIntegratorArray()", this));
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// set state arrays (n elements each) and insert array into container
+void aIntegratorArray::Bind(size_t size, double *s, double *sl,
+                            double *d, double *dl)
+{
+  Dprintf(("aIntegratorArray[%p]::Bind(%lu)", this, (long unsigned)size));
+  if(SIMLIB_DynamicFlag) {
+    SIMLIB_error(CantCreateIntg);  // can't in 'dynamic section' !!!
+  }
+  if(registered)
+    IntegratorContainer::Erase(it_list, n);
+  n = size;
+  ss = s;  ssl = sl;
+  dd = d;  ddl = dl;
+  it_list = IntegratorContainer::Insert(this);
+  registered = true;
+  SIMLIB_ResetStatus = true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// destructor removes array from container
+aIntegratorArray::~aIntegratorArray()
+{
+  Dprintf(("destructor: aIntegratorArray[%p]", this));
+  if(SIMLIB_DynamicFlag) {
+    SIMLIB_error(CantDestroyIntg);  // can't in 'dynamic section' !!!
+  }
+  if(registered)
+    IntegratorContainer::Erase(it_list, n);
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// save status of all elements (now -> last)
+void aIntegratorArray::Save(void)
+{
+  for(size_t i=0; i<n; i++) {
+    ssl[i] = ss[i];
+    ddl[i] = dd[i];
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// restore saved status of all elements (last -> now)
+void aIntegratorArray::Restore(void)
+{
+  for(size_t i=0; i<n; i++) {
+    ss[i] = ssl[i];
+    dd[i] = ddl[i];
+  }
+}
+
+
 /**********************************************************/
 /*****  Outline members of class IntegratorContainer  *****/
 /**********************************************************/
 
 /// list of integrators
 std::list<Integrator*>* IntegratorContainer::ListPtr=NULL;
+/// list of arrays of integrators
+std::list<aIntegratorArray*>* IntegratorContainer::ArrayListPtr=NULL;
+/// number of states in all arrays
+size_t IntegratorContainer::ArrayStates=0;
 
 ////////////////////////////////////////////////////////////////////////////
 //  IntegratorContainer::Instance
@@ -283,6 +360,18 @@ std::list<Integrator*>* IntegratorContainer::Instance(void)
 } // Instance
 
 
+////////////////////////////////////////////////////////////////////////////
+//  IntegratorContainer::ArrayInstance
+//  return pointer to list of arrays, also create list if it is not created
+//
+std::list<aIntegratorArray*>* IntegratorContainer::ArrayInstance(void)
+{
+  if(ArrayListPtr==NULL)  // list is not created
+    ArrayListPtr = new std::list<aIntegratorArray*>;
+  return ArrayListPtr;
+} // ArrayInstance
+
+
 ////////////////////////////////////////////////////////////////////////////
 //  IntegratorContainer::Insert
 //  insert element into random (any) position in the container
@@ -307,6 +396,33 @@ void IntegratorContainer::Erase(IntegratorContainer::iterator it)
 } // Erase
 
 
+////////////////////////////////////////////////////////////////////////////
+//  IntegratorContainer::Insert -- insert array of integrators
+//
+IntegratorContainer::array_iterator
+IntegratorContainer::Insert(aIntegratorArray* ptr)
+{
+  Dprintf(("IntegratorContainer::Insert(array %p)",ptr));
+  (void)ArrayInstance();  // create list if it is not created
+  ArrayStates += ptr->n;
+  return ArrayListPtr->insert(ArrayListPtr->end(),ptr);
+} // Insert
+
+
+////////////////////////////////////////////////////////////////////////////
+//  IntegratorContainer::Erase - exclude array with n states
+//
+void IntegratorContainer::Erase(IntegratorContainer::array_iterator it,
+                                size_t n)
+{
+  Dprintf(("IntegratorContainer::Erase(array)"));
+  if(ArrayListPtr!=NULL) {  // list is created
+    ArrayListPtr->erase(it);  // exclude element
+    ArrayStates -= n;
+  }
+} // Erase
+
+
 ////////////////////////////////////////////////////////////////////////////
 //  IntegratorContainer::NtoL
 //  save statuses of blocks -- Now to Last
@@ -320,6 +436,11 @@ void IntegratorContainer::NtoL()
       (*ip)->Save();
     }
   }
+  if(ArrayListPtr!=NULL) {
+    array_iterator end_it=ArrayListPtr->end();
+    for(array_iterator ap=ArrayListPtr->begin(); ap!=end_it; ap++)
+      (*ap)->Save();
+  }
 } // NtoL
 
 
@@ -335,6 +456,11 @@ void IntegratorContainer::LtoN()
       (*ip)->Restore();
     }
   }
+  if(ArrayListPtr!=NULL) {
+    array_iterator end_it=ArrayListPtr->end();
+    for(array_iterator ap=ArrayListPtr->begin(); ap!=end_it; ap++)
+      (*ap)->Restore();
+  }
 } // LtoN
 
 
@@ -352,6 +478,15 @@ void IntegratorContainer::InitAll()
       (*ip)->Init();
     }
   }
+  if(ArrayListPtr!=NULL) {
+    array_iterator end_it=ArrayListPtr->end();
+    for(array_iterator ap=ArrayListPtr->begin(); ap!=end_it; ap++) {
+      aIntegratorArray *a = *ap;
+      for(size_t i=0; i<a->n; i++)
+        a->ss[i] = a->dd[i] = 0.0;  // zero values
+      a->Init();
+    }
+  }
 } // InitAll
 
 
@@ -367,6 +502,11 @@ void IntegratorContainer::EvaluateAll()
       (*ip)->Eval();  // evaluate inputs ...
     }
   }
+  if(ArrayListPtr!=NULL) {
+    array_iterator end_it=ArrayListPtr->end();
+    for(array_iterator ap=ArrayListPtr->begin(); ap!=end_it; ap++)
+      (*ap)->Eval();  // all derivatives of array
+  }
 } // EvaluateAll
 
 
@@ -585,6 +725,7 @@ void StatusContainer::EvaluateAll()
 void StatusContainer::ClearAllValueOK()
 {
   Dprintf(("StatusContainer::EvaluateAll)"));
+  ++SIMLIB_EvalCount;  // new evaluation: cached block values are invalid
   if(ListPtr!=NULL) {  // list is created
     iterator end_it=ListPtr->end();
     for(iterator sp=ListPtr->begin(); sp!=end_it; sp++) {
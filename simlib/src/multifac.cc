@@ -0,0 +1,348 @@
+/////////////////////////////////////////////////////////////////////////////
+//! \file multifac.cc  Implementation of MultiFacility
+//
+// Copyright (c) 2026 agent <agent@local>
+//
+// This library is licensed under GNU Library GPL. See the file COPYING.
+//
+
+//
+//  class MultiFacility implementation
+//  (N servers, shared input queue, bitmap of free servers)
+//
+
+////////////////////////////////////////////////////////////////////////////
+//  interface
+//
+
+#include "simlib.h"
+#include "internal.h"
+
+
+////////////////////////////////////////////////////////////////////////////
+//  implementation
+//
+
+namespace simlib3 {
+
+SIMLIB_IMPLEMENTATION;
+
+#define _OWNQ 0x01
+
+#define CHECKQUEUE(qptr)    if (!qptr) SIMLIB_error(QueueRefError)
+#define CHECKENTITY(fptr)   if (!fptr) SIMLIB_error(EntityRefError)
+
+static const unsigned BITS = 8 * sizeof(unsigned long); // bits in word
+
+////////////////////////////////////////////////////////////////////////////
+// LowBit --- index of the lowest nonzero bit of x (x!=0)
+//
+static inline unsigned LowBit(unsigned long x)
+{
+#ifdef __GNUC__
+  return __builtin_ctzl(x);
+#else
+  unsigned i = 0;
+  for( ; !(x & 1); x >>= 1)
+    i++;
+  return i;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  constructors
+//
+MultiFacility::MultiFacility(unsigned _n, Policy p) :
+  _Qflag(_OWNQ),
+  policy(p),
+  Q(new Queue("Q"))
+{
+  Dprintf(("MultiFacility::MultiFacility(%u)", _n));
+  Init(_n);
+}
+
+MultiFacility::MultiFacility(const char *name, unsigned _n, Policy p) :
+  _Qflag(_OWNQ),
+  policy(p),
+  Q(new Queue("Q"))
+{
+  Dprintf(("MultiFacility::MultiFacility(\"%s\",%u)", name, _n));
+  SetName(name);
+  Init(_n);
+}
+
+MultiFacility::MultiFacility(const char *name, unsigned _n, Queue *queue,
+                             Policy p) :
+  _Qflag(0),
+  policy(p),
+  Q(queue)
+{
+  CHECKQUEUE(queue);
+  Dprintf(("MultiFacility::MultiFacility(\"%s\",%u,%s)",
+           name, _n, queue->Name()));
+  SetName(name);
+  Init(_n);
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  destructor
+//
+MultiFacility::~MultiFacility()
+{
+  Dprintf(("MultiFacility::~MultiFacility()  // \"%s\" ", Name()));
+  Clear();
+  if (OwnQueue())
+    delete Q;
+  delete [] stat;
+  delete [] in;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Init --- allocate servers (all free)
+//
+void MultiFacility::Init(unsigned _n)
+{
+  if (_n == 0)
+    SIMLIB_error(ServerCountError);
+  n = _n;
+  in = new Entity*[n];
+  stat = new TStat[n];
+  freemap.resize((n + BITS - 1) / BITS);
+  summary.resize((freemap.size() + BITS - 1) / BITS);
+  Clear();
+}
+
+////////////////////////////////////////////////////////////////////////////
+// SetFree, SetBusy --- update bitmap of free servers
+//
+void MultiFacility::SetFree(unsigned i)
+{
+  unsigned w = i / BITS;
+  freemap[w] |= 1UL << (i % BITS);
+  summary[w / BITS] |= 1UL << (w % BITS);
+  if (policy == LEAST_UTILIZED)
+    idle.insert(std::make_pair(stat[i].Sum(), i));
+}
+
+void MultiFacility::SetBusy(unsigned i)
+{
+  unsigned w = i / BITS;
+  freemap[w] &= ~(1UL << (i % BITS));
+  if (freemap[w] == 0)
+    summary[w / BITS] &= ~(1UL << (w % BITS));
+  if (policy == LEAST_UTILIZED)
+    idle.erase(std::make_pair(stat[i].Sum(), i));
+}
+
+////////////////////////////////////////////////////////////////////////////
+// FindFree --- the first free server with index >= from, n if none
+//
+unsigned MultiFacility::FindFree(unsigned from) const
+{
+  if (from >= n)
+    return n;
+  unsigned w = from / BITS;
+  unsigned long m = freemap[w] & (~0UL << (from % BITS));
+  if (m)
+    return w * BITS + LowBit(m);
+  // next nonzero word of freemap using summary
+  for (unsigned b = w + 1; b < freemap.size(); b = (b / BITS + 1) * BITS) {
+    unsigned long s = summary[b / BITS] & (~0UL << (b % BITS));
+    if (s) {
+      w = (b / BITS) * BITS + LowBit(s);
+      return w * BITS + LowBit(freemap[w]);
+    }
+  }
+  return n;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Select --- free server by policy (some server is free)
+//
+unsigned MultiFacility::Select()
+{
+  unsigned i;
+  switch (policy) {
+    case ROUND_ROBIN:
+      i = FindFree(next);
+      if (i == n)
+        i = FindFree(0);        // wrap around
+      next = i + 1;
+      break;
+    case LEAST_UTILIZED:
+      i = idle.begin()->second; // least busy time, lowest index
+      break;
+    default:
+      i = FindFree(0);
+      break;
+  }
+  return i;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Assign --- start service of entity e at server i
+//
+void MultiFacility::Assign(unsigned i, Entity *e)
+{
+  Dprintf(("%s.Seize(%s) server %u", Name(), e->Name(), i));
+  SetBusy(i);
+  in[i] = e;
+  e->_RequiredCapacity = i;     // server index, see Release
+  used++;
+  tstat(used);                  // update statistics
+  stat[i](1);
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// Seize
+/// - seize a free server or wait in input queue
+/// - returns the index of server
+unsigned MultiFacility::Seize(Entity *e, ServicePriority_t sp)
+{
+  Dprintf(("%s.Seize(%s,%u)", Name(), e->Name(), (unsigned) sp));
+  CHECKENTITY(e);
+  if (e != Current)
+    SIMLIB_error(EntityRefError);
+  if (!Full()) {
+    unsigned i = Select();
+    Assign(i, e);
+    return i;
+  }
+  QueueIn(e, sp);               // insert in priority queue
+  e->Passivate();               // wait in queue, activated by Release()
+  // =======================================================
+  // continue after activation: server is already assigned
+  Dprintf(("%s.Seize(%s,%u) from Q", Name(), e->Name(), (unsigned) sp));
+  return unsigned(e->_RequiredCapacity);
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// Release
+/// - release server used by entity e
+/// - the first entity in queue gets a server
+void MultiFacility::Release(Entity *e)
+{
+  Dprintf(("%s.Release(%s)", Name(), e->Name()));
+  CHECKENTITY(e);
+  if (used == 0)
+    SIMLIB_error(ReleaseNotSeized);     // not seized
+  unsigned i = unsigned(e->_RequiredCapacity);
+  if (e->_RequiredCapacity >= n || in[i] != e) {
+    // index overwritten (entity uses other Store/MultiFacility)
+    for (i = 0; i < n && in[i] != e; i++) { /*empty*/ }
+    if (i == n)
+      SIMLIB_error(ReleaseError);       // seized by other entity
+  }
+  in[i] = NULL;
+  stat[i](0);
+  stat[i].n--;                  // correction !!
+  used--;
+  tstat(used);
+  tstat.n--;                    // correction !!
+  SetFree(i);
+  if (!Q->empty()) {            // input queue not empty
+    Entity *ent = Q->front();   // points to first entity in queue
+    ent->Out();                 // remove from queue
+    Assign(Select(), ent);
+    ent->Activate();            // activation of entity behavior
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// QueueIn
+/// - insert entity into priority queue
+void MultiFacility::QueueIn(Entity *e, ServicePriority_t sp)
+{
+  Dprintf((" %s --> Q of %s ", e->Name(), Name()));
+  CHECKENTITY(e);
+  e->_SPrio = sp;
+  // higher service priority first, then higher priority first
+  Q->SortedIns(e, Queue::BY_SERVICE_PRIORITY);
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// SetQueue
+/// - use another queue
+void MultiFacility::SetQueue(Queue *queue)
+{
+  CHECKQUEUE(queue);
+  if (OwnQueue()) {
+    if (QueueLen() > 0)
+      SIMLIB_warning(SetQueueError);
+    delete Q;                   // delete internal queue
+    _Qflag &= ~_OWNQ;
+  }
+  Q = queue;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// SetPolicy
+/// - change server selection policy
+void MultiFacility::SetPolicy(Policy p)
+{
+  if (p == policy)
+    return;
+  policy = p;
+  idle.clear();
+  if (policy == LEAST_UTILIZED)
+    for (unsigned i = FindFree(0); i < n; i = FindFree(i + 1))
+      idle.insert(std::make_pair(stat[i].Sum(), i));
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// Busy, In, ServerStat
+/// - state of server i
+bool MultiFacility::Busy(unsigned i) const
+{
+  return In(i) != NULL;
+}
+
+Entity *MultiFacility::In(unsigned i) const
+{
+  if (i >= n)
+    SIMLIB_error(ServerIndexError);
+  return in[i];
+}
+
+const TStat &MultiFacility::ServerStat(unsigned i) const
+{
+  if (i >= n)
+    SIMLIB_error(ServerIndexError);
+  return stat[i];
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// Clear
+/// - initialization: all servers free
+void MultiFacility::Clear()
+{
+  Dprintf(("%s.Clear()", Name()));
+  // initialize only own queue
+  if (OwnQueue())
+    Q->Clear();
+  tstat.Clear();
+  used = 0;
+  next = 0;
+  idle.clear();
+  for (unsigned w = 0; w < freemap.size(); w++)
+    freemap[w] = 0;
+  for (unsigned w = 0; w < summary.size(); w++)
+    summary[w] = 0;
+  for (unsigned i = 0; i < n; i++) {
+    in[i] = NULL;
+    stat[i].Clear();
+    SetFree(i);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// OwnQueue
+/// - check if facility owns queue
+bool MultiFacility::OwnQueue() const
+{
+  return (_Qflag & _OWNQ) != 0;
+}
+
+} // namespace
+
+// end of multifac.cc
@@ -0,0 +1,155 @@
+/////////////////////////////////////////////////////////////////////////////
+//! \file multirate.cc  Multirate integration --- subsystems
+//
+// Copyright (c) 2026 agent <agent@local>
+//
+// This library is licensed under GNU Library GPL. See the file COPYING.
+//
+
+//
+//  class Subsystem implementation
+//  (integration itself is in ni_mr.cc)
+//
+
+////////////////////////////////////////////////////////////////////////////
+// interface
+//
+
+#include "simlib.h"
+#include "multirate.h"
+#include "internal.h"
+
+#include <algorithm>
+
+
+////////////////////////////////////////////////////////////////////////////
+// implementation
+//
+
+namespace simlib3 {
+
+SIMLIB_IMPLEMENTATION;
+
+/// list of all subsystems (created at first use)
+std::vector<Subsystem*> *Subsystem::All = 0;
+
+/// counter of changes in subsystem structure
+static unsigned long SIMLIB_SubsystemGeneration = 1;
+
+unsigned long Subsystem::Generation()
+{
+  return SIMLIB_SubsystemGeneration;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  constructors
+//
+Subsystem::Subsystem(double _dtmin, double _dtmax) :
+  dtmin(_dtmin), dtmax(_dtmax), optstep(_dtmax)
+{
+  Dprintf(("Subsystem::Subsystem(%g,%g)", _dtmin, _dtmax));
+  Register();
+}
+
+Subsystem::Subsystem(const char *name, double _dtmin, double _dtmax) :
+  dtmin(_dtmin), dtmax(_dtmax), optstep(_dtmax)
+{
+  Dprintf(("Subsystem::Subsystem(\"%s\",%g,%g)", name, _dtmin, _dtmax));
+  SetName(name);
+  Register();
+}
+
+void Subsystem::Register()
+{
+  if(dtmin<=0 || dtmin>dtmax) SIMLIB_error(SetStepError);
+  if(All==0)
+    All = new std::vector<Subsystem*>;
+  All->push_back(this);
+  ++SIMLIB_SubsystemGeneration;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  destructor
+//
+Subsystem::~Subsystem()
+{
+  Dprintf(("Subsystem::~Subsystem() // \"%s\" ", Name()));
+  if(SIMLIB_DynamicFlag)
+    SIMLIB_error(CantDestroyIntg);  // can't in 'dynamic section' !!!
+  All->erase(std::find(All->begin(), All->end(), this));
+  if(All->empty()) {
+    delete All;
+    All = 0;
+  }
+  ++SIMLIB_SubsystemGeneration;
+}
+
+const char *Subsystem::Name() const
+{
+  if (HasName())
+    return _name;
+  else
+    return SIMLIB_create_tmp_name("Subsystem{%p}", this);
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  Subsystem::Add --- integrator can be in single subsystem only
+//
+void Subsystem::Add(Integrator &i)
+{
+  if(SIMLIB_DynamicFlag)
+    SIMLIB_error(CantCreateIntg);   // can't in 'dynamic section' !!!
+  if(Contains(&i))
+    return;
+  for(unsigned k=0; k<Count(); k++)
+    Get(k)->Remove(i);
+  members.push_back(&i);
+  ++SIMLIB_SubsystemGeneration;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  Subsystem::Remove --- integrator returns to default subsystem
+//
+void Subsystem::Remove(Integrator &i)
+{
+  std::vector<Integrator*>::iterator p =
+      std::find(members.begin(), members.end(), &i);
+  if(p == members.end())
+    return;
+  members.erase(p);
+  ++SIMLIB_SubsystemGeneration;
+}
+
+bool Subsystem::Contains(Integrator *i) const
+{
+  return std::find(members.begin(), members.end(), i) != members.end();
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  Subsystem::SetStep --- change step limits
+//
+void Subsystem::SetStep(double _dtmin, double _dtmax)
+{
+  if(_dtmin<=0 || _dtmin>_dtmax) SIMLIB_error(SetStepError);
+  dtmin = _dtmin;
+  dtmax = _dtmax;
+  optstep = max(dtmin, min(optstep, dtmax));
+  Dprintf(("Subsystem::SetStep: StepSize = %g .. %g ", dtmin, dtmax));
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  Subsystem::Output
+//
+void Subsystem::Output() const
+{
+  Print("+----------------------------------------------------------+\n");
+  Print("| SUBSYSTEM %-46s |\n", Name());
+  Print("+----------------------------------------------------------+\n");
+  Print("|  Number of integrators = %-25u       |\n", Size());
+  Print("|  Step limits = %-12g .. %-12g              |\n", dtmin, dtmax);
+  Print("|  Current step size = %-29g       |\n", optstep);
+  Print("+----------------------------------------------------------+\n");
+}
+
+}
+// end
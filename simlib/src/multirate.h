@@ -0,0 +1,77 @@
+/////////////////////////////////////////////////////////////////////////////
+//! \file multirate.h   Multirate integration --- subsystems interface
+//
+// Copyright (c) 2026 agent <agent@local>
+//
+// This library is licensed under GNU Library GPL. See the file COPYING.
+//
+
+//
+//  Integrators can be grouped into subsystems. Each subsystem is
+//  integrated with its own step size by the "multirate" integration
+//  method, subsystems are synchronized at the end of each (macro) step.
+//
+//  Usage:
+//      Subsystem fast("electrical", 1e-7, 1e-4);
+//      fast.Add(i1); fast.Add(i2);
+//      SetMethod("multirate");
+//
+//  Integrators not added to any subsystem form the default subsystem
+//  with step limits given by SetStep().
+//
+//  Step control does not include the coupling error: values of other
+//  subsystems are interpolated linearly over macro step (the step of
+//  the slowest subsystem), error up to |y''|*H*H/8. Limit the maximal
+//  step of slow subsystems if their outputs drive fast ones.
+//
+
+#ifndef __SIMLIB__
+#   error "multirate.h: 16: you should include simlib.h first"
+#endif
+#if __SIMLIB__ < 0x0307
+#   error "multirate.h: 19: requires SIMLIB version 3.07 and higher"
+#endif
+
+#include <vector>
+
+namespace simlib3 {
+
+////////////////////////////////////////////////////////////////////////////
+//! group of integrators with common step size
+//! (used by "multirate" integration method only)
+//! \ingroup simlib
+class Subsystem : public SimObject {
+    Subsystem(const Subsystem&);            // disable copy ctor
+    Subsystem&operator=(const Subsystem&);  // disable assignment
+    static std::vector<Subsystem*> *All;    // list of all subsystems
+    std::vector<Integrator*> members;       // integrators of the subsystem
+    double dtmin;                           // minimal step size
+    double dtmax;                           // maximal step size
+    double optstep;                         // optimal step size (adaptive)
+    void Register();
+  public:
+    Subsystem(double dtmin, double dtmax);
+    Subsystem(const char *name, double dtmin, double dtmax);
+    virtual ~Subsystem();
+    virtual const char *Name() const;
+    virtual void Output() const;            //!< print subsystem status
+    void Add(Integrator &i);                //!< move integrator into subsystem
+    void Add(Integrator *i) { Add(*i); }
+    void Remove(Integrator &i);             //!< move integrator to default
+    bool Contains(Integrator *i) const;
+    unsigned Size() const { return members.size(); }
+    void SetStep(double dtmin, double dtmax); //!< change step limits
+    double MinStep() const { return dtmin; }
+    double MaxStep() const { return dtmax; }
+    double OptStep() const { return optstep; } //!< current step size
+    // internal interface (integration method)
+    void SetOptStep(double dt) { optstep = dt; }
+    Integrator *operator[](unsigned i) const { return members[i]; }
+    static unsigned Count() { return All ? All->size() : 0; }
+    static Subsystem *Get(unsigned i) { return (*All)[i]; }
+    static unsigned long Generation();      //!< changes at each regrouping
+};
+
+} // namespace
+
+// end of multirate.h
@@ -0,0 +1,363 @@
+/////////////////////////////////////////////////////////////////////////////
+// ni_mr.cc
+//
+// Copyright (c) 2026 agent <agent@local>
+//
+// This library is licensed under GNU Library GPL. See the file COPYING.
+//
+
+//
+//  numerical integration: multirate Runge-Kutta-Fehlberg method
+//
+
+////////////////////////////////////////////////////////////////////////////
+//  interface
+//
+#include "simlib.h"
+#include "internal.h"
+#include "ni_mr.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <map>
+
+
+////////////////////////////////////////////////////////////////////////////
+//  implementation
+//
+namespace simlib3 {
+
+SIMLIB_IMPLEMENTATION;
+
+
+////////////////////////////////////////////////////////////////////////////
+//  Multirate method
+//
+/*  Integrators are divided into subsystems (group 0 is default).
+    Arrays of integrators (aIntegratorArray) belong to default subsystem.
+    Macro step H is the step of the slowest subsystem, subsystem g
+    performs m = H/h(g) substeps of Runge-Kutta-Fehlberg's method
+    (the same formula as in ni_rkf5.cc).
+
+    Subsystems are integrated from the slowest one. Values of integrators
+    outside of the integrated subsystem are interpolated (subsystem was
+    integrated already) or extrapolated (y + (t-t0)*y') at each stage.
+    All subsystems are synchronized at the end of macro step, where
+    the whole model is evaluated.
+
+    Limitation: step control uses the local error of RKF5 substeps only.
+    The coupling error (linear interpolation/extrapolation of other
+    subsystems over macro step H, O(H^2)) is not estimated, so the
+    accuracy of coupling is given by the step limits of the slowest
+    subsystem: e.g. slow input y seen by fast subsystem has error up
+    to |y''|*H*H/8.
+*/
+
+// Runge-Kutta-Fehlberg 5th order coefficients
+static const double c[6] = { 0.0, 0.2, 0.3, 0.6, 1.0, 0.875 };
+static const double a[6][5] = {
+  { 0, 0, 0, 0, 0 },
+  { 0.2, 0, 0, 0, 0 },
+  { 3.0/40.0, 9.0/40.0, 0, 0, 0 },
+  { 0.3, -0.9, 1.2, 0, 0 },
+  { -11.0/54.0, 2.5, -70.0/27.0, 35.0/27.0, 0 },
+  { 1631.0/55296.0, 175.0/512.0, 575.0/13824.0, 44275.0/110592.0,
+    253.0/4096.0 },
+};
+static const double b[6] = {
+  37.0/378.0, 0, 250.0/621.0, 125.0/594.0, 0, 512.0/1771.0
+};
+static const double e[6] = { // error estimation
+  -277.0/64512.0, 0, 6925.0/370944.0, -6925.0/202752.0, -277.0/14336.0,
+  277.0/7084.0
+};
+
+////////////////////////////////////////////////////////////////////////////
+//  step limits of subsystem
+//
+double MULTIRATE::MinStep(unsigned g)
+{
+  return g==0 ? SIMLIB_MinStep : Subsystem::Get(g-1)->MinStep();
+}
+
+double MULTIRATE::MaxStep(unsigned g)
+{
+  return g==0 ? SIMLIB_MaxStep : Subsystem::Get(g-1)->MaxStep();
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+//  MULTIRATE::Regroup --- build tables after changes in model structure
+//
+void MULTIRATE::Regroup(void)
+{
+  Dprintf(("MULTIRATE::Regroup()"));
+  size_t n = IntegratorContainer::Size();
+  unsigned ns = Subsystem::Count();
+  std::map<Integrator*,size_t> index; // position in container
+
+  intg.resize(n);
+  group.assign(n, 0);
+  arrays.clear();
+  size_t i = 0;
+  for(Iterator ip=FirstIntegrator(); ip!=LastIntegrator(); ip++, i++) {
+    intg[i] = *ip;
+    if(intg[i].intg)
+      index[intg[i].intg] = i;
+    else if(arrays.empty() || arrays.back()!=intg[i].array)
+      arrays.push_back(intg[i].array);
+  }
+  for(unsigned g=1; g<=ns; g++) {
+    Subsystem *s = Subsystem::Get(g-1);
+    for(unsigned k=0; k<s->Size(); k++) {
+      std::map<Integrator*,size_t>::iterator p = index.find((*s)[k]);
+      if(p != index.end())
+        group[p->second] = g;
+    }
+  }
+  members.assign(ns+1, std::vector<size_t>());
+  for(i=0; i<n; i++)
+    members[group[i]].push_back(i);
+
+  step.resize(ns+1);
+  if(defstep<=0)
+    defstep = SIMLIB_OptStep;
+  step[0] = defstep;
+  for(unsigned g=1; g<=ns; g++)
+    step[g] = Subsystem::Get(g-1)->OptStep();
+  done.resize(ns+1);
+  generation = Subsystem::Generation();
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+//  MULTIRATE::Couple --- values of integrators outside of subsystem g
+//
+void MULTIRATE::Couple(unsigned g, double t0, double H)
+{
+  double dt = double(Time) - t0;
+  double frac = dt/H;
+  for(size_t i=0; i<intg.size(); i++) {
+    unsigned gi = group[i];
+    if(gi == g)
+      continue;
+    IntegratorContainer::StateRef &ip = intg[i];
+    if(done[gi]) // interpolation
+      ip->SetState(ip->GetOldState() + frac*(Y[i] - ip->GetOldState()));
+    else         // extrapolation
+      ip->SetState(ip->GetOldState() + dt*ip->GetOldDiff());
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+//  MULTIRATE::Eval --- evaluate inputs of integrators in subsystem g
+//
+void MULTIRATE::Eval(unsigned g)
+{
+  StatusContainer::ClearAllValueOK(); // status blocks are evaluated lazily
+  const std::vector<size_t> &m = members[g];
+  for(size_t k=0; k<m.size(); k++)
+    if(intg[m[k]].intg)
+      intg[m[k]].intg->Eval();
+  if(g==0)  // arrays: all elements at once
+    for(size_t k=0; k<arrays.size(); k++)
+      arrays[k]->Eval();
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+//  MULTIRATE::Integrate
+//
+void MULTIRATE::Integrate(void)
+{
+  const double safety = 0.9;    // keeps the new step from growing too large
+  const double max_ratio = 4.0; // ditto
+  const double pshrnk = 0.25;   // coefficient for reducing step
+  const double pgrow  = 0.20;   // coefficient for increasing step
+  const unsigned ng = members.size();
+  std::vector<unsigned> order(ng); // subsystems - the slowest first
+  std::vector<double> ratio(ng);   // ratio for next step computation
+  std::vector<double> used(ng);    // substep size used in subsystem
+
+  Dprintf((" MULTIRATE integration step ")); // print debugging info
+  Dprintf((" Time = %g, optimal step = %g", (double)Time, OptStep));
+
+  //--------------------------------------------------------------------------
+  //  Step of method
+  //--------------------------------------------------------------------------
+
+begin_step:
+
+  ///////////////////////////////////////////////////////// beginning of step
+
+  SIMLIB_StepSize = max(SIMLIB_StepSize, SIMLIB_MinStep); // low step limit
+
+  SIMLIB_ContractStepFlag = false;           // clear reduce step flag
+  SIMLIB_ContractStep = 0.5*SIMLIB_StepSize; // implicitly reduce to half step
+
+  const double t0 = SIMLIB_StepStartTime;
+  const double H = SIMLIB_StepSize;          // macro step
+
+  for(unsigned g=0; g<ng; g++) {
+    order[g] = g;
+    done[g] = false;
+  }
+  for(unsigned p=1; p<ng; p++) // insertion sort (few subsystems)
+    for(unsigned q=p; q>0 && step[order[q-1]]<step[order[q]]; q--)
+      std::swap(order[q-1], order[q]);
+
+  for(unsigned k=0; k<ng; k++) {
+    const unsigned g = order[k];
+    const std::vector<size_t> &m = members[g];
+    ratio[g] = 32.0;  // 2^5 - initial value
+    if(m.empty()) {
+      done[g] = true;
+      continue;
+    }
+    unsigned substeps = unsigned(std::ceil(H/min(step[g],H) - 1e-9));
+    const double h = H/substeps;
+    used[g] = h;
+
+    for(size_t i=0; i<m.size(); i++)
+      Y[m[i]] = intg[m[i]]->GetOldState();
+
+    for(unsigned j=0; j<substeps; j++) {
+      const double tau = t0 + j*h;
+      for(int st=0; st<6; st++) { ////////////////////////////// stages
+        if(st>0 || j>0) {
+          for(size_t i=0; i<m.size(); i++) { // state for the stage
+            size_t x = m[i];
+            double y = Y[x];
+            for(int r=0; r<st; r++)
+              y += a[st][r]*A[r][x];
+            intg[x]->SetState(y);
+          }
+          _SetTime(Time, tau + c[st]*h);  // stage time
+          SIMLIB_DeltaTime = double(Time) - SIMLIB_StepStartTime;
+          Couple(g, t0, H);
+          Eval(g);  // evaluate subsystem (y'=f(t,y))
+          for(size_t i=0; i<m.size(); i++)
+            A[st][m[i]] = h*intg[m[i]]->GetDiff();
+        } else { // derivative at the start of macro step is known
+          for(size_t i=0; i<m.size(); i++)
+            A[0][m[i]] = h*intg[m[i]]->GetOldDiff();
+        }
+      }
+      for(size_t i=0; i<m.size(); i++) { /////////////// end of substep
+        size_t x = m[i];
+        double eerr = 0; // estimated error
+        double terr;     // greatest allowed error
+        for(int r=0; r<6; r++) {
+          Y[x] += b[r]*A[r][x];
+          eerr += e[r]*A[r][x];
+        }
+        eerr = std::fabs(eerr);
+        terr = std::fabs(SIMLIB_AbsoluteError)
+             + std::fabs(SIMLIB_RelativeError*Y[x]);
+        if(terr < eerr*ratio[g]) // avoid arithmetic overflow
+          ratio[g] = terr/eerr;  // find the lowest ratio
+      }
+    }
+    done[g] = true;
+  }
+
+  ////////////////////////////////////////// end of step --- synchronization
+
+  for(size_t i=0; i<intg.size(); i++)
+    intg[i]->SetState(Y[i]);
+  _SetTime(Time, t0 + H);
+  SIMLIB_DeltaTime = H;
+  SIMLIB_Dynamic();
+
+  //--------------------------------------------------------------------------
+  //  Check on accuracy of numerical integration, estimate error
+  //--------------------------------------------------------------------------
+
+  SIMLIB_ERRNO = 0; // OK
+  bool redo = false;
+  for(unsigned g=0; g<ng; g++) {
+    if(members[g].empty())
+      continue;
+    double lo = MinStep(g), hi = MaxStep(g);
+    if(ratio[g] < 1.0) { // error is too large, reduce stepsize
+      Dprintf(("Down[%u]: %g", g, ratio[g]));
+      if(used[g] > lo) {  // reducing step is possible
+        step[g] = max(safety*std::pow(ratio[g],pshrnk)*used[g], lo);
+        redo = true;
+        continue;
+      }
+      // reducing step is unpossible
+      SIMLIB_ERRNO++;          // requested accuracy cannot be achieved
+      _Print("\n Subsystem[%u] ", g);
+      SIMLIB_warning(AccuracyError);
+      step[g] = used[g];
+    } else if(!IsStartMode()) { // allowed tolerantion is fulfiled
+      double r = min(std::pow(ratio[g],pgrow), max_ratio); // coefficient
+      Dprintf(("Up[%u]: %g", g, r));
+      step[g] = min(max(safety*r*used[g], step[g]), hi);
+    }
+  }
+  if(redo) { // compute again with smaller steps
+    double macro = 0;
+    for(unsigned g=0; g<ng; g++)
+      if(!members[g].empty())
+        macro = max(macro, step[g]);
+    SIMLIB_StepSize = max(min(H, macro), SIMLIB_MinStep);
+    IsEndStepEvent = false; // no event will be at the end of the step
+    goto begin_step;
+  }
+
+  //--------------------------------------------------------------------------
+  //  Analyse system at the end of the step
+  //--------------------------------------------------------------------------
+
+  if(StateCond()) { // check on changes of state conditions at end of step
+    goto begin_step;
+  }
+
+  //--------------------------------------------------------------------------
+  //  Results of step have been accepted, take fresh step
+  //--------------------------------------------------------------------------
+
+  double next_step = 0; // macro step is given by the slowest subsystem
+  for(unsigned g=0; g<ng; g++) {
+    if(g==0) defstep = step[0];
+    else Subsystem::Get(g-1)->SetOptStep(step[g]);
+    if(!members[g].empty())
+      next_step = max(next_step, step[g]);
+  }
+  SIMLIB_OptStep = min(next_step, SIMLIB_MaxStep);
+
+} // MULTIRATE::Integrate
+
+
+////////////////////////////////////////////////////////////////////////////
+//  MULTIRATE::PrepareStep --- regroup integrators if model was changed
+//
+bool MULTIRATE::PrepareStep(void)
+{
+  bool changes = SingleStepMethod::PrepareStep(); // resize memories
+  if(changes || generation != Subsystem::Generation()) {
+    Regroup();
+    return true;
+  }
+  return false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+//  MULTIRATE::TurnOff --- next run starts with maximal steps
+//
+void MULTIRATE::TurnOff(void)
+{
+  Dprintf(("MULTIRATE::TurnOff()"));
+  SingleStepMethod::TurnOff();
+  for(unsigned g=0; g<Subsystem::Count(); g++)
+    Subsystem::Get(g)->SetOptStep(Subsystem::Get(g)->MaxStep());
+  defstep = 0;
+  generation = 0;
+}
+
+}
+// end of ni_mr.cc
@@ -0,0 +1,55 @@
+/////////////////////////////////////////////////////////////////////////////
+//! \file ni_mr.h  Multirate method (subsystems with different step sizes)
+//
+// Copyright (c) 2026 agent <agent@local>
+//
+// This library is licensed under GNU Library GPL. See the file COPYING.
+//
+
+//
+//  numerical integration: multirate Runge-Kutta-Fehlberg method
+//
+
+
+#include "simlib.h"
+#include "multirate.h"
+#include <vector>
+
+namespace simlib3 {
+
+////////////////////////////////////////////////////////////////////////////
+//  class representing the integration method
+//
+class MULTIRATE : public SingleStepMethod {
+private:
+  Memory Y;      // auxiliary memories: state of subsystem
+  Memory A[6];   // stages of RKF5
+  std::vector<IntegratorContainer::StateRef> intg; // states by index
+  std::vector<aIntegratorArray*> arrays;     // arrays (default subsystem)
+  std::vector<unsigned> group;               // subsystem of integrator
+  std::vector< std::vector<size_t> > members;// integrators of subsystem
+  std::vector<double> step;                  // step size of subsystem
+  std::vector<char> done;                    // subsystem integrated
+  unsigned long generation;                  // last Subsystem::Generation
+  double defstep;                            // step of default subsystem
+  void Regroup(void);                        // build subsystem tables
+  void Couple(unsigned g, double t0, double H); // set other subsystems
+  void Eval(unsigned g);                     // evaluate subsystem inputs
+  double MinStep(unsigned g);                // step limits of subsystem
+  double MaxStep(unsigned g);
+public:
+  MULTIRATE(const char* name) :  // registrate method and name it
+    SingleStepMethod(name),
+    generation(0),
+    defstep(0)
+  { /*NOTHING*/ }
+  virtual ~MULTIRATE()  // destructor
+  { /*NOTHING*/ }
+  virtual void Integrate(void);  // integration method
+  virtual bool PrepareStep(void);  // prepare object for integration step
+  virtual void TurnOff(void);  // turn off integration method
+}; // class MULTIRATE
+
+} // namespace
+
+// end of ni_mr.h
@@ -24,6 +24,7 @@
 #include "ni_rkf3.h"
 #include "ni_rkf5.h"
 #include "ni_rkf8.h"
+#include "ni_mr.h"
 #include <cstddef>
 #include <cstring>
 
@@ -545,10 +546,10 @@ void StatusMethod::StatusResize(size_t size)
 void StatusMethod::StoreState(Memory& di, Memory& si, StatusMemory& xi)
 {
   register size_t i;
-  IntegratorContainer::iterator ip, end_it;
+  IntegratorContainer::state_iterator ip, end_it;
   StatusContainer::iterator sp, status_end_it;
 
-  for(ip=IntegratorContainer::Begin(), end_it=IntegratorContainer::End(), i=0;
+  for(ip=FirstIntegrator(), end_it=LastIntegrator(), i=0;
       ip!=end_it;
       ip++, i++)
   {
@@ -570,10 +571,10 @@ void StatusMethod::RestoreState(double dthlf, Memory& di, Memory& si,
                                 StatusMemory& xi)
 {
   register size_t i;
-  IntegratorContainer::iterator ip, end_it;
+  IntegratorContainer::state_iterator ip, end_it;
   StatusContainer::iterator sp, status_end_it;
 
-  for(ip=IntegratorContainer::Begin(), end_it=IntegratorContainer::End(), i=0;
+  for(ip=FirstIntegrator(), end_it=LastIntegrator(), i=0;
       ip!=end_it;
       ip++, i++)
   {
@@ -597,10 +598,10 @@ void StatusMethod::RestoreState(double dthlf, Memory& di, Memory& si,
 void StatusMethod::GoToState(Memory& di, Memory& si, StatusMemory& xi)
 {
   register size_t i;
-  IntegratorContainer::iterator ip, end_it;
+  IntegratorContainer::state_iterator ip, end_it;
   StatusContainer::iterator sp, status_end_it;
 
-  for(ip=IntegratorContainer::Begin(), end_it=IntegratorContainer::End(), i=0;
+  for(ip=FirstIntegrator(), end_it=LastIntegrator(), i=0;
       ip!=end_it;
       ip++, i++)
   {
@@ -652,6 +653,8 @@ RKF3 rkf3("rkf3");
 RKF5 rkf5("rkf5");
 /// Runge-Kutta-Fehlberg, 8th order
 RKF8 rkf8("rkf8");
+/// multirate Runge-Kutta-Fehlberg, 5th order (subsystems with own step size)
+MULTIRATE multirate("multirate");
 
 /// pointer to the method currently used
 /// "rke" is a predefined method (historical reasons, we need rk45)
@@ -0,0 +1,294 @@
+/////////////////////////////////////////////////////////////////////////////
+//! \file opt-bayes.cc  Optimization algorithm - Bayesian optimization
+//
+// Copyright (c) 2026 agent <agent@local>
+//
+// This library is licensed under GNU Library GPL. See the file COPYING.
+//
+
+// EXPERIMENTAL
+// Bayesian optimization for expensive functions
+//  - surrogate: Gaussian process, squared exponential kernel,
+//    length scale and noise chosen by marginal likelihood (grid)
+//  - acquisition: expected improvement, maximized by random search
+//    with local refinement around the best candidates
+//  - batches: the first point minimizes the prediction, the others are
+//    selected by "kriging believer" (selected point is added with
+//    predicted value), batch evaluated by EvaluationPool
+// D. R. Jones et al.: Efficient Global Optimization of Expensive
+// Black-Box Functions, 1998
+
+#include "simlib.h"
+#include "internal.h"
+#include "optimize.h"
+
+#include <cmath>
+#include <vector>
+
+namespace simlib3 {
+
+SIMLIB_IMPLEMENTATION;
+
+typedef std::vector<double> vec;
+
+static const double PI = 3.14159265358979323846;
+static const double FAILED = 1e30;      // result of failed evaluation (pool)
+
+//////////////////////////////////////////////////////////////////////////////
+// Gaussian process model in normalized coordinates 0..1
+//
+class GaussianProcess {
+    int dim;
+    double len, noise;          // hyperparameters
+    double ymean, yscale;       // normalization of values
+    vec X;                      // points (by rows)
+    vec y;                      // normalized values
+    vec L;                      // Cholesky factor of K
+    vec alpha;                  // K^-1 y
+    double kernel(const double *a, const double *b) const {
+        double d = 0;
+        for (int i = 0; i < dim; i++)
+            d += (a[i] - b[i]) * (a[i] - b[i]);
+        return exp(-0.5 * d / (len * len));
+    }
+    bool factor();              // L, alpha for len, noise
+    void solve(vec &v) const;   // v = L^-1 v
+  public:
+    GaussianProcess(int n): dim(n), len(0.2), noise(1e-6),
+        ymean(0), yscale(1) { }
+    void Fit(const vec &X, const vec &y);
+    void Predict(const double *x, double &mean, double &sd) const;
+    int Size() const { return y.size(); }
+};
+
+// factor --- Cholesky decomposition, false if not positive definite
+bool GaussianProcess::factor()
+{
+    const int n = Size();
+    L.assign(n * n, 0.0);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j <= i; j++) {
+            double s = kernel(&X[i * dim], &X[j * dim]);
+            if (i == j)
+                s += noise;
+            for (int k = 0; k < j; k++)
+                s -= L[i * n + k] * L[j * n + k];
+            if (i == j) {
+                if (s <= 0)
+                    return false;
+                L[i * n + i] = sqrt(s);
+            } else
+                L[i * n + j] = s / L[j * n + j];
+        }
+    alpha = y;                  // alpha = L'^-1 L^-1 y
+    solve(alpha);
+    for (int i = n - 1; i >= 0; i--) {
+        for (int k = i + 1; k < n; k++)
+            alpha[i] -= L[k * n + i] * alpha[k];
+        alpha[i] /= L[i * n + i];
+    }
+    return true;
+}
+
+void GaussianProcess::solve(vec &v) const
+{
+    const int n = Size();
+    for (int i = 0; i < n; i++) {
+        for (int k = 0; k < i; k++)
+            v[i] -= L[i * n + k] * v[k];
+        v[i] /= L[i * n + i];
+    }
+}
+
+// Fit --- set data, choose hyperparameters with maximal likelihood
+void GaussianProcess::Fit(const vec &_X, const vec &_y)
+{
+    static const double lens[] = { 0.05, 0.1, 0.2, 0.4, 0.8 };
+    static const double noises[] = { 1e-6, 1e-3, 1e-2, 1e-1 };
+    const int n = _y.size();
+    X = _X;
+    ymean = 0;
+    for (int i = 0; i < n; i++)
+        ymean += _y[i] / n;
+    double v = 0;
+    for (int i = 0; i < n; i++)
+        v += (_y[i] - ymean) * (_y[i] - ymean);
+    yscale = (n > 1 && v > 0) ? sqrt(v / (n - 1)) : 1;
+    y.resize(n);
+    for (int i = 0; i < n; i++)
+        y[i] = (_y[i] - ymean) / yscale;
+    double bestlik = -HUGE_VAL, bestlen = 0.2, bestnoise = 1e-2;
+    for (unsigned a = 0; a < sizeof(lens) / sizeof(*lens); a++)
+        for (unsigned b = 0; b < sizeof(noises) / sizeof(*noises); b++) {
+            len = lens[a] * sqrt(double(dim));
+            noise = noises[b];
+            if (!factor())
+                continue;
+            // log likelihood = -y'alpha/2 - sum(log(L_ii)) - n/2 log(2 pi)
+            double lik = 0;
+            for (int i = 0; i < n; i++)
+                lik -= 0.5 * y[i] * alpha[i] + log(L[i * n + i]);
+            if (lik > bestlik) {
+                bestlik = lik;
+                bestlen = len;
+                bestnoise = noise;
+            }
+        }
+    len = bestlen;
+    noise = bestnoise;
+    while (!factor())           // numerical problems
+        noise *= 10;
+}
+
+// Predict --- mean and standard deviation at point x
+void GaussianProcess::Predict(const double *x, double &mean, double &sd) const
+{
+    const int n = Size();
+    vec k(n);
+    mean = 0;
+    for (int i = 0; i < n; i++) {
+        k[i] = kernel(x, &X[i * dim]);
+        mean += k[i] * alpha[i];
+    }
+    solve(k);
+    double var = 1.0;
+    for (int i = 0; i < n; i++)
+        var -= k[i] * k[i];
+    mean = ymean + yscale * mean;
+    sd = (var > 1e-12) ? yscale * sqrt(var) : yscale * 1e-6;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// expected improvement (minimization)
+//
+static double ExpectedImprovement(double fmin, double mean, double sd)
+{
+    double z = (fmin - mean) / sd;
+    return (fmin - mean) * 0.5 * erfc(-z / sqrt(2.0)) +
+           sd * exp(-0.5 * z * z) / sqrt(2 * PI);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Bayesian optimization
+//  maxeval -- number of evaluations of f
+//  batch -- points evaluated in parallel (0: number of workers)
+//
+double Optimize_bayes(opt_function_t f, ParameterVector & p, int maxeval,
+                      int batch, int workers)
+{
+    if (maxeval < 1)
+        SIMLIB_error("Optimize_bayes: maxeval < 1");
+    const int n = p.size();
+    RandomStream rs(24680);     // own generator (model uses the base one)
+    EvaluationPool pool(workers);
+    if (batch <= 0)
+        batch = pool.Workers();
+    vec X, y;                   // evaluated points (normalized), values
+    std::vector<ParameterVector> pts;
+    // initial design: given point + Latin hypercube
+    int n0 = 2 * n + 2;
+    if (n0 > maxeval)
+        n0 = maxeval;
+    std::vector<ParameterVector> pop(n0, p);
+    vec xn(n0 * n);
+    for (int i = 0; i < n; i++) {
+        xn[i] = (p[i].Range() > 0) ? (p[i] - p[i].Min()) / p[i].Range() : 0;
+        std::vector<int> perm(n0 - 1);
+        for (int k = 0; k < n0 - 1; k++)
+            perm[k] = k;
+        for (int k = n0 - 2; k > 0; k--) {
+            int j = int(rs.Random() * (k + 1));
+            int t = perm[k]; perm[k] = perm[j]; perm[j] = t;
+        }
+        for (int k = 1; k < n0; k++)
+            xn[k * n + i] = (perm[k - 1] + rs.Random()) / (n0 - 1);
+    }
+    GaussianProcess gp(n);
+    vec cand(n), best(n), bx(n);
+    while ((int)y.size() < maxeval) {
+        if (!y.empty()) {       // select batch
+            int m = batch;
+            if (m > maxeval - (int)y.size())
+                m = maxeval - y.size();
+            vec Xf(X), yf(y);   // with fantasy values
+            // failed evaluations are modelled as the worst finite value
+            double worst = -HUGE_VAL;
+            for (unsigned k = 0; k < yf.size(); k++)
+                if (yf[k] < FAILED && yf[k] > worst)
+                    worst = yf[k];
+            if (worst == -HUGE_VAL)
+                worst = 0;      // all failed: flat model
+            for (unsigned k = 0; k < yf.size(); k++)
+                if (yf[k] >= FAILED)
+                    yf[k] = worst;
+            pop.assign(m, p);
+            xn.resize(m * n);
+            for (int b = 0; b < m; b++) {
+                gp.Fit(Xf, yf);
+                double fmin = yf[0];
+                int imin = 0;
+                for (unsigned k = 1; k < yf.size(); k++)
+                    if (yf[k] < fmin) {
+                        fmin = yf[k];
+                        imin = k;
+                    }
+                // the first point of batch minimizes prediction
+                // (exploitation), others maximize expected improvement
+                const bool exploit = (b == 0 && m > 1);
+                double bestei = -HUGE_VAL, mean, sd;
+                // global random search, then local around best candidate
+                // and around best point
+                const int N = 500 * n;
+                for (int k = 0; k < 3 * N; k++) {
+                    for (int i = 0; i < n; i++) {
+                        double x;
+                        if (k < N)
+                            x = rs.Random();
+                        else {
+                            double c = (k < 2 * N) ? bx[i] : Xf[imin * n + i];
+                            double s = (k < 2 * N) ? 0.05 : 0.01;
+                            x = rs.Normal(c, s);
+                            x = x < 0 ? 0 : (x > 1 ? 1 : x);
+                        }
+                        cand[i] = x;
+                    }
+                    gp.Predict(&cand[0], mean, sd);
+                    double ei = exploit ? fmin - mean :
+                                ExpectedImprovement(fmin, mean, sd);
+                    if (ei > bestei) {
+                        bestei = ei;
+                        best = cand;
+                    }
+                    if (k == N - 1 || k == 2 * N - 1)
+                        bx = best;
+                }
+                gp.Predict(&best[0], mean, sd);
+                Xf.insert(Xf.end(), best.begin(), best.end());
+                yf.push_back(mean);     // kriging believer
+                for (int i = 0; i < n; i++)
+                    xn[b * n + i] = best[i];
+            }
+        }
+        for (unsigned k = 0; k < pop.size(); k++)
+            for (int i = 0; i < n; i++)
+                pop[k][i] = p[i].Min() + p[i].Range() * xn[k * n + i];
+        vec r;
+        pool.Evaluate(f, pop, r);
+        for (unsigned k = 0; k < pop.size(); k++) {
+            for (int i = 0; i < n; i++)    // value after limit()
+                X.push_back((p[i].Range() > 0) ?
+                            (pop[k][i] - p[i].Min()) / p[i].Range() : 0);
+            y.push_back(r[k]);
+            pts.push_back(pop[k]);
+        }
+    }
+    int ibest = 0;
+    for (unsigned k = 1; k < y.size(); k++)
+        if (y[k] < y[ibest])
+            ibest = k;
+    p = pts[ibest];
+    return y[ibest];
+}
+
+}
+// end
@@ -0,0 +1,177 @@
+/////////////////////////////////////////////////////////////////////////////
+//! \file opt-cache.cc  Evaluation cache for simulation-based optimization
+//
+// Copyright (c) 2026 agent <agent@local>
+//
+// This library is licensed under GNU Library GPL. See the file COPYING.
+//
+
+// EXPERIMENTAL
+// memoized evaluation with adaptive number of replications
+
+#include "simlib.h"
+#include "internal.h"
+#include "optimize.h"
+
+#include <cmath>
+
+namespace simlib3 {
+
+SIMLIB_IMPLEMENTATION;
+
+static const double Z = 2.0;            // significance of difference
+
+EvaluationCache *EvaluationCache::active = 0;
+
+//////////////////////////////////////////////////////////////////////////////
+// constructor
+//
+EvaluationCache::EvaluationCache(opt_function_t _f, double q,
+                                 unsigned min, unsigned max, long s):
+    f(_f), quantum(q > 0 ? q : 1e-12),
+    minrep(min > 0 ? min : 1), maxrep(max > minrep ? max : minrep),
+    seed(s), best(0), calls(0), runs(0)
+{
+}
+
+EvaluationCache::~EvaluationCache()
+{
+    if (active == this)
+        active = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Function --- activate cache, returns function for optimization method
+//
+opt_function_t EvaluationCache::Function()
+{
+    active = this;
+    return Call;
+}
+
+EvaluationCache *EvaluationCache::Active(opt_function_t f)
+{
+    return (f == Call) ? active : 0;
+}
+
+double EvaluationCache::Call(const ParameterVector &p)
+{
+    return (*active)(p);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Clear --- forget all results
+//
+void EvaluationCache::Clear()
+{
+    cache.clear();
+    best = 0;
+    calls = runs = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Key --- quantized parameter values
+//
+std::vector<long> EvaluationCache::Key(const ParameterVector &p) const
+{
+    std::vector<long> key(p.size());
+    for (int i = 0; i < p.size(); i++) {
+        double r = p[i].Range();
+        key[i] = (r > 0) ? long(floor((p[i] - p[i].Min()) / (r * quantum) + 0.5))
+                         : 0;
+    }
+    return key;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Lookup --- find/create entry for point p
+//
+EvaluationCache::Entry &EvaluationCache::Lookup(const ParameterVector &p)
+{
+    std::vector<long> key = Key(p);
+    map_t::iterator it = cache.find(key);
+    if (it == cache.end())
+        it = cache.insert(std::make_pair(key, Entry(p))).first;
+    return it->second;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Run --- next replication of point
+//
+void EvaluationCache::Run(Entry &e)
+{
+    RandomSeed(seed + e.y.size());      // common random numbers
+    double r = f(e.p);
+    e.y.push_back(r);
+    e.sum += r;
+    runs++;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Ambiguous --- difference of a and b is not significant and more
+// replications are possible
+// paired test on replications with the same seed
+//
+bool EvaluationCache::Ambiguous(const Entry &a, const Entry &b) const
+{
+    if (a.y.size() >= maxrep && b.y.size() >= maxrep)
+        return false;
+    unsigned m = a.y.size() < b.y.size() ? a.y.size() : b.y.size();
+    if (m < 2)
+        return maxrep > 1;              // no estimate of variance
+    double sd = 0, sd2 = 0;
+    for (unsigned i = 0; i < m; i++) {
+        double d = a.y[i] - b.y[i];
+        sd += d;
+        sd2 += d * d;
+    }
+    double mean = sd / m;
+    double var = (sd2 - m * mean * mean) / (m - 1);
+    return fabs(mean) < Z * sqrt(var > 0 ? var / m : 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// UpdateBest --- e can be the best point
+//
+void EvaluationCache::UpdateBest(Entry &e)
+{
+    if (e.failed)
+        return;
+    if (!best || e.Mean() < best->Mean())
+        best = &e;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// operator () --- mean result of replications of point p
+//
+double EvaluationCache::operator () (const ParameterVector &p)
+{
+    calls++;
+    Entry &e = Lookup(p);
+    if (e.failed)                       // failed in worker: do not repeat
+        return e.Mean();
+    while (e.y.size() < minrep)
+        Run(e);
+    while (best && &e != best && Ambiguous(e, *best)) {
+        // the one with less replications, both if equal
+        unsigned ne = e.y.size(), nb = best->y.size();
+        if (ne <= nb)
+            Run(e);
+        if (nb <= ne)
+            Run(*best);
+    }
+    UpdateBest(e);
+    return e.Mean();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Replications --- number of simulation runs of point p
+//
+unsigned EvaluationCache::Replications(const ParameterVector &p) const
+{
+    map_t::const_iterator it = cache.find(Key(p));
+    return (it == cache.end()) ? 0 : it->second.y.size();
+}
+
+}
+// end
@@ -0,0 +1,210 @@
+/////////////////////////////////////////////////////////////////////////////
+//! \file opt-cmaes.cc  Optimization algorithm - CMA-ES
+//
+// Copyright (c) 2026 agent <agent@local>
+//
+// This library is licensed under GNU Library GPL. See the file COPYING.
+//
+
+// EXPERIMENTAL
+// covariance matrix adaptation evolution strategy (mu/mu_w, lambda)
+// N. Hansen: The CMA Evolution Strategy: A Tutorial, 2016
+//
+// search is performed in normalized space, parameter i is
+// min_i + range_i * reflect(y_i), where reflect() maps the real line
+// into 0..1 by reflection at the bounds
+
+#include "simlib.h"
+#include "internal.h"
+#include "optimize.h"
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+namespace simlib3 {
+
+SIMLIB_IMPLEMENTATION;
+
+typedef std::vector<double> vec;
+
+//////////////////////////////////////////////////////////////////////////////
+// reflect y into 0..1
+//
+static double reflect(double y)
+{
+    y = fmod(fabs(y), 2.0);
+    return (y > 1.0) ? 2.0 - y : y;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// eigen --- eigen decomposition of symmetric matrix C (n*n, by rows)
+// Jacobi rotations; C = B diag(d) B'
+//
+static void eigen(int n, const vec &C, vec &B, vec &d)
+{
+    vec a(C);
+    B.assign(n * n, 0.0);
+    for (int i = 0; i < n; i++)
+        B[i * n + i] = 1.0;
+    for (int sweep = 0; sweep < 50; sweep++) {
+        double off = 0;
+        for (int p = 0; p < n; p++)
+            for (int q = p + 1; q < n; q++)
+                off += a[p * n + q] * a[p * n + q];
+        if (off < 1e-30)
+            break;
+        for (int p = 0; p < n; p++)
+            for (int q = p + 1; q < n; q++) {
+                double apq = a[p * n + q];
+                if (fabs(apq) < 1e-300)
+                    continue;
+                double theta = (a[q * n + q] - a[p * n + p]) / (2 * apq);
+                double t = (theta >= 0 ? 1 : -1) /
+                           (fabs(theta) + sqrt(theta * theta + 1));
+                double c = 1 / sqrt(t * t + 1), s = t * c;
+                for (int k = 0; k < n; k++) {   // a = J' a J
+                    double akp = a[k * n + p], akq = a[k * n + q];
+                    a[k * n + p] = c * akp - s * akq;
+                    a[k * n + q] = s * akp + c * akq;
+                }
+                for (int k = 0; k < n; k++) {
+                    double apk = a[p * n + k], aqk = a[q * n + k];
+                    a[p * n + k] = c * apk - s * aqk;
+                    a[q * n + k] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < n; k++) {   // B = B J
+                    double bkp = B[k * n + p], bkq = B[k * n + q];
+                    B[k * n + p] = c * bkp - s * bkq;
+                    B[k * n + q] = s * bkp + c * bkq;
+                }
+            }
+    }
+    d.resize(n);
+    for (int i = 0; i < n; i++)
+        d[i] = a[i * n + i];
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// CMA-ES
+//
+double Optimize_cmaes(opt_function_t f, ParameterVector & p, int maxgen,
+                      int lambda, int workers)
+{
+    const int n = p.size();
+    if (lambda < 4)
+        lambda = 4 + int(3 * log(double(n)));
+    const int mu = lambda / 2;
+    vec w(mu);                  // recombination weights
+    double sw = 0, sw2 = 0;
+    for (int i = 0; i < mu; i++) {
+        w[i] = log(mu + 0.5) - log(i + 1.0);
+        sw += w[i];
+    }
+    for (int i = 0; i < mu; i++) {
+        w[i] /= sw;
+        sw2 += w[i] * w[i];
+    }
+    const double mueff = 1 / sw2;
+    // strategy parameters (default values)
+    const double cc = (4 + mueff / n) / (n + 4 + 2 * mueff / n);
+    const double cs = (mueff + 2) / (n + mueff + 5);
+    const double c1 = 2 / ((n + 1.3) * (n + 1.3) + mueff);
+    const double cmu = std::min(1 - c1, 2 * (mueff - 2 + 1 / mueff) /
+                                ((n + 2) * (n + 2) + mueff));
+    const double damps = 1 + 2 * std::max(0.0, sqrt((mueff - 1) / (n + 1)) - 1)
+                         + cs;
+    const double chiN = sqrt(double(n)) * (1 - 1.0 / (4 * n) +
+                                           1.0 / (21.0 * n * n));
+    // state
+    vec xmean(n), pc(n, 0.0), ps(n, 0.0), C(n * n, 0.0), B, D(n, 1.0);
+    for (int i = 0; i < n; i++) {
+        xmean[i] = (p[i].Range() > 0) ? (p[i] - p[i].Min()) / p[i].Range() : 0;
+        C[i * n + i] = 1;
+    }
+    eigen(n, C, B, D);
+    double sigma = 0.3;
+    RandomStream rs(12345);     // own generator (model uses the base one)
+    EvaluationPool pool(workers);
+    std::vector<ParameterVector> pop(lambda, p);
+    vec fit(lambda), arz(lambda * n), ary(lambda * n), arx(lambda * n);
+    std::vector<int> idx(lambda);
+    ParameterVector best(p);
+    vec fit0;                   // initial point: seeded as candidates
+    pool.Evaluate(f, std::vector<ParameterVector>(1, p), fit0);
+    double fbest = fit0[0];
+    for (int gen = 0; gen < maxgen; gen++) {
+        for (int k = 0; k < lambda; k++) {      // sample new generation
+            for (int i = 0; i < n; i++)
+                arz[k * n + i] = rs.Normal(0, 1);
+            for (int i = 0; i < n; i++) {
+                double y = 0;
+                for (int j = 0; j < n; j++)
+                    y += B[i * n + j] * sqrt(std::max(D[j], 0.0)) * arz[k * n + j];
+                ary[k * n + i] = y;
+                arx[k * n + i] = xmean[i] + sigma * y;
+                pop[k][i] = p[i].Min() + p[i].Range() * reflect(arx[k * n + i]);
+            }
+        }
+        pool.Evaluate(f, pop, fit);
+        for (int k = 0; k < lambda; k++)
+            idx[k] = k;
+        for (int k = 1; k < lambda; k++) {      // sort by fitness
+            int t = idx[k], j = k;
+            for ( ; j > 0 && fit[idx[j - 1]] > fit[t]; j--)
+                idx[j] = idx[j - 1];
+            idx[j] = t;
+        }
+        if (fit[idx[0]] < fbest) {
+            fbest = fit[idx[0]];
+            best = pop[idx[0]];
+        }
+        // recombination
+        vec xold(xmean), zmean(n, 0.0), ymean(n, 0.0);
+        for (int i = 0; i < n; i++) {
+            xmean[i] = 0;
+            for (int k = 0; k < mu; k++) {
+                xmean[i] += w[k] * arx[idx[k] * n + i];
+                zmean[i] += w[k] * arz[idx[k] * n + i];
+            }
+            ymean[i] = (xmean[i] - xold[i]) / sigma;
+        }
+        // evolution paths
+        double nps = 0;
+        for (int i = 0; i < n; i++) {
+            double bz = 0;                      // B * zmean
+            for (int j = 0; j < n; j++)
+                bz += B[i * n + j] * zmean[j];
+            ps[i] = (1 - cs) * ps[i] + sqrt(cs * (2 - cs) * mueff) * bz;
+            nps += ps[i] * ps[i];
+        }
+        nps = sqrt(nps);
+        bool hsig = nps / sqrt(1 - pow(1 - cs, 2.0 * (gen + 1))) / chiN
+                    < 1.4 + 2.0 / (n + 1);
+        for (int i = 0; i < n; i++)
+            pc[i] = (1 - cc) * pc[i] +
+                    (hsig ? sqrt(cc * (2 - cc) * mueff) * ymean[i] : 0);
+        // covariance matrix adaptation
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j <= i; j++) {
+                double rankmu = 0;
+                for (int k = 0; k < mu; k++)
+                    rankmu += w[k] * ary[idx[k] * n + i] * ary[idx[k] * n + j];
+                double c = (1 - c1 - cmu) * C[i * n + j] +
+                           c1 * (pc[i] * pc[j] +
+                                 (hsig ? 0 : cc * (2 - cc) * C[i * n + j])) +
+                           cmu * rankmu;
+                C[i * n + j] = C[j * n + i] = c;
+            }
+        sigma *= exp((cs / damps) * (nps / chiN - 1));
+        eigen(n, C, B, D);
+        double dmax = *std::max_element(D.begin(), D.end());
+        if (sigma * sqrt(std::max(dmax, 0.0)) < 1e-12)
+            break;                              // converged
+    }
+    p = best;
+    return fbest;
+}
+
+}
+// end
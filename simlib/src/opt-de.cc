@@ -0,0 +1,80 @@
+/////////////////////////////////////////////////////////////////////////////
+//! \file opt-de.cc  Optimization algorithm - differential evolution
+//
+// Copyright (c) 2026 agent <agent@local>
+//
+// This library is licensed under GNU Library GPL. See the file COPYING.
+//
+
+// EXPERIMENTAL
+// differential evolution DE/rand/1/bin (R. Storn, K. Price, 1997)
+// with dither of F (0.5..1) per generation;
+// all trial vectors of a generation are evaluated together
+
+#include "simlib.h"
+#include "internal.h"
+#include "optimize.h"
+
+#include <vector>
+
+namespace simlib3 {
+
+SIMLIB_IMPLEMENTATION;
+
+static const double CR = 0.9;           // crossover probability
+
+//////////////////////////////////////////////////////////////////////////////
+// differential evolution
+//
+double Optimize_de(opt_function_t f, ParameterVector & p, int maxgen,
+                   int np, int workers)
+{
+    const int n = p.size();
+    if (np < 4)
+        np = (10 * n < 20) ? 20 : 10 * n;
+    RandomStream rs(54321);     // own generator (model uses the base one)
+    EvaluationPool pool(workers);
+    // initial population: given point + uniform random points
+    std::vector<ParameterVector> pop(np, p), trial(np, p);
+    for (int k = 1; k < np; k++)
+        for (int i = 0; i < n; i++)
+            pop[k][i] = rs.Uniform(p[i].Min(), p[i].Max());
+    std::vector<double> fit, tfit;
+    pool.Evaluate(f, pop, fit);
+    for (int gen = 0; gen < maxgen; gen++) {
+        double F = rs.Uniform(0.5, 1.0);        // dither
+        for (int k = 0; k < np; k++) {
+            int a, b, c;                // distinct, != k
+            do a = int(rs.Random() * np); while (a == k);
+            do b = int(rs.Random() * np); while (b == k || b == a);
+            do c = int(rs.Random() * np); while (c == k || c == a || c == b);
+            int jr = int(rs.Random() * n);      // at least one from mutant
+            for (int i = 0; i < n; i++) {
+                double x = pop[k][i];
+                if (i == jr || rs.Random() < CR) {
+                    x = pop[a][i] + F * (pop[b][i] - pop[c][i]);
+                    if (x < p[i].Min())         // bounds: between base and bound
+                        x = (pop[a][i] + p[i].Min()) / 2;
+                    else if (x > p[i].Max())
+                        x = (pop[a][i] + p[i].Max()) / 2;
+                }
+                trial[k][i] = x;
+            }
+        }
+        pool.Evaluate(f, trial, tfit);
+        for (int k = 0; k < np; k++)            // selection
+            if (tfit[k] <= fit[k]) {
+                pop[k] = trial[k];
+                fit[k] = tfit[k];
+            }
+    }
+    int best = 0;
+    for (int k = 1; k < np; k++)
+        if (fit[k] < fit[best])
+            best = k;
+    p = pop[best];
+    return fit[best];
+}
+
+}
+// end
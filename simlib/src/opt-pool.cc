@@ -0,0 +1,210 @@
+/////////////////////////////////////////////////////////////////////////////
+//! \file opt-pool.cc  Parallel evaluation of optimization candidates
+//
+// Copyright (c) 2026 agent <agent@local>
+//
+// This library is licensed under GNU Library GPL. See the file COPYING.
+//
+
+// EXPERIMENTAL
+// evaluation of whole generation by worker processes
+
+#include "simlib.h"
+#include "internal.h"
+#include "optimize.h"
+
+#include <cstdio>
+#if defined(__unix__) || defined(__APPLE__)
+#  include <unistd.h>
+#  include <sys/types.h>
+#  include <sys/wait.h>
+#  define SIMLIB_OPT_FORK       // worker processes available
+#endif
+
+namespace simlib3 {
+
+SIMLIB_IMPLEMENTATION;
+
+static const double FAILED = 1e30;      // result of failed evaluation
+
+//////////////////////////////////////////////////////////////////////////////
+// AddJob --- add point to list of points for next round (once)
+//
+template <class T>
+static void AddJob(std::vector<T *> &job, T *p)
+{
+    for (unsigned j = 0; j < job.size(); j++)
+        if (job[j] == p)
+            return;
+    job.push_back(p);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// constructor
+//
+EvaluationPool::EvaluationPool(int w, long s):
+    workers(w), seed(s), count(0)
+{
+#ifdef SIMLIB_OPT_FORK
+    if (workers <= 0)
+        workers = int(sysconf(_SC_NPROCESSORS_ONLN));
+#endif
+    if (workers <= 0)
+        workers = 1;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Run --- result[i] = f(*x[i]) after RandomSeed(seeds[i])
+//
+void EvaluationPool::Run(opt_function_t f,
+                         const std::vector<const ParameterVector *> &x,
+                         const std::vector<long> &seeds,
+                         std::vector<double> &result)
+{
+    const int n = x.size();
+    result.assign(n, FAILED);
+#ifdef SIMLIB_OPT_FORK
+    int w = workers < n ? workers : n;
+    if (w > 1) {
+        std::vector<int> fd(w, -1);
+        std::vector<pid_t> pid(w, -1);
+        fflush(0);                      // do not duplicate buffers
+        for (int k = 0; k < w; k++) {
+            int p[2];
+            if (pipe(p) != 0)
+                break;
+            pid[k] = fork();
+            if (pid[k] == 0) {          // worker: candidates k, k+w, ...
+                close(p[0]);
+                for (int i = k; i < n; i += w) {
+                    RandomSeed(seeds[i]);
+                    double r[2] = { double(i), f(*x[i]) };
+                    if (write(p[1], r, sizeof(r)) != sizeof(r))
+                        break;
+                }
+                fflush(0);
+                _exit(0);               // no atexit cleanup in worker
+            }
+            close(p[1]);
+            if (pid[k] < 0) {
+                close(p[0]);
+                break;
+            }
+            fd[k] = p[0];
+        }
+        for (int k = 0; k < w; k++) {   // collect results
+            if (fd[k] < 0)
+                continue;
+            double r[2];
+            while (read(fd[k], r, sizeof(r)) == sizeof(r))
+                if (r[0] >= 0 && r[0] < n)
+                    result[int(r[0])] = r[1];
+            close(fd[k]);
+            waitpid(pid[k], 0, 0);
+        }
+        for (int k = 0; k < w; k++)     // not started: sequentially
+            if (fd[k] < 0)
+                for (int i = k; i < n; i += w) {
+                    RandomSeed(seeds[i]);
+                    result[i] = f(*x[i]);
+                }
+        return;
+    }
+#endif
+    for (int i = 0; i < n; i++) {
+        RandomSeed(seeds[i]);
+        result[i] = f(*x[i]);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Evaluate --- result[i] = f(pop[i]) for all candidates
+//
+void EvaluationPool::Evaluate(opt_function_t f,
+                              const std::vector<ParameterVector> &pop,
+                              std::vector<double> &result)
+{
+    EvaluationCache *c = EvaluationCache::Active(f);
+    if (c) {
+        Evaluate(*c, pop, result);
+        return;
+    }
+    const int n = pop.size();
+    std::vector<const ParameterVector *> x(n);
+    std::vector<long> seeds(n);
+    for (int i = 0; i < n; i++) {       // seed of candidate i: count+i
+        x[i] = &pop[i];
+        seeds[i] = seed + count + i;
+    }
+    count += n;
+    Run(f, x, seeds, result);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Evaluate --- evaluation using cache
+// rounds of parallel runs: missing replications (up to minrep), then
+// one more replication of the best point and all points not
+// significantly different from it (see EvaluationCache::operator())
+// failed run marks the entry (FAILED is not stored as replication)
+//
+void EvaluationPool::Evaluate(EvaluationCache &c,
+                              const std::vector<ParameterVector> &pop,
+                              std::vector<double> &result)
+{
+    typedef EvaluationCache::Entry Entry;
+    const int n = pop.size();
+    std::vector<Entry *> e(n);
+    for (int i = 0; i < n; i++)
+        e[i] = &c.Lookup(pop[i]);
+    c.calls += n;
+    for (;;) {
+        std::vector<Entry *> job;       // one replication of each
+        std::vector<const ParameterVector *> x;
+        std::vector<long> seeds;
+        Entry *b = c.best;              // the best of cache and generation
+        for (int i = 0; i < n; i++)
+            if (!e[i]->failed && e[i]->y.size() >= c.minrep &&
+                (!b || e[i]->Mean() < b->Mean()))
+                b = e[i];
+        for (int i = 0; i < n; i++) {
+            Entry *p = e[i];
+            if (p->failed)
+                continue;
+            if (p->y.size() < c.minrep)
+                AddJob(job, p);
+            else if (p != b && c.Ambiguous(*p, *b)) {
+                // the one with less replications, both if equal
+                if (p->y.size() <= b->y.size())
+                    AddJob(job, p);
+                if (b->y.size() <= p->y.size())
+                    AddJob(job, b);
+            }
+        }
+        if (job.empty())
+            break;
+        for (unsigned j = 0; j < job.size(); j++) {
+            x.push_back(&job[j]->p);
+            seeds.push_back(c.seed + job[j]->y.size());
+        }
+        std::vector<double> r;
+        Run(c.f, x, seeds, r);
+        for (unsigned j = 0; j < job.size(); j++) {
+            if (r[j] >= FAILED) {
+                job[j]->failed = true;  // no result, no more runs
+                continue;
+            }
+            job[j]->y.push_back(r[j]);
+            job[j]->sum += r[j];
+        }
+        c.runs += job.size();
+        count += job.size();
+    }
+    result.resize(n);
+    for (int i = 0; i < n; i++) {
+        c.UpdateBest(*e[i]);
+        result[i] = e[i]->Mean();
+    }
+}
+
+}
+// end
@@ -0,0 +1,253 @@
+/////////////////////////////////////////////////////////////////////////////
+//! \file opt-sens.cc  Global sensitivity analysis (Sobol, Morris)
+//
+// Copyright (c) 2026 agent <agent@local>
+//
+// This library is licensed under GNU Library GPL. See the file COPYING.
+//
+
+// EXPERIMENTAL
+// sensitivity of f to parameters in their ranges
+//  - Sobol indices: Saltelli design, first order estimator
+//    S_i = mean(fB*(fABi-fA))/V, total ST_i = mean((fA-fABi)^2)/(2V)
+//  A. Saltelli et al.: Variance based sensitivity analysis of model
+//  output. Design and estimator for the total sensitivity index, 2010
+//  - Morris elementary effects with radial sign (step down at upper end)
+//  F. Campolongo et al.: An effective screening design for sensitivity
+//  analysis of large models, 2007
+
+#include "simlib.h"
+#include "internal.h"
+#include "optimize.h"
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+namespace simlib3 {
+
+SIMLIB_IMPLEMENTATION;
+
+typedef std::vector<double> vec;
+
+//////////////////////////////////////////////////////////////////////////////
+// LatinHypercube --- m points in [0,1)^k, row by row
+//
+static void LatinHypercube(RandomStream &rs, unsigned m, int k, vec &u)
+{
+    u.resize(m * k);
+    std::vector<unsigned> perm(m);
+    for (int i = 0; i < k; i++) {
+        for (unsigned j = 0; j < m; j++)
+            perm[j] = j;
+        for (unsigned j = m - 1; j > 0; j--) {
+            unsigned r = unsigned(rs.Random() * (j + 1));
+            std::swap(perm[j], perm[r]);
+        }
+        for (unsigned j = 0; j < m; j++)
+            u[j * k + i] = (perm[j] + rs.Random()) / m;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Quantile --- q-quantile of sorted values (linear interpolation)
+//
+static double Quantile(const vec &x, double q)
+{
+    double h = q * (x.size() - 1);
+    unsigned i = unsigned(h);
+    if (i + 1 >= x.size())
+        return x.back();
+    return x[i] + (h - i) * (x[i + 1] - x[i]);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// constructor
+//
+SensitivityAnalysis::SensitivityAnalysis(opt_function_t _f,
+                                         const ParameterVector &_p,
+                                         int w, long s):
+    f(_f), p(_p), workers(w), seed(s), runs(0)
+{
+    if (p.size() <= 0)
+        SIMLIB_error("SensitivityAnalysis: no parameters");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Evaluate --- result[j] = f(point j of u), m points in normalized units
+// new pool for each matrix: point j gets seed+j
+//
+void SensitivityAnalysis::Evaluate(const vec &u, unsigned m, vec &result)
+{
+    const int k = p.size();
+    std::vector<ParameterVector> pop(m, p);
+    for (unsigned j = 0; j < m; j++)
+        for (int i = 0; i < k; i++)
+            pop[j][i] = p[i].Min() + p[i].Range() * u[j * k + i];
+    EvaluationPool pool(workers, seed);
+    pool.Evaluate(f, pop, result);
+    runs += m;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Sobol --- first order and total indices of all parameters
+//  N -- number of rows of base matrices, N*(k+2) runs
+//  bootstrap -- number of resamples for confidence intervals (0: none)
+//
+void SensitivityAnalysis::Sobol(unsigned N, unsigned bootstrap,
+                                double confidence)
+{
+    const int k = p.size();
+    if (N < 2)
+        SIMLIB_error("SensitivityAnalysis::Sobol: N < 2");
+    if (confidence <= 0 || confidence >= 1)
+        SIMLIB_error("SensitivityAnalysis::Sobol: bad confidence level");
+    RandomStream rs(seed);      // own generator (model uses the base one)
+    vec A, B, fA, fB;
+    LatinHypercube(rs, N, k, A);
+    LatinHypercube(rs, N, k, B);
+    Evaluate(A, N, fA);
+    Evaluate(B, N, fB);
+    std::vector<vec> fAB(k);
+    vec AB(A);
+    for (int i = 0; i < k; i++) {       // A with column i from B
+        for (unsigned j = 0; j < N; j++)
+            AB[j * k + i] = B[j * k + i];
+        Evaluate(AB, N, fAB[i]);
+        for (unsigned j = 0; j < N; j++)
+            AB[j * k + i] = A[j * k + i];
+    }
+    // estimates for rows idx (all rows or bootstrap resample)
+    std::vector<unsigned> idx(N);
+    for (unsigned j = 0; j < N; j++)
+        idx[j] = j;
+    vec s(k), st(k);
+    std::vector<vec> bs(k), bst(k);
+    for (unsigned b = 0; b <= bootstrap; b++) {
+        if (b > 0)
+            for (unsigned j = 0; j < N; j++)
+                idx[j] = unsigned(rs.Random() * N);
+        double m = 0, v = 0;            // variance of fA and fB
+        for (unsigned j = 0; j < N; j++)
+            m += fA[idx[j]] + fB[idx[j]];
+        m /= 2 * N;
+        for (unsigned j = 0; j < N; j++)
+            v += (fA[idx[j]] - m) * (fA[idx[j]] - m) +
+                 (fB[idx[j]] - m) * (fB[idx[j]] - m);
+        v /= 2 * N - 1;
+        for (int i = 0; i < k; i++) {
+            double s1 = 0, s2 = 0;
+            for (unsigned j = 0; j < N; j++) {
+                unsigned r = idx[j];
+                s1 += fB[r] * (fAB[i][r] - fA[r]);
+                s2 += (fA[r] - fAB[i][r]) * (fA[r] - fAB[i][r]);
+            }
+            double si = (v > 0) ? s1 / N / v : 0;
+            double sti = (v > 0) ? s2 / (2 * N) / v : 0;
+            if (b == 0) {
+                s[i] = si;
+                st[i] = sti;
+            } else {
+                bs[i].push_back(si);
+                bst[i].push_back(sti);
+            }
+        }
+    }
+    S = s;
+    ST = st;
+    Slo = Shi = s;
+    STlo = SThi = st;
+    if (bootstrap > 0)
+        for (int i = 0; i < k; i++) {   // percentile intervals
+            const double a = (1 - confidence) / 2;
+            std::sort(bs[i].begin(), bs[i].end());
+            std::sort(bst[i].begin(), bst[i].end());
+            Slo[i] = Quantile(bs[i], a);
+            Shi[i] = Quantile(bs[i], 1 - a);
+            STlo[i] = Quantile(bst[i], a);
+            SThi[i] = Quantile(bst[i], 1 - a);
+        }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Morris --- elementary effects on r trajectories
+//  levels -- number of grid levels (even), step levels/(2*(levels-1))
+//
+void SensitivityAnalysis::Morris(unsigned r, unsigned levels)
+{
+    const int k = p.size();
+    if (r < 2 || levels < 2)
+        SIMLIB_error("SensitivityAnalysis::Morris: r < 2 or levels < 2");
+    RandomStream rs(seed + 1);
+    const double delta = levels / (2.0 * (levels - 1));
+    // points of trajectories: step m of trajectory t at row m*r+t
+    vec u((k + 1) * r * k);
+    std::vector<int> order(r * k);      // parameter changed in step
+    std::vector<int> perm(k);
+    for (unsigned t = 0; t < r; t++) {
+        double *x = &u[t * k];
+        for (int i = 0; i < k; i++) {
+            x[i] = unsigned(rs.Random() * levels) / double(levels - 1);
+            perm[i] = i;
+        }
+        for (int i = k - 1; i > 0; i--)
+            std::swap(perm[i], perm[unsigned(rs.Random() * (i + 1))]);
+        for (int m = 0; m < k; m++) {
+            const double *prev = &u[(m * r + t) * k];
+            double *next = &u[((m + 1) * r + t) * k];
+            std::copy(prev, prev + k, next);
+            int i = perm[m];
+            next[i] += (next[i] + delta <= 1 + 1e-12) ? delta : -delta;
+            order[t * k + m] = i;
+        }
+    }
+    // evaluation by steps: trajectory t is evaluated after seed+t
+    vec y((k + 1) * r);
+    for (int m = 0; m <= k; m++) {
+        vec um(u.begin() + m * r * k, u.begin() + (m + 1) * r * k), ym;
+        Evaluate(um, r, ym);
+        std::copy(ym.begin(), ym.end(), y.begin() + m * r);
+    }
+    mu.assign(k, 0.0);
+    mustar.assign(k, 0.0);
+    sigma.assign(k, 0.0);
+    vec sum2(k, 0.0);
+    for (unsigned t = 0; t < r; t++)
+        for (int m = 0; m < k; m++) {
+            int i = order[t * k + m];
+            double dx = u[((m + 1) * r + t) * k + i] - u[(m * r + t) * k + i];
+            double ee = (y[(m + 1) * r + t] - y[m * r + t]) / dx;
+            mu[i] += ee / r;
+            mustar[i] += fabs(ee) / r;
+            sum2[i] += ee * ee;
+        }
+    for (int i = 0; i < k; i++) {
+        double v = (sum2[i] - r * mu[i] * mu[i]) / (r - 1);
+        sigma[i] = v > 0 ? sqrt(v) : 0;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Print --- table of computed indices
+//
+void SensitivityAnalysis::Print() const
+{
+    ::Print("# sensitivity analysis: %d parameters, %lu runs\n",
+            p.size(), runs);
+    if (!S.empty()) {
+        ::Print("# %-12s %20s %20s\n", "parameter", "first order (CI)",
+                "total (CI)");
+        for (int i = 0; i < p.size(); i++)
+            ::Print("# %-12s %6.3f (%6.3f %6.3f) %6.3f (%6.3f %6.3f)\n",
+                    p[i].Name(), S[i], Slo[i], Shi[i], ST[i], STlo[i], SThi[i]);
+    }
+    if (!mu.empty()) {
+        ::Print("# %-12s %12s %12s %12s\n", "parameter", "mu", "mu*", "sigma");
+        for (int i = 0; i < p.size(); i++)
+            ::Print("# %-12s %12.5g %12.5g %12.5g\n",
+                    p[i].Name(), mu[i], mustar[i], sigma[i]);
+    }
+}
+
+}
+// end
@@ -12,6 +12,9 @@
 #ifndef __SIMLIB_OPTIMIZE_H
 #define __SIMLIB_OPTIMIZE_H
 
+#include <vector>
+#include <map>
+
 namespace simlib3 {
 
 class Param
@@ -91,6 +94,162 @@ double Optimize_simann(opt_function_t f, ParameterVector & p, int MAXT);
 double Optimize_gradient(opt_function_t f, ParameterVector & p,
                          double MAXITER);
 
+////////////////////////////////////////////////////////////////////////////
+// evaluation cache with adaptive replication
+//  - results are stored by parameter values quantized to quantum*Range()
+//    (repeated probes of the same point do not run the simulation)
+//  - replication r of any point runs after RandomSeed(seed+r)
+//    (common random numbers: paired comparison of points)
+//  - each point gets minrep replications; while the difference to the
+//    best point is not significant (paired t-test, z=2), both points
+//    get more replications up to maxrep
+//  - runs are saved only compared to fixed replication (maxrep runs of
+//    each point): in optimize-test adaptive Hooke-Jeeves needs 199 runs,
+//    fixed 20 replications 360 runs, but one run per point only 24 runs
+//    (with noisy result)
+//  - point with failed evaluation in EvaluationPool (e.g. exit of
+//    worker) is marked, its result is 1e30 and it is not run again
+//  - usage:  EvaluationCache c(f, 1e-6, 3, 20);
+//            Optimize_hooke(c.Function(), p, ...);
+//    only one cache can be active (the last one which called Function())
+//
+class EvaluationCache
+{
+    struct Entry {
+        ParameterVector p;      // the first point evaluated in cell
+        std::vector<double> y;  // results of replications 0, 1, ...
+        double sum;
+        bool failed;            // evaluation failed: no more runs
+        Entry(const ParameterVector &x): p(x), sum(0), failed(false) { }
+        double Mean() const {
+            return (failed || y.empty()) ? 1e30 : sum / y.size();
+        }
+    };
+    typedef std::map<std::vector<long>, Entry> map_t;
+    opt_function_t f;
+    double quantum;             // relative size of cell
+    unsigned minrep, maxrep;
+    long seed;
+    map_t cache;
+    Entry *best;                // best point evaluated
+    unsigned long calls, runs;  // statistics
+    static EvaluationCache *active;
+    static double Call(const ParameterVector &p);
+    std::vector<long> Key(const ParameterVector &p) const;
+    Entry &Lookup(const ParameterVector &p);
+    void Run(Entry &e);         // next replication
+    bool Ambiguous(const Entry &a, const Entry &b) const;
+    void UpdateBest(Entry &e);
+    friend class EvaluationPool;
+  public:
+    EvaluationCache(opt_function_t f, double quantum = 1e-6,
+                    unsigned minrep = 1, unsigned maxrep = 1,
+                    long seed = 1234567);
+    ~EvaluationCache();
+    double operator () (const ParameterVector &p); // mean of replications
+    opt_function_t Function();  // activate, use as function to optimize
+    static EvaluationCache *Active(opt_function_t f); // cache behind f
+    void Clear();
+    unsigned long Calls() const { return calls; }  // requests
+    unsigned long Runs() const { return runs; }    // simulation runs
+    unsigned long Points() const { return cache.size(); }
+    unsigned Replications(const ParameterVector &p) const;
+};
+
+////////////////////////////////////////////////////////////////////////////
+// parallel evaluation of a generation of candidates
+//  - simulation uses global state (calendar, time, ...), so parallel
+//    runs are performed by worker processes (fork), sequentially if
+//    processes are not available or workers==1
+//  - candidate i of generation is evaluated after RandomSeed(seed+k),
+//    where k is the number of evaluation (results do not depend on
+//    the number of workers)
+//  - failed evaluation (e.g. exit of worker) gives result 1e30,
+//    cache entry of the point is marked failed (result is not stored)
+//  - if f is EvaluationCache::Function(), only missing replications
+//    are run in parallel (seeds given by the cache)
+//
+class EvaluationPool
+{
+    int workers;                // number of worker processes
+    long seed;                  // base seed of model generator
+    unsigned long count;        // number of evaluations
+    void Run(opt_function_t f, const std::vector<const ParameterVector *> &x,
+             const std::vector<long> &seeds, std::vector<double> &result);
+    void Evaluate(EvaluationCache &c, const std::vector<ParameterVector> &pop,
+                  std::vector<double> &result);
+  public:
+    EvaluationPool(int workers = 0, long seed = 1234567); // 0: all CPUs
+    void Evaluate(opt_function_t f, const std::vector<ParameterVector> &pop,
+                  std::vector<double> &result);
+    int Workers() const { return workers; }
+    unsigned long Evaluations() const { return count; }
+};
+
+// Population-based methods (generations evaluated by EvaluationPool)
+//  maxgen -- number of generations
+//  lambda, np -- population size (0: default by dimension)
+double Optimize_cmaes(opt_function_t f, ParameterVector & p, int maxgen,
+                      int lambda = 0, int workers = 0);
+
+double Optimize_de(opt_function_t f, ParameterVector & p, int maxgen,
+                   int np = 0, int workers = 0);
+
+// Bayesian optimization (Gaussian process surrogate, expected improvement)
+// for expensive functions
+//  maxeval -- total number of evaluations of f (at least 1)
+//  batch -- number of points selected together (0: number of workers)
+double Optimize_bayes(opt_function_t f, ParameterVector & p, int maxeval,
+                      int batch = 0, int workers = 0);
+
+////////////////////////////////////////////////////////////////////////////
+// global sensitivity analysis of f over ranges of parameters
+//  - Sobol(N): variance-based indices from Saltelli design: matrices A, B
+//    (N points, Latin hypercube) and A with column i from B for each
+//    parameter i, N*(k+2) runs; first order (Saltelli 2010) and total
+//    (Jansen) indices from the same runs, confidence intervals by
+//    bootstrap of rows (no more runs)
+//  - Morris(r): elementary effects on r trajectories in grid of levels,
+//    r*(k+1) runs; mean, mean of absolute values and standard deviation
+//    (effects in units of Range() of parameter)
+//  - runs by EvaluationPool; row j of all matrices (trajectory j) is
+//    evaluated after RandomSeed(seed+j) (common random numbers)
+//  - usage:  SensitivityAnalysis sa(f, p);
+//            sa.Sobol(1000);  sa.Print();
+//
+class SensitivityAnalysis
+{
+    opt_function_t f;
+    ParameterVector p;
+    int workers;
+    long seed;
+    unsigned long runs;
+    std::vector<double> S, Slo, Shi;    // first order indices + CI
+    std::vector<double> ST, STlo, SThi; // total indices + CI
+    std::vector<double> mu, mustar, sigma; // Morris statistics
+    void Evaluate(const std::vector<double> &u, unsigned m,
+                  std::vector<double> &result);
+  public:
+    SensitivityAnalysis(opt_function_t f, const ParameterVector &p,
+                        int workers = 0, long seed = 1234567);
+    void Sobol(unsigned N, unsigned bootstrap = 200, double confidence = 0.95);
+    void Morris(unsigned r, unsigned levels = 4);
+    int Size() const { return p.size(); }
+    unsigned long Runs() const { return runs; }    // all runs of f
+    // Sobol indices of parameter i
+    double First(int i) const { return S[i]; }
+    double FirstLow(int i) const { return Slo[i]; }
+    double FirstHigh(int i) const { return Shi[i]; }
+    double Total(int i) const { return ST[i]; }
+    double TotalLow(int i) const { return STlo[i]; }
+    double TotalHigh(int i) const { return SThi[i]; }
+    // Morris statistics of parameter i
+    double Mu(int i) const { return mu[i]; }
+    double MuStar(int i) const { return mustar[i]; }
+    double Sigma(int i) const { return sigma[i]; }
+    void Print() const;
+};
+
 }
 
 #endif // __SIMLIB_OPTIMIZE_H
@@ -29,6 +29,30 @@ namespace simlib3 {
 
 SIMLIB_IMPLEMENTATION;
 
+////////////////////////////////////////////////////////////////////////////
+//  BatchMeans::Output
+//
+void BatchMeans::Output() const
+{
+  char s[100];
+  Print("+----------------------------------------------------------+\n");
+  Print("| BATCH MEANS %-44s |\n", Name());
+  Print("+----------------------------------------------------------+\n");
+  sprintf(s, " Intervals = %u  (step %g) ", Intervals(), step);
+  Print("| %-56s |\n", s);
+  if (obs.size() > 0) {
+    sprintf(s, " End of warm-up = %g ", WarmUpTime());
+    Print("| %-56s |\n", s);
+    sprintf(s, " Mean = %g +- %g  (%g%%, %u batches) ",
+            mean, halfwidth, level * 100, nbatches);
+    Print("| %-56s |\n", s);
+    sprintf(s, " Relative precision %g %s ", precision,
+            precise ? "reached" : "NOT reached");
+    Print("| %-56s |\n", s);
+  }
+  Print("+----------------------------------------------------------+\n");
+}
+
 ////////////////////////////////////////////////////////////////////////////
 //  Facility::Output
 //
@@ -104,6 +128,54 @@ void Histogram::Output() const
   Print("\n");
 }
 
+////////////////////////////////////////////////////////////////////////////
+//  LogHistogram::Output
+//
+void LogHistogram::Output() const
+{
+  Print("+----------------------------------------------------------+\n");
+  Print("| LOG HISTOGRAM %-42s |\n",Name());
+  Print("+----------------------------------------------------------+\n");
+  char s[100];
+  sprintf(s," Unit = %g, precision = %u bits ", unit, prec);
+  Print("| %-56s |\n",s);
+  if (n==0)
+  {
+    Print("|  no record                                               |\n");
+    Print("+----------------------------------------------------------+\n");
+    return;
+  }
+  Print(  "|  Min = %-15g         Max = %-15g     |\n", Min(), Max());
+  Print(  "|  Number of records = %-26ld          |\n", n);
+  Print(  "|  Average value = %-25g               |\n", MeanValue());
+  Print("+------------+------------+----------+----------+----------+\n");
+  Print("|    from    |     to     |     n    |   rel    |   sum    |\n");
+  Print("+------------+------------+----------+----------+----------+\n");
+  const unsigned m = 1u << prec;
+  unsigned long cum = 0;
+  for (int k = 0; k < int(2*nblocks); k++)
+  {
+    bool neg = k < int(nblocks);  // negative values first
+    unsigned b = neg ? nblocks - 1 - k : k - nblocks;
+    const unsigned long *bp = blocks[neg ? b : nblocks + b];
+    if (!bp)
+      continue;
+    for (unsigned j = 0; j < m; j++)
+    {
+      unsigned i = neg ? m - 1 - j : j;
+      if (bp[i]==0)
+        continue;
+      cum += bp[i];
+      double from = Bound(b, i), to = Bound(b, i+1);
+      if (neg) { double t = from; from = -to; to = (t == 0) ? 0 : -t; }
+      Print("| %10.4g | %10.4g | %8lu | %8.6f | %8.6f |\n",
+            from, to, bp[i], (double)bp[i]/n, (double)cum/n);
+    }
+  }
+  Print("+------------+------------+----------+----------+----------+\n");
+  Print("\n");
+}
+
 ////////////////////////////////////////////////////////////////////////////
 //  Process::Output
 //
@@ -144,6 +216,15 @@ void Queue::Output() const
       if (StatDT.Number()>99)
         Print("|  Standard deviation = %-25g          |\n",
                StatDT.StdDev());
+      if (StatDT.Quantiles())
+      {
+        Print("|  Median time = %-25g                 |\n",
+              StatDT.Quantile(0.5));
+        Print("|  90%% quantile of time = %-25g        |\n",
+              StatDT.Quantile(0.9));
+        Print("|  99%% quantile of time = %-25g        |\n",
+              StatDT.Quantile(0.99));
+      }
     }
   }
   Print("+----------------------------------------------------------+\n");
@@ -179,6 +260,12 @@ void Stat::Output() const
     Print(  "|  Average value = %-25g               |\n", MeanValue());
     if (n>99)
       Print("|  Standard deviation = %-25g          |\n", StdDev());
+    if (qs)
+    {
+      Print("|  Median = %-25g                      |\n", Quantile(0.5));
+      Print("|  90%% quantile = %-25g                |\n", Quantile(0.9));
+      Print("|  99%% quantile = %-25g                |\n", Quantile(0.99));
+    }
   }
   Print("+----------------------------------------------------------+\n");
 }
@@ -219,6 +306,57 @@ void Store::Output() const
   Print("\n");
 }
 
+////////////////////////////////////////////////////////////////////////////
+//  MultiFacility::Output
+//
+void MultiFacility::Output() const
+{
+  char s[100];
+  Print("+----------------------------------------------------------+\n");
+  Print("| MULTIFACILITY %-42s |\n",Name());
+  Print("+----------------------------------------------------------+\n");
+  sprintf(s," Servers = %u  (%u busy, %u free) ", Size(), Used(), Free());
+  Print("| %-56s |\n",s);
+  if (tstat.Number()>0)
+  {
+    sprintf(s," Time interval = %g - %g ",tstat.StartTime(), (double)Time);
+    Print(  "| %-56s |\n", s);
+    Print(  "|  Number of requests = %-28ld       |\n", tstat.Number());
+    if (Time>tstat.StartTime())
+    {
+      Print("|  Average busy servers = %-26g       |\n", tstat.MeanValue());
+      double umin = 1, umax = 0;
+      for (unsigned i=0; i<n; i++)
+      {
+        double u = stat[i].MeanValue();
+        if (u<umin) umin = u;
+        if (u>umax) umax = u;
+      }
+      Print("|  Server utilization = %-9g - %-9g               |\n",
+            umin, umax);
+      if (n<=16)  // small facility: all servers
+        for (unsigned i=0; i<n; i++)
+        {
+          sprintf(s,"  server %u: requests = %lu, utilization = %g ",
+                  i, stat[i].Number(), stat[i].MeanValue());
+          Print("| %-56s |\n",s);
+        }
+    }
+  }
+  Print("+----------------------------------------------------------+\n");
+  if (OwnQueue())
+  {
+    if (Q->StatN.Number()>0) // used
+    {
+      Print("  Input queue '%s.Q'\n", Name());
+      Q->Output();
+    }
+  }
+  else
+    Print("  External input queue '%s'\n",Q->Name());
+  Print("\n");
+}
+
 ////////////////////////////////////////////////////////////////////////////
 //  TStat::Output
 //
@@ -237,7 +375,15 @@ void TStat::Output() const
     Print(  "| %-56s |\n", s);
     Print(  "|  Number of records = %-26ld          |\n", n);
     if (Time>t0)
+    {
       Print("|  Average value = %-25g               |\n", MeanValue());
+      if (qs)
+      {
+        Print("|  Median = %-25g                      |\n", Quantile(0.5));
+        Print("|  90%% quantile = %-25g                |\n", Quantile(0.9));
+        Print("|  99%% quantile = %-25g                |\n", Quantile(0.99));
+      }
+    }
   }
   Print("+----------------------------------------------------------+\n");
 }
@@ -343,6 +343,23 @@ void Process::Release(Facility & f)
     f.Release(this);            // polymorphic interface
 }
 
+////////////////////////////////////////////////////////////////////////////
+/// Seize a server of multi-server facility f
+/// possibly waiting in input queue, if all servers are busy
+/// returns the index of server
+unsigned Process::Seize(MultiFacility & f, ServicePriority_t sp /* = 0 */ )
+{
+    return f.Seize(this, sp);   // polymorphic interface
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// Release server of multi-server facility f
+/// possibly activate first waiting entity in queue
+void Process::Release(MultiFacility & f)
+{
+    f.Release(this);            // polymorphic interface
+}
+
 ////////////////////////////////////////////////////////////////////////////
 /// Enter - use cap capacity of store s
 /// possibly waiting in input queue, if not enough free capacity
@@ -26,12 +26,16 @@ SIMLIB_IMPLEMENTATION;
 ////////////////////////////////////////////////////////////////////////////
 //  constructors
 //
-Queue::Queue()
+Queue::Queue() :
+  sortkey(UNSORTED),
+  indexed(true)
 {
   Dprintf(("Queue{%p}::Queue()", this));
 }
 
-Queue::Queue(const char *name)
+Queue::Queue(const char *name) :
+  sortkey(UNSORTED),
+  indexed(true)
 {
   Dprintf(("Queue{%p}::Queue(\"%s\")", this, name));
   SetName(name);
@@ -45,28 +49,66 @@ Queue::~Queue() {
 }
 
 ////////////////////////////////////////////////////////////////////////////
-// Insert --- priority insert into queue
+// Key --- sort key of entity (higher is first)
 //
-void Queue::Insert(Entity *ent)
+long Queue::Key(Entity *e, SortKey k)
 {
-  Dprintf(("%s::Insert(%s)", Name(), ent->Name() ));
-  Entity::Priority_t prio = ent->Priority;
-  // find (higher priority is first)
-#if 0 // _INS_FROM_BEGIN
-  Queue::iterator p = begin();
-  for( ; p!=end() && ((Entity*)(*p))->Priority >= prio; ++p);
-#else
-  // this is faster (items are inserted at end usually)
+  long key = e->Priority;
+  if(k == BY_SERVICE_PRIORITY)   // service priority first (Facility)
+    key += long(e->_SPrio) << 8;
+  return key;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// ResetIndex --- empty queue: sorted again
+//
+void Queue::ResetIndex()
+{
+  tails.clear();
+  indexed = true;
+  sortkey = UNSORTED;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// SortedIns --- insert after the last entity with key >= key of ent
+//
+void Queue::SortedIns(Entity *ent, SortKey k)
+{
+  if(k != sortkey) {
+    if(empty())
+      sortkey = k;               // first sorted insert
+    else
+      indexed = false;           // mixed ordering: no index
+  }
   Queue::iterator p = end();
-  while(p!=begin()) {
-        Queue::iterator q = p;
-        --p;
-        if( ((Entity*)(*p))->Priority >= prio ) { p = q; break; }
+  const long key = Key(ent, k);
+  if(indexed) {
+    // the tail of smallest key >= key --- O(log P)
+    std::map<long,Link*>::iterator t = tails.lower_bound(key);
+    if(t == tails.end())
+      p = begin();
+    else
+      p = ++Queue::iterator(t->second);
+  } else {
+    // this is faster (items are inserted at end usually)
+    while(p!=begin()) {
+      Queue::iterator q = p;
+      --p;
+      if( Key((Entity*)(*p), k) >= key ) { p = q; break; }
+    }
   }
-#endif
   PredIns(ent,p); // works for end()
 }
 
+////////////////////////////////////////////////////////////////////////////
+// Insert --- priority insert into queue
+//
+void Queue::Insert(Entity *ent)
+{
+  Dprintf(("%s::Insert(%s)", Name(), ent->Name() ));
+  SortedIns(ent, BY_PRIORITY);   // higher priority is first
+}
+
 ////////////////////////////////////////////////////////////////////////////
 // InsFirst --- insert at first position (special case)
 //
@@ -105,6 +147,19 @@ void Queue::PredIns(Entity *ent, iterator pos)
   List::PredIns(ent, *pos); // insert before pos, can be end()
   ent->_MarkTime = Time;    // marks input time
   StatN(size());            // length statistic
+  if(indexed && sortkey != UNSORTED) {  // update index
+    const long key = ent->_QueueKey = Key(ent, sortkey);
+    Link *pred = *--iterator(ent);
+    Link *succ = *++iterator(ent);
+    // keys of entities in queue are stored at insertion
+    if((pred != this && ((Entity*)pred)->_QueueKey < key) ||
+       (succ != this && ((Entity*)succ)->_QueueKey > key)) {
+      indexed = false;          // order is broken
+      tails.clear();
+    }
+    else if(succ == this || ((Entity*)succ)->_QueueKey != key)
+      tails[key] = ent;         // the last entity with the key
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -133,9 +188,22 @@ Entity *Queue::GetLast()
 Entity *Queue::Get(iterator pos)
 {
   Dprintf(("%s::Get(pos:%p)", Name(), *pos));
+  Link *pred = *--iterator(*pos);
   Entity *ent = (Entity*) List::Get(*pos);
   StatDT(double(Time) - ent->_MarkTime);
   StatN(size());  StatN.n--; // correction !!!
+  if(empty())
+    ResetIndex();
+  else if(indexed && sortkey != UNSORTED) {  // update index
+    const long key = ent->_QueueKey;    // key at insertion --- O(log P)
+    std::map<long,Link*>::iterator t = tails.find(key);
+    if(t != tails.end() && t->second == ent) {
+      if(pred != this && ((Entity*)pred)->_QueueKey == key)
+        t->second = pred;       // new last entity with the key
+      else
+        tails.erase(t);
+    }
+  }
   return ent;
 }
 
@@ -148,6 +216,7 @@ void Queue::clear()
   StatN.Clear();
   StatDT.Clear();
   List::clear(); // problem with WARNING
+  ResetIndex();
   StatN.Clear();
   StatDT.Clear();
 }
@@ -108,6 +108,162 @@ void SetBaseRandomGenerator(double (*new_gen)())
     SIMLIB_RandomBasePtr = SIMLIB_RandomBase; // default value
 }
 
+
+////////////////////////////////////////////////////////////////////////////
+// RandomStream --- xoshiro256** generator with substreams
+//
+// see: D. Blackman, S. Vigna: Scrambled linear pseudorandom number
+//      generators (2018), period 2^256-1
+//
+
+typedef unsigned long long u64;
+
+/// polynomials for jump ahead: 2^128 and 2^192 numbers
+static const u64 JUMP[4] = {
+  0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+  0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+static const u64 LONG_JUMP[4] = {
+  0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL,
+  0x77710069854ee241ULL, 0x39109bb02acbe635ULL };
+
+static inline u64 rotl(u64 x, int k)
+{
+  return (x << k) | (x >> (64 - k));
+}
+
+/// single step of xoshiro256**
+static inline u64 SIMLIB_Step(u64 *st)
+{
+  const u64 r = rotl(st[1] * 5, 7) * 9;
+  const u64 t = st[1] << 17;
+  st[2] ^= st[0]; st[3] ^= st[1]; st[1] ^= st[2]; st[0] ^= st[3];
+  st[2] ^= t;
+  st[3] = rotl(st[3], 45);
+  return r;
+}
+
+/// jump ahead: st = st advanced by polynomial
+static void SIMLIB_Jump(u64 *st, const u64 *poly)
+{
+  u64 t[4] = { 0, 0, 0, 0 };
+  for(int i=0; i<4; i++)
+    for(int b=0; b<64; b++) {
+      if(poly[i] & (1ULL << b))
+        for(int k=0; k<4; k++)
+          t[k] ^= st[k];
+      SIMLIB_Step(st);
+    }
+  for(int k=0; k<4; k++)
+    st[k] = t[k];
+}
+
+/// start of next stream created by default constructor
+static u64 SIMLIB_NextStream[4];
+static bool SIMLIB_NextStreamOK = false;  // static initialization
+
+static void SIMLIB_SplitMix(u64 seed, u64 *st)
+{
+  for(int k=0; k<4; k++) {
+    u64 z = (seed += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    st[k] = z ^ (z >> 31);
+  }
+}
+
+void RandomStream::SetPackageSeed(unsigned long long seed)
+{
+  SIMLIB_SplitMix(seed, SIMLIB_NextStream);
+  SIMLIB_NextStreamOK = true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// RandomStream --- constructors
+//
+RandomStream::RandomStream() :
+  pos(BUFSIZE)
+{
+  if(!SIMLIB_NextStreamOK)
+    SetPackageSeed(INICONST);
+  for(int k=0; k<4; k++)
+    begin[k] = start[k] = s[k] = SIMLIB_NextStream[k];
+  SIMLIB_Jump(SIMLIB_NextStream, LONG_JUMP);    // streams do not overlap
+}
+
+RandomStream::RandomStream(unsigned long long seed)
+{
+  Seed(seed);
+}
+
+void RandomStream::Seed(unsigned long long seed)
+{
+  SIMLIB_SplitMix(seed, s);
+  for(int k=0; k<4; k++)
+    begin[k] = start[k] = s[k];
+  pos = BUFSIZE;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// RandomStream::Refill --- prefetch numbers (cheap inline Next())
+//
+void RandomStream::Refill()
+{
+  u64 st[4] = { s[0], s[1], s[2], s[3] };      // state in registers
+  for(int i=0; i<BUFSIZE; i++)
+    buf[i] = SIMLIB_Step(st);
+  for(int k=0; k<4; k++)
+    s[k] = st[k];
+  pos = 0;
+}
+
+void RandomStream::Reset()
+{
+  for(int k=0; k<4; k++)
+    start[k] = s[k] = begin[k];
+  pos = BUFSIZE;                       // discard prefetched numbers
+}
+
+void RandomStream::ResetSubstream()
+{
+  for(int k=0; k<4; k++)
+    s[k] = start[k];
+  pos = BUFSIZE;
+}
+
+void RandomStream::NextSubstream()
+{
+  SIMLIB_Jump(start, JUMP);
+  ResetSubstream();
+}
+
+void RandomStream::Jump()
+{
+  SIMLIB_Jump(s, JUMP);
+  pos = BUFSIZE;
+}
+
+void RandomStream::LongJump()
+{
+  SIMLIB_Jump(s, LONG_JUMP);
+  pos = BUFSIZE;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// SetBaseRandomStream --- use the stream for Random()
+//
+static RandomStream *SIMLIB_BaseStream = 0;
+
+static double SIMLIB_RandomStreamBase()
+{
+  return SIMLIB_BaseStream->Random();
+}
+
+void SetBaseRandomStream(RandomStream *s)
+{
+  SIMLIB_BaseStream = s;
+  SetBaseRandomGenerator(s ? SIMLIB_RandomStreamBase : 0);
+}
+
 }
 // end
 
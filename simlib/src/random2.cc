@@ -223,6 +223,49 @@ double Rayle(double delta)
   return  delta * sqrt(-log(R));
 }
 
+////////////////////////////////////////////////////////////////////////////
+//  uniform number sources for algorithms shared by global functions
+//  and RandomStream methods
+//
+struct BaseGenerator {
+  double operator()() { return Random(); }
+};
+struct StreamGenerator {
+  RandomStream &s;
+  StreamGenerator(RandomStream &_s): s(_s) {}
+  double operator()() { return s.Random(); }
+};
+
+////////////////////////////////////////////////////////////////////////////
+//  PoissonPTRS --- transformed rejection with squeeze, lambda >= 10
+//
+//  see: W. Hormann: The transformed rejection method for generating
+//       Poisson random variables, Insurance: Math. and Economics 12, 1993
+//
+template <class G>
+static int PoissonPTRS(G &rnd, double lambda)
+{
+  const double slam = sqrt(lambda);
+  const double loglam = log(lambda);
+  const double b = 0.931 + 2.53*slam;
+  const double a = -0.059 + 0.02483*b;
+  const double invalpha = 1.1239 + 1.1328/(b-3.4);
+  const double vr = 0.9277 - 3.6224/(b-2);
+  for(;;) {
+    const double U = rnd() - 0.5;
+    const double V = rnd();
+    const double us = 0.5 - fabs(U);
+    const double k = floor((2*a/us + b)*U + lambda + 0.43);
+    if(us >= 0.07 && V <= vr)
+      return int(k);                   // squeeze: fast acceptance
+    if(k < 0 || (us < 0.013 && V > us))
+      continue;
+    if(log(V) + log(invalpha) - log(a/(us*us)+b)
+       <= -lambda + k*loglam - lgamma(k+1))
+      return int(k);
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////
 //  Poisson(double lambda)
 //
@@ -231,7 +274,7 @@ int Poisson(double lambda)
   double Y,X;
   int PSSN = 0;
   if (lambda<=0) SIMLIB_error(PoissonError);
-  if (lambda <= 9.0)
+  if (lambda < 10.0)
   {
     Y=exp(-lambda);
     X=1.0;
@@ -243,10 +286,8 @@ int Poisson(double lambda)
   }
   else
   {
-    double sl=sqrt(lambda);
-    do
-      PSSN = (int) (Normal(lambda, sl) + 0.5);  /* round ???### */
-    while (PSSN<0);
+    BaseGenerator rnd;
+    PSSN = PoissonPTRS(rnd, lambda);  // exact, constant expected time
   }
   return PSSN;
 }
@@ -288,29 +329,435 @@ int HyperGeom(double p, int n, int m)
 }
 
 ////////////////////////////////////////////////////////////////////////////
-//  Binom(n,theta)
-//  n     = # of experiments (pocet pokusu)
-//  theta = probability
-//
-/*
-int Binom(unsigned n, double theta)
-{
-  int BNM;
-  double SUM,R,TT,x;
-  if (theta<0 || theta>1) SIMLIB_error(BinomError);
-  SUM = R = pow(1-theta,n);
-  TT = theta/(1-theta);
-  BNM = 0;
-  x = Random();
-  while(x-SUM > 0)
-  {
-    R *= (n-BNM)/(BNM+1)*TT;
-    SUM += R;
-    BNM++;
+//  RandomStream --- distributions using the stream
+//
+double RandomStream::Uniform(double l, double h)
+{
+  if( l >= h ) SIMLIB_error(BadUniformParam);
+  return l + (h-l)*Random();
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  Ziggurat method tables
+//
+//  see: G. Marsaglia, W. W. Tsang: The Ziggurat Method for Generating
+//       Random Variables, Journal of Statistical Software 5(8), 2000
+//
+static unsigned long zig_kn[128], zig_ke[256];
+static double zig_wn[128], zig_fn[128], zig_we[256], zig_fe[256];
+static bool zig_ok = false;
+
+static void ZigguratInit()
+{
+  const double m1 = 2147483648.0, m2 = 4294967296.0;
+  double dn = 3.442619855899, tn = dn, vn = 9.91256303526217e-3;
+  double de = 7.697117470131487, te = de, ve = 3.949659822581572e-3;
+  double q = vn/exp(-.5*dn*dn);
+  zig_kn[0] = (unsigned long)((dn/q)*m1);  zig_kn[1] = 0;
+  zig_wn[0] = q/m1;  zig_wn[127] = dn/m1;
+  zig_fn[0] = 1.0;   zig_fn[127] = exp(-.5*dn*dn);
+  for(int i=126; i>=1; i--) {
+    dn = sqrt(-2.*log(vn/dn + exp(-.5*dn*dn)));
+    zig_kn[i+1] = (unsigned long)((dn/tn)*m1);  tn = dn;
+    zig_fn[i] = exp(-.5*dn*dn);  zig_wn[i] = dn/m1;
+  }
+  q = ve/exp(-de);
+  zig_ke[0] = (unsigned long)((de/q)*m2);  zig_ke[1] = 0;
+  zig_we[0] = q/m2;  zig_we[255] = de/m2;
+  zig_fe[0] = 1.0;   zig_fe[255] = exp(-de);
+  for(int i=254; i>=1; i--) {
+    de = -log(ve/de + exp(-de));
+    zig_ke[i+1] = (unsigned long)((de/te)*m2);  te = de;
+    zig_fe[i] = exp(-de);  zig_we[i] = de/m2;
+  }
+  zig_ok = true;
+}
+
+/// fast path: the most of numbers (about 99%)
+#define ZIG_NORMAL(hz, iz)  \
+  ((hz = long(int(Next()>>32)), iz = hz&127, \
+    (unsigned long)(hz<0 ? -hz : hz) < zig_kn[iz]) \
+   ? hz*zig_wn[iz] : NormalTail(hz, iz))
+#define ZIG_EXP(jz, iz)  \
+  ((jz = (unsigned long)(Next()>>32), iz = jz&255, jz < zig_ke[iz]) \
+   ? jz*zig_we[iz] : ExponentialTail(jz, iz))
+
+double RandomStream::NormalTail(long hz, unsigned iz)
+{
+  const double r = 3.442620;           // start of the tail
+  for(;;) {
+    double x = hz*zig_wn[iz];
+    if(iz == 0) {                      // base strip: the tail
+      double y;
+      do {
+        x = -log(1.0-Random())*0.2904764;   // 1/r
+        y = -log(1.0-Random());
+      } while(y+y < x*x);
+      return hz>0 ? r+x : -r-x;
+    }
+    if(zig_fn[iz] + Random()*(zig_fn[iz-1]-zig_fn[iz]) < exp(-.5*x*x))
+      return x;
+    hz = long(int(Next()>>32));
+    iz = hz & 127;
+    if((unsigned long)(hz<0 ? -hz : hz) < zig_kn[iz])
+      return hz*zig_wn[iz];
+  }
+}
+
+double RandomStream::ExponentialTail(unsigned long jz, unsigned iz)
+{
+  for(;;) {
+    if(iz == 0)
+      return 7.69711 - log(1.0-Random());
+    const double x = jz*zig_we[iz];
+    if(zig_fe[iz] + Random()*(zig_fe[iz-1]-zig_fe[iz]) < exp(-x))
+      return x;
+    jz = (unsigned long)(Next()>>32);
+    iz = jz & 255;
+    if(jz < zig_ke[iz])
+      return jz*zig_we[iz];
+  }
+}
+
+double RandomStream::Exponential(double mv)
+{
+  if(!zig_ok) ZigguratInit();
+  unsigned long jz;
+  unsigned iz;
+  return mv * ZIG_EXP(jz, iz);
+}
+
+double RandomStream::Normal(double mi, double sigma)
+{
+  if(!zig_ok) ZigguratInit();
+  long hz;
+  unsigned iz;
+  return mi + sigma * ZIG_NORMAL(hz, iz);
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  RandomStream --- bulk generation
+//
+void RandomStream::Random(double *out, unsigned n)
+{
+  for(unsigned i=0; i<n; i++)
+    out[i] = Random();
+}
+
+void RandomStream::Uniform(double l, double h, double *out, unsigned n)
+{
+  if( l >= h ) SIMLIB_error(BadUniformParam);
+  Random(out, n);
+  const double d = h-l;
+  for(unsigned i=0; i<n; i++)          // vectorizable
+    out[i] = l + d*out[i];
+}
+
+void RandomStream::Exponential(double mv, double *out, unsigned n)
+{
+  if(!zig_ok) ZigguratInit();
+  unsigned long jz;
+  unsigned iz;
+  for(unsigned i=0; i<n; i++)
+    out[i] = mv * ZIG_EXP(jz, iz);
+}
+
+void RandomStream::Normal(double mi, double sigma, double *out, unsigned n)
+{
+  if(!zig_ok) ZigguratInit();
+  long hz;
+  unsigned iz;
+  for(unsigned i=0; i<n; i++)
+    out[i] = mi + sigma * ZIG_NORMAL(hz, iz);
+}
+
+void RandomStream::Erlang(double alfa, int beta, double *out, unsigned n)
+{
+  if (beta<1)  SIMLIB_error(ErlangError);
+  if(!zig_ok) ZigguratInit();
+  unsigned long jz;
+  unsigned iz;
+  for(unsigned i=0; i<n; i++) {
+    double sum = 0;                    // sum of beta exponentials
+    for(int k=0; k<beta; k++)
+      sum += ZIG_EXP(jz, iz);
+    out[i] = alfa * sum;
+  }
+}
+
+#undef ZIG_NORMAL
+#undef ZIG_EXP
+
+////////////////////////////////////////////////////////////////////////////
+//  bulk generation using base generator Random()
+//
+//  uniform numbers are taken first, then transformed in separate
+//  loop, the results are the same as from n scalar calls
+//
+void Uniform(double l, double h, double *out, unsigned n)
+{
+  if( l >= h ) SIMLIB_error(BadUniformParam);
+  for(unsigned i=0; i<n; i++)
+    out[i] = Random();
+  const double d = h-l;
+  for(unsigned i=0; i<n; i++)
+    out[i] = l + d*out[i];
+}
+
+void Exponential(double mv, double *out, unsigned n)
+{
+  for(unsigned i=0; i<n; i++)
+    out[i] = Random();
+  for(unsigned i=0; i<n; i++)
+    out[i] = -mv * std::log(out[i]);
+}
+
+void Normal(double mi, double sigma, double *out, unsigned n)
+{
+  for(unsigned i=0; i<n; i++) {
+    double sum = 0.0;
+    for(int k=0; k<12; k++)  sum += Random();
+    out[i] = sum;
+  }
+  for(unsigned i=0; i<n; i++)
+    out[i] = (out[i]-6.0)*sigma + mi;
+}
+
+void Erlang(double alfa, int beta, double *out, unsigned n)
+{
+  if (beta<1)  SIMLIB_error(ErlangError);
+  for(unsigned i=0; i<n; i++) {
+    double prod = 1.0;
+    for(int k=0; k<beta; k++)  prod *= Random();
+    out[i] = prod;
+  }
+  for(unsigned i=0; i<n; i++)
+    out[i] = -alfa*log(out[i]);
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  BinomInversion --- sequential search, for n*p < 30  (p <= 0.5)
+//
+template <class G>
+static int BinomInversion(G &rnd, int n, double p)
+{
+  const double q = 1.0 - p;
+  const double qn = exp(n*log(q));
+  const double np = n*p;
+  const double bound = min(double(n), np + 10.0*sqrt(np*q + 1));
+  int x = 0;
+  double px = qn;
+  double u = rnd();
+  while(u > px) {
+    x++;
+    if(x > bound) {                    // rounding errors: start again
+      x = 0;
+      px = qn;
+      u = rnd();
+    } else {
+      u -= px;
+      px = ((n-x+1) * p * px) / (x*q);
+    }
+  }
+  return x;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  BinomBTPE --- triangle, parallelogram, exponential, for n*p >= 30
+//
+//  see: V. Kachitvichyanukul, B. W. Schmeiser: Binomial random variate
+//       generation, Communications of the ACM 31(2), 1988
+//
+template <class G>
+static int BinomBTPE(G &rnd, int n, double r)  // r <= 0.5
+{
+  const double q = 1.0 - r;
+  const double fm = n*r + r;
+  const int m = int(floor(fm));
+  const double nrq = n*r*q;
+  const double p1 = floor(2.195*sqrt(nrq) - 4.6*q) + 0.5;
+  const double xm = m + 0.5;
+  const double xl = xm - p1;
+  const double xr = xm + p1;
+  const double c = 0.134 + 20.5/(15.3 + m);
+  double a = (fm - xl)/(fm - xl*r);
+  const double laml = a*(1.0 + a/2.0);
+  a = (xr - fm)/(xr*q);
+  const double lamr = a*(1.0 + a/2.0);
+  const double p2 = p1*(1.0 + 2.0*c);
+  const double p3 = p2 + c/laml;
+  const double p4 = p3 + c/lamr;
+  for(;;) {
+    const double u = rnd()*p4;
+    double v = rnd();
+    int y;
+    if(u <= p1) {                      // triangle: accept
+      return int(floor(xm - p1*v + u));
+    }
+    if(u <= p2) {                      // parallelograms
+      const double x = xl + (u - p1)/c;
+      v = v*c + 1.0 - fabs(m - x + 0.5)/p1;
+      if(v > 1.0)
+        continue;
+      y = int(floor(x));
+    } else if(u <= p3) {               // left exponential tail
+      if(v == 0.0)
+        continue;
+      y = int(floor(xl + log(v)/laml));
+      if(y < 0)
+        continue;
+      v = v*(u - p2)*laml;
+    } else {                           // right exponential tail
+      if(v == 0.0)
+        continue;
+      y = int(floor(xr - log(v)/lamr));
+      if(y > n)
+        continue;
+      v = v*(u - p3)*lamr;
+    }
+    const int k = y>m ? y-m : m-y;
+    if(k <= 20 || k >= nrq/2.0 - 1) {
+      // explicit evaluation of f(y)/f(m)
+      const double s = r/q;
+      const double aa = s*(n + 1);
+      double F = 1.0;
+      if(m < y)
+        for(int i=m+1; i<=y; i++)  F *= (aa/i - s);
+      else if(m > y)
+        for(int i=y+1; i<=m; i++)  F /= (aa/i - s);
+      if(v <= F)
+        return y;
+      continue;
+    }
+    // squeezing using upper and lower bounds on log(f(y))
+    const double rho = (k/nrq)*((k*(k/3.0 + 0.625) + 0.1666666666666)/nrq + 0.5);
+    const double t = -k*k/(2*nrq);
+    const double A = log(v);
+    if(A < t - rho)
+      return y;
+    if(A > t + rho)
+      continue;
+    // final acceptance/rejection test (Stirling formula)
+    const double x1 = y + 1, f1 = m + 1, z = n + 1 - m, w = n - y + 1;
+    const double x2 = x1*x1, f2 = f1*f1, z2 = z*z, w2 = w*w;
+    if(A <= xm*log(f1/x1) + (n - m + 0.5)*log(z/w) + (y - m)*log(w*r/(x1*q))
+       + (13680.-(462.-(132.-(99.-140./f2)/f2)/f2)/f2)/f1/166320.
+       + (13680.-(462.-(132.-(99.-140./z2)/z2)/z2)/z2)/z/166320.
+       + (13680.-(462.-(132.-(99.-140./x2)/x2)/x2)/x2)/x1/166320.
+       + (13680.-(462.-(132.-(99.-140./w2)/w2)/w2)/w2)/w/166320.)
+      return y;
+  }
+}
+
+template <class G>
+static int Binomial(G &rnd, int n, double p)
+{
+  if (n<0 || p<0 || p>1) SIMLIB_error(BinomError);
+  if (n==0 || p==0) return 0;
+  if (p==1) return n;
+  const double r = min(p, 1.0-p);
+  const int y = (n*r < 30.0) ? BinomInversion(rnd, n, r)
+                             : BinomBTPE(rnd, n, r);
+  return p>0.5 ? n-y : y;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  Binom(n,p)
+//  n = # of experiments (pocet pokusu)
+//  p = probability
+//
+int Binom(int n, double p)
+{
+  BaseGenerator rnd;
+  return Binomial(rnd, n, p);
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  RandomStream --- discrete distributions
+//
+int RandomStream::Poisson(double lambda)
+{
+  if (lambda<=0) SIMLIB_error(PoissonError);
+  StreamGenerator rnd(*this);
+  if (lambda >= 10.0)
+    return PoissonPTRS(rnd, lambda);
+  const double Y = exp(-lambda);       // multiplication method
+  double X = Random();
+  int k = 0;
+  while (X >= Y) {
+    X *= Random();
+    k++;
+  }
+  return k;
+}
+
+int RandomStream::Binom(int n, double p)
+{
+  StreamGenerator rnd(*this);
+  return Binomial(rnd, n, p);
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  EmpiricalDiscrete --- alias table construction (Vose)
+//
+EmpiricalDiscrete::EmpiricalDiscrete(const double *weights, unsigned n)
+{
+  Build(weights, n);
+}
+
+EmpiricalDiscrete::EmpiricalDiscrete(const std::vector<double> &weights)
+{
+  Build(weights.empty() ? 0 : &weights[0], weights.size());
+}
+
+void EmpiricalDiscrete::Build(const double *w, unsigned n)
+{
+  double sum = 0;
+  for(unsigned i=0; i<n; i++) {
+    if(w[i] < 0) SIMLIB_error(EmpiricalError);
+    sum += w[i];
+  }
+  if(n == 0 || sum <= 0) SIMLIB_error(EmpiricalError);
+  prob.resize(n);
+  alias.resize(n);
+  std::vector<unsigned> small, large;  // columns under/over average
+  for(unsigned i=0; i<n; i++) {
+    prob[i] = w[i] * n / sum;
+    alias[i] = i;
+    (prob[i] < 1.0 ? small : large).push_back(i);
+  }
+  while(!small.empty() && !large.empty()) {
+    const unsigned s = small.back();   // fill column s from column l
+    const unsigned l = large.back();
+    small.pop_back();
+    alias[s] = l;
+    prob[l] -= 1.0 - prob[s];
+    if(prob[l] < 1.0) {
+      large.pop_back();
+      small.push_back(l);
+    }
   }
-  return (BNM);
+  // rest (rounding errors): full columns
+  for(unsigned i=0; i<small.size(); i++)  prob[small[i]] = 1.0;
+  for(unsigned i=0; i<large.size(); i++)  prob[large[i]] = 1.0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  EmpiricalDiscrete::Value --- single uniform number per value
+//
+int EmpiricalDiscrete::Value()
+{
+  const double u = Random() * prob.size();
+  const unsigned i = unsigned(u);      // column
+  return (u - i < prob[i]) ? i : alias[i];
+}
+
+int EmpiricalDiscrete::Value(RandomStream &s)
+{
+  const double u = s.Random() * prob.size();
+  const unsigned i = unsigned(u);
+  return (u - i < prob[i]) ? i : alias[i];
 }
-*/
 
 } // end
 
@@ -96,6 +96,13 @@ void SampleDelays() { // used at step-wise changes !!!###
 // ZDelays:
 DEFINE_HOOK(ZDelayTimerInit); // called in Run()
 
+////////////////////////////////////////////////////////////////////////////
+// support for Tracers (internal)
+//
+DEFINE_HOOK(Trace);      // called at each continuous step
+DEFINE_HOOK(TraceStart); // called at start of Run()
+DEFINE_HOOK(TraceEnd);   // called at end of Run()
+
 ////////////////////////////////////////////////////////////////////////////
 // support for simulation interrupt (user-level)
 //
@@ -248,6 +255,7 @@ void Run() {
 
   CALL_HOOK(ZDelayTimerInit);     // activate all ZDelayTimers
   CALL_HOOK(SamplerAct);          // activate all Samplers
+  CALL_HOOK(TraceStart);          // record initial state
   CALL_HOOK(Break);               // user can stop simulation by any key?
 
 // TODO: try using special lowest priority end-event to stop simulation
@@ -281,6 +289,7 @@ void Run() {
 
                   SIMLIB_DoConditions();   // perform state events
                   CALL_HOOK(Delay);        // DELAY: sample input at each step
+                  CALL_HOOK(Trace);        // TRACER: record outputs
                   CALL_HOOK(Break); // user can stop simulation by any key?
                                     // TODO: use signal handler, ^C=SIGINT
                   if(StopFlag)
@@ -309,6 +318,7 @@ void Run() {
         }
   } // main loop
   IntegrationMethod::IntegrationDone(); // terminate integration run
+  CALL_HOOK(TraceEnd);                  // write traced data
   SIMLIB_Phase = TERMINATION;
   SIMLIB_run_statistics.EndTime = Time;
   Dprintf(("\n\t ********** Run() --- END \n"));
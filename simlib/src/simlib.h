@@ -45,8 +45,13 @@
 
 ////////////////////////////////////////////////////////////////////////////
 // includes
+#include <cstdio>       // FILE
 #include <cstdlib>      // size_t
 #include <list>         // std::list<>
+#include <map>          // std::multimap<>
+#include <set>          // std::set<>
+#include <string>       // std::string
+#include <vector>       // std::vector<>
 
 // /////////////////////////////////////////////////////////////////////////
 //! \namespace simlib3  Main SIMLIB (version 3+) namespace.
@@ -114,12 +119,14 @@ class   TStat;                  // time dependent statistics
 class   Histogram;              // histogram
 class   Facility;               // SOL-like facility
 class   Store;                  // SOL-like store
+class   MultiFacility;          // facility with N servers
 class   Barrier;                // barrier
 class   Semaphore;              // semaphore
 // continuous:
 class   aBlock;                 // abstract block
 class     aContiBlock;          // blocks with continuous output
 class       Integrator;         // integrator
+class     aIntegratorArray;     // array of integrators (contiguous state)
 class       Status;             // status variables
 class         Hyst;             // hysteresis
 class         Blash;            // backlash
@@ -133,6 +140,8 @@ class    aCondition;            // state condition base class
 class      Condition;           // state event detector (Boolean version)
 class        ConditionUp;       // action by FALSE-->TRUE change
 class        ConditionDown;     // action by TRUE-->FALSE
+class      ConditionGroup;      // many thresholds on single signal
+class    ThresholdCondition;    // single threshold of ConditionGroup
 
 ////////////////////////////////////////////////////////////////////////////
 // CATEGORY: global constants
@@ -274,6 +283,8 @@ int    NegBin(double q, int k);
 double Normal(double mi, double sigma);
 //! Poisson distribution generator @param lambda
 int    Poisson(double lambda);
+//! Binomial distribution generator @param n # of trials @param p probability
+int    Binom(int n, double p);
 double Rayle(double delta);
 double Triag(double mod, double min, double max);
 //! Uniform distribution generator @param l low limit @param h high limit
@@ -281,6 +292,84 @@ double Uniform(double l, double h);
 //! Weibul distribution generator @param lambda @param alfa
 double Weibul(double lambda, double alfa);
 
+////////////////////////////////////////////////////////////////////////////
+//! independent random number stream (xoshiro256** generator)
+//!
+//! Each stream is split into substreams (2^128 numbers), streams created
+//! by default constructor start 2^192 numbers apart, so every Facility,
+//! generator process or entity class can have its own stream.
+//! Common random numbers: use the same stream for the same purpose
+//! in compared experiments, call NextSubstream() for next replication.
+//! \ingroup simlib
+class RandomStream {
+  enum { BUFSIZE = 32 };
+  unsigned long long s[4];             // generator state
+  unsigned long long start[4];         // start of current substream
+  unsigned long long begin[4];         // start of the stream
+  unsigned long long buf[BUFSIZE];     // prefetched numbers
+  unsigned pos;                        // next number in buf
+  void Refill();                       // generate BUFSIZE numbers
+  double NormalTail(long hz, unsigned iz);          // Ziggurat: slow path
+  double ExponentialTail(unsigned long jz, unsigned iz);
+ public:
+  RandomStream();                      //!< next independent stream
+  explicit RandomStream(unsigned long long seed); //!< seeded stream
+  void Seed(unsigned long long seed);  //!< set state (using splitmix64)
+  static void SetPackageSeed(unsigned long long seed); //!< for new streams
+  unsigned long long Next() {          //!< 64 random bits
+    if(pos == BUFSIZE)
+      Refill();
+    return buf[pos++];
+  }
+  double Random() {                    //!< uniform in range 0 .. 0.99999...
+    return (Next() >> 11) * (1.0/9007199254740992.0);
+  }
+  double Uniform(double l, double h);  //!< uniform distribution
+  double Exponential(double mv);       //!< exponential (Ziggurat method)
+  double Normal(double mi, double sigma); //!< Gauss (Ziggurat method)
+  int    Poisson(double lambda);       //!< Poisson distribution (PTRS)
+  int    Binom(int n, double p);       //!< binomial distribution (BTPE)
+  // bulk generation: fill out[0..n-1]
+  void Random(double *out, unsigned n);
+  void Uniform(double l, double h, double *out, unsigned n);
+  void Exponential(double mv, double *out, unsigned n);
+  void Normal(double mi, double sigma, double *out, unsigned n);
+  void Erlang(double alfa, int beta, double *out, unsigned n);
+  void Reset();                        //!< restart the stream
+  void ResetSubstream();               //!< restart current substream
+  void NextSubstream();                //!< skip to next substream (2^128)
+  void Jump();                         //!< skip 2^128 numbers
+  void LongJump();                     //!< skip 2^192 numbers
+};
+
+//! use the stream as base generator for Random() and all distributions
+//! @param s the stream, 0 means default base generator
+void   SetBaseRandomStream(RandomStream *s);
+
+////////////////////////////////////////////////////////////////////////////
+//! discrete distribution given by table of weights (probabilities)
+//! generates values 0..n-1 in constant time (Walker alias method),
+//! the table is built once in constructor
+//! \ingroup simlib
+class EmpiricalDiscrete {
+  std::vector<double> prob;            // probability of own value in column
+  std::vector<unsigned> alias;         // alias value of column
+  void Build(const double *weights, unsigned n);
+ public:
+  EmpiricalDiscrete(const double *weights, unsigned n);
+  explicit EmpiricalDiscrete(const std::vector<double> &weights);
+  unsigned Size() const { return prob.size(); }
+  int Value();                         //!< using Random()
+  int Value(RandomStream &s);          //!< using the stream
+  int operator()() { return Value(); }
+};
+
+// bulk generation: fill out[0..n-1], the same values as n calls
+void   Uniform(double l, double h, double *out, unsigned n);
+void   Exponential(double mv, double *out, unsigned n);
+void   Normal(double mi, double sigma, double *out, unsigned n);
+void   Erlang(double alfa, int beta, double *out, unsigned n);
+
 
 ////////////////////////////////////////////////////////////////////////////
 // CATEGORY: basics
@@ -374,13 +463,16 @@ class Entity : public Link {
     // Queue stores insertion time for statistics:
     friend class Queue;             // ### remove
     double _MarkTime;               // beginning of waiting in queue ###!!!
+    long _QueueKey;                 // sort key at insertion into queue
     // Facility and Store use these data
     friend class Facility;
     friend class Store;
+    friend class MultiFacility;
     // TODO: this should be stored in queues at Facility/Store
     union {
         double _RemainingTime; // rest of time of interrupted service (Facility) ###
         unsigned long _RequiredCapacity; // required store capacity of Store
+                                         // or server index in MultiFacility
     };
     ServicePriority_t _SPrio;           //!< priority of service in Facility
     ////////////////////////////////////////////////////////////////////////////
@@ -469,6 +561,8 @@ class Process : public Entity {
   void Release(Facility &f);                        //!< release facility
   void Enter(Store &s, unsigned long ReqCap=1); //!< acquire some capacity
   void Leave(Store &s, unsigned long ReqCap=1); //!< return some capacity
+  unsigned Seize(MultiFacility &f, ServicePriority_t sp=0); //!< seize server
+  void Release(MultiFacility &f);                   //!< release server
 
   using Entity::Into;
   virtual void Into(Queue &q);          //!< insert process into queue
@@ -519,6 +613,49 @@ class Sampler: public Event {
     static void ActivateAll();      //!< start all samplers (Run)
 };
 
+////////////////////////////////////////////////////////////////////////////
+//! steady-state output analysis of Stat or TStat
+//! samples the statistic with period dt (interval means), detects the
+//! end of warm-up period by MSER-5 rule, computes batch-means confidence
+//! interval of the steady-state mean from data after warm-up and stops
+//! the simulation run when the relative half-width is <= precision
+//! \ingroup simlib
+class BatchMeans : public Sampler {
+    BatchMeans(const BatchMeans&);            // disable
+    BatchMeans&operator=(const BatchMeans&);  // disable
+    const Stat *stat;                 // observed statistic (or 0)
+    const TStat *tstat;               // observed time statistic (or 0)
+    double precision;                 // required relative half-width
+    double level;                     // confidence level
+    unsigned nbatches;                // number of batches
+    bool stop;                        // stop run when precise
+    bool started;                     // last sums are valid
+    double lastsum, lastw;            // cumulative sum/weight at last sample
+    double lasttime;                  // time of last sample
+    std::vector<double> obs;          // sums of values in intervals
+    std::vector<double> weights;      // weights (number or time) of intervals
+    std::vector<double> times;        // start times of intervals
+    unsigned warmup;                  // number of intervals of warm-up
+    double mean, halfwidth;           // results of last analysis
+    bool precise;                     // precision is reached
+    void Init(double dt, double prec, double lev);
+    void Analyze();
+  protected:
+    virtual void Behavior();          //!< sample + analysis
+  public:
+    BatchMeans(const Stat &s, double dt, double prec=0.05, double lev=0.95);
+    BatchMeans(const TStat &s, double dt, double prec=0.05, double lev=0.95);
+    virtual void Output() const;      //!< print results
+    void Clear();                     //!< forget all samples
+    void SetBatches(unsigned n);      //!< number of batches (default 20)
+    void StopRun(bool on) { stop = on; } //!< stop Run() when precise
+    bool Precise() const { return precise; }
+    double MeanValue() const { return mean; }  //!< steady-state mean
+    double HalfWidth() const { return halfwidth; } //!< of conf. interval
+    double WarmUpTime() const;        //!< end of warm-up period
+    unsigned Intervals() const { return obs.size(); }
+};
+
 
 ////////////////////////////////////////////////////////////////////////////
 // CATEGORY: discrete blocks - pasive
@@ -550,16 +687,56 @@ class aStat : public SimObject {
 };
 #endif
 
+////////////////////////////////////////////////////////////////////////////
+//! streaming quantile estimator (merging t-digest)
+//! values are clustered into at most about compression centroids,
+//! small near both tails, so the memory is constant and extreme
+//! quantiles (P99, P99.9) are accurate; digests can be merged
+//! \ingroup simlib
+class TDigest {
+  struct Centroid {
+    double mean;                // mean of values
+    double weight;              // number (weight) of values
+    bool single;                // all values are equal
+    bool operator < (const Centroid &c) const { return mean < c.mean; }
+  };
+  double delta;                 // compression
+  mutable std::vector<Centroid> c;    // merged centroids (sorted)
+  mutable std::vector<Centroid> buf;  // values not merged yet
+  mutable double total;         // weight of merged centroids
+  mutable double bufw;          // weight in buffer
+  mutable bool reverse;         // direction of next merge pass
+  double min;                   // min value
+  double max;                   // max value
+  void Compress() const;        // merge buffer into centroids
+ public:
+  TDigest(double compression=200);
+  void Clear();                                //!< initialize
+  void operator () (double x, double w=1.0);   //!< record the value
+  void Merge(const TDigest &d);                //!< add all values of d
+  double Quantile(double q) const;             //!< estimate quantile (0..1)
+  double Weight() const { return total + bufw; } //!< total weight
+  double Compression() const { return delta; }
+  unsigned Centroids() const { Compress(); return c.size(); }
+};
+
 ////////////////////////////////////////////////////////////////////////////
 //! class for statistical information gathering
+//! mean and variance are accumulated by Kahan summation and Welford
+//! updates (numerically stable for large n), quantiles are estimated
+//! by TDigest after EnableQuantiles()
 //! \ingroup simlib
 class Stat : public SimObject {
  protected:
   double sx;                    // sum of values
+  double csx;                   // compensation of sx (Kahan summation)
   double sx2;                   // sum of value square
+  double mean;                  // running mean (Welford)
+  double m2;                    // sum of squared deviations (Welford)
   double min;                   // min value
   double max;                   // max value
   unsigned long n;              // number of values recorded
+  TDigest *qs;                  // quantile sketch, 0 if not enabled
  public:
   Stat();
   Stat(const char *name);
@@ -567,7 +744,7 @@ class Stat : public SimObject {
   virtual void Clear();         //!< initialize
   void operator () (double x);  //!< record the value
 // Stat &operator = (Stat &x);  // TODO: copy semantics
-// Stat &operator += (Stat &x); // sum two statistics + template operator +
+  Stat &operator += (const Stat &x);  //!< merge statistics (replications)
   virtual void Output() const;  //!< print statistics
   unsigned long Number() const { return n; }
   double Min() const           { /* TODO: test n==0 */ return min; }
@@ -576,6 +753,10 @@ class Stat : public SimObject {
   double SumSquare() const     { return sx2; }
   double MeanValue() const;
   double StdDev() const;
+  //! start quantile estimation (records from now on)
+  void EnableQuantiles(double compression=200);
+  const TDigest *Quantiles() const { return qs; }
+  double Quantile(double q) const;    //!< estimated quantile q (0..1)
 };
 
 
@@ -586,14 +767,17 @@ class TStat : public SimObject {
  protected:
   double sxt;                   // sum of x*time
   double sx2t;                  // sum of squares
+  double csxt, csx2t;           // compensations (Kahan summation)
   double min;                   // min value x
   double max;                   // max value x
   double t0;                    // time of initialization
   double tl;                    // last record time
   double xl;                    // last recorded value x
   unsigned long n;              // number of records
+  TDigest *qs;                  // quantiles (weight = time), 0 if disabled
   friend class Facility; // needs to correct n -- TODO: remove
   friend class Store;
+  friend class MultiFacility;
   friend class Queue;
  public:
   TStat(double initval=0.0);
@@ -611,6 +795,10 @@ class TStat : public SimObject {
   double LastTime() const      { return tl; }
   double LastValue() const     { return xl; }
   double MeanValue() const;
+  //! start estimation of time-weighted quantiles
+  void EnableQuantiles(double compression=200);
+  const TDigest *Quantiles() const { return qs; }
+  double Quantile(double q) const;    //!< value x, which is <=q of time
 };
 
 
@@ -675,11 +863,25 @@ class List : public Link { // circular list of Link items
 ////////////////////////////////////////////////////////////////////////////
 //! priority queue
 //
+//! Priority insert uses index of the last entity of each priority,
+//! it takes O(log P) time for P different priorities in the queue.
+//! The index is not used after arbitrary insertion breaks the order
+//! (until the queue is empty again). The key of each entity is stored
+//! at insertion, so removal updates the index without a scan. Do not
+//! change Priority of entity waiting in the queue (it is not resorted).
 //! \ingroup simlib
 class Queue : public List { // don't inherit interface for now
 //TODO:remove
     friend class Facility;
     friend class Store;
+    friend class MultiFacility;
+    enum SortKey { UNSORTED=0, BY_PRIORITY, BY_SERVICE_PRIORITY };
+    SortKey sortkey;                     // ordering of sorted queue
+    bool indexed;                        // tails can be used
+    std::map<long,Link*> tails;          // last entity of each key
+    static long Key(Entity *e, SortKey k);
+    void SortedIns(Entity *e, SortKey k);// insert after last key>=Key(e)
+    void ResetIndex();
   public:
     typedef List::iterator iterator;
     TStat StatN;
@@ -740,6 +942,48 @@ class Histogram : public SimObject {
   unsigned operator [](unsigned i) const;  // # of items in interval[i]
 };
 
+////////////////////////////////////////////////////////////////////////////
+//! log-linear histogram (HDR-like)
+//! value |x| in units is split to power of two range and 2^precision
+//! linear sub-buckets, so relative error is at most 2^-precision for
+//! any value (no range setting needed); bucket index is computed by
+//! bit operations; recording uses atomic operations, so more threads
+//! can record into one histogram; blocks of buckets are allocated
+//! on first use
+//! \ingroup simlib
+class LogHistogram : public SimObject {
+    LogHistogram(const LogHistogram&);              // disable
+    LogHistogram&operator=(const LogHistogram&);    // disable
+  unsigned prec;             // sub-bucket bits
+  double unit;               // value of unit
+  double runit;              // 1/unit
+  unsigned nblocks;          // blocks for each sign
+  unsigned long **blocks;    // [sign*nblocks+block][sub-bucket], sign=0: x<0
+  unsigned long n;           // number of records
+  double sum;                // sum of values
+  double min, max;           // min and max value
+  void Init(double u, unsigned p);
+  unsigned long *Block(unsigned k) const;       // allocate if needed
+  double Bound(unsigned b, unsigned long i) const; // bucket low bound
+ public:
+  LogHistogram(double unit=1e-6, unsigned precision=7);
+  LogHistogram(const char *name, double unit=1e-6, unsigned precision=7);
+  ~LogHistogram();
+  virtual void Output() const;         //!< print nonzero buckets
+  void operator () (double x);         //!< record value x (thread safe)
+  void Merge(const LogHistogram &h);   //!< add all records of h
+  virtual void Clear();                //!< initialize (not thread safe)
+  std::string Serialize() const;       //!< compact binary form
+  void Deserialize(const std::string &s); //!< load (replaces contents)
+  unsigned long Number() const { return n; }
+  double Min() const     { return n ? min : 0; }
+  double Max() const     { return n ? max : 0; }
+  double MeanValue() const;
+  double Quantile(double q) const;     //!< bucket midpoint of q-quantile
+  double Unit() const    { return unit; }
+  unsigned Precision() const { return prec; }
+};
+
 
 
 ////////////////////////////////////////////////////////////////////////////
@@ -810,6 +1054,106 @@ class Store : public SimObject {
   virtual void Clear();                                 //!< initialize
 };
 
+////////////////////////////////////////////////////////////////////////////
+//! facility with N servers and single shared input queue
+//! free servers are kept in bitmap (with summary level), server is
+//! selected by policy: FIRST_FREE (lowest index), ROUND_ROBIN (next free
+//! after the last seized one) or LEAST_UTILIZED (free server with least
+//! busy time), each server has its own utilization statistics
+//! \ingroup simlib
+class MultiFacility : public SimObject {
+    MultiFacility(const MultiFacility&);              // disable
+    MultiFacility&operator=(const MultiFacility&);    // disable
+ public:
+  enum Policy { FIRST_FREE, ROUND_ROBIN, LEAST_UTILIZED };
+ private:
+  unsigned char _Qflag;
+  unsigned n;                    // number of servers
+  unsigned used;                 // number of busy servers
+  Policy policy;                 // server selection
+  unsigned next;                 // ROUND_ROBIN: start of search
+  Entity **in;                   // entities in service
+  TStat *stat;                   // utilization of servers
+  std::vector<unsigned long> freemap;  // bit per free server
+  std::vector<unsigned long> summary;  // bit per nonzero word of freemap
+  std::set< std::pair<double,unsigned> > idle; // LEAST_UTILIZED: free
+                                               // servers by busy time
+  void Init(unsigned _n);
+  void SetFree(unsigned i);
+  void SetBusy(unsigned i);
+  unsigned FindFree(unsigned from) const;      // first free >= from or n
+  unsigned Select();                           // free server by policy
+  void Assign(unsigned i, Entity *e);          // start service
+ public:
+  Queue *Q;                      //!< input queue
+  TStat tstat;                   //!< number of busy servers
+  MultiFacility(unsigned _n, Policy p=FIRST_FREE);
+  MultiFacility(const char *_name, unsigned _n, Policy p=FIRST_FREE);
+  MultiFacility(const char *_name, unsigned _n, Queue *queue,
+                Policy p=FIRST_FREE);
+  virtual ~MultiFacility();
+  virtual void Output() const;                          //!< print statistics
+  operator MultiFacility* () { return this; }
+  void SetQueue(Queue *queue);                          //!< change input queue
+  void SetPolicy(Policy p);                             //!< change policy
+  Policy GetPolicy() const { return policy; }
+  bool OwnQueue() const;
+  unsigned Size() const  { return n; }                  //!< number of servers
+  unsigned Used() const  { return used; }               //!< busy servers
+  unsigned Free() const  { return n - used; }           //!< free servers
+  bool Full() const      { return used == n; }          //!< all servers busy
+  bool Busy(unsigned i) const;                          //!< server i is busy
+  Entity *In(unsigned i) const;                         //!< entity in service
+  const TStat &ServerStat(unsigned i) const;            //!< server statistics
+  unsigned QueueLen() const { return Q->size(); }
+  //! seize a free server (or wait in queue), returns server index
+  virtual unsigned Seize(Entity *e, ServicePriority_t sp=DEFAULT_PRIORITY);
+  virtual void Release(Entity *e);                      //!< release server
+  virtual void QueueIn(Entity *e, ServicePriority_t sp);//!< go into queue
+  virtual void Clear();                                 //!< initialize
+};
+
+////////////////////////////////////////////////////////////////////////////
+//! machine-readable export of statistics (JSON lines)
+//! registered objects are serialized into memory buffer, one line per
+//! object, and the whole snapshot is written by single fwrite() call;
+//! snapshots are written by Write() and every dt during simulation run
+//! \ingroup simlib
+class StatExport : public Sampler {
+    StatExport(const StatExport&);            // disable
+    StatExport&operator=(const StatExport&);  // disable
+    enum ItemType { STAT, TSTAT, HISTOGRAM, LOGHISTOGRAM, QUEUE,
+                    FACILITY, STORE, MULTIFACILITY };
+    struct Item { ItemType type; const SimObject *obj; };
+    std::vector<Item> items;          // registered objects
+    std::string buf;                  // output buffer
+    FILE *file;                       // output file
+    unsigned long snapshots;          // number of written snapshots
+    void Add(ItemType t, const SimObject *o);
+    void Put(const char *s);          // append JSON string
+    void Put(double x);               // append JSON number
+    void Put(const char *key, double x);
+    void PutStat(const Stat &s);
+    void PutTStat(const TStat &s);
+    void PutQueue(const Queue &q);
+  protected:
+    virtual void Behavior();          //!< periodic snapshot
+  public:
+    StatExport(const char *filename, double dt=0);
+    virtual ~StatExport();
+    void Add(const Stat &s)          { Add(STAT, &s); }
+    void Add(const TStat &s)         { Add(TSTAT, &s); }
+    void Add(const Histogram &h)     { Add(HISTOGRAM, &h); }
+    void Add(const LogHistogram &h)  { Add(LOGHISTOGRAM, &h); }
+    void Add(const Queue &q)         { Add(QUEUE, &q); }
+    void Add(const Facility &f)      { Add(FACILITY, &f); }
+    void Add(const Store &s)         { Add(STORE, &s); }
+    void Add(const MultiFacility &f) { Add(MULTIFACILITY, &f); }
+    void Write();                     //!< write snapshot of all objects
+    unsigned long Snapshots() const { return snapshots; }
+    unsigned Objects() const { return items.size(); }
+};
+
 
 ////////////////////////////////////////////////////////////////////////////
 // CATEGORY: continuous blocks
@@ -979,21 +1323,29 @@ class aContiBlock3 : public aContiBlock {
 
 ////////////////////////////////////////////////////////////////////////////
 //! IntegratorContainer - internal container of integrators (singleton)
+//! contains scalar integrators and arrays of integrators, integration
+//! methods see all their states by state_iterator
 //TODO: move to implementation header
 class IntegratorContainer {
 private:
   static std::list<Integrator*> * ListPtr;  // list of integrators
+  static std::list<aIntegratorArray*> * ArrayListPtr;  // list of arrays
+  static size_t ArrayStates;  // # of states in all arrays
   IntegratorContainer();  // forbid constructor
   static std::list<Integrator*> * Instance(void);  // return list (& create)
+  static std::list<aIntegratorArray*> * ArrayInstance(void);
 public:
   typedef std::list<Integrator*>::iterator iterator;
+  typedef std::list<aIntegratorArray*>::iterator array_iterator;
+  class StateRef;         // single state: integrator or array element
+  class state_iterator;   // all states: integrators, then array elements
   // is there any integrator in the list? (e.g. list is not empty)
   static bool isAny(void) {
-    return ListPtr!=0 && !(ListPtr->empty());
+    return (ListPtr!=0 && !(ListPtr->empty())) || ArrayStates>0;
   }
-  // # of elements in the list
+  // # of states (integrators + elements of arrays)
   static size_t Size(void) {
-    return (ListPtr!=0) ? (ListPtr->size()) : 0;
+    return ((ListPtr!=0) ? (ListPtr->size()) : 0) + ArrayStates;
   }
   // return iterator to the first element
   static iterator Begin(void) {
@@ -1003,8 +1355,12 @@ public:
   static iterator End(void) {
     return Instance()->end();
   }
+  static state_iterator StateBegin(void);  // first state
+  static state_iterator StateEnd(void);    // end of states
   static iterator Insert(Integrator* ptr);  // insert element into container
   static void Erase(iterator it);  // exclude element
+  static array_iterator Insert(aIntegratorArray* ptr);  // insert array
+  static void Erase(array_iterator it, size_t n);  // exclude array
   static void InitAll();           // initialize all
   static void EvaluateAll();       // evaluate all integrators
   static void LtoN();              // last -> now
@@ -1074,13 +1430,9 @@ private:   //## repair
   static void Summarize(void);  // set up new state after integration
 protected:
   static bool IsEndStepEvent; // flag - will be event at the end of the step?
-  typedef IntegratorContainer::iterator Iterator;  // iterator of intg. list
-  static Iterator FirstIntegrator(void) {  // it. to first integrator in list
-    return IntegratorContainer::Begin();
-  }
-  static Iterator LastIntegrator(void) {  // it. to last integrator in list
-    return IntegratorContainer::End();
-  }
+  typedef IntegratorContainer::state_iterator Iterator;  // all states
+  static Iterator FirstIntegrator(void);  // it. to first integrator in list
+  static Iterator LastIntegrator(void);   // it. to last integrator in list
   static bool StateCond(void);  // check on changes of state conditions
   static IntegrationMethod* SearchMethod(const char* name);  // find method
 
@@ -1262,7 +1614,8 @@ public:
 //
 
 //! select the integration method
-//! @param name  "abm4", "euler", "fw", "rke"(default), "rkf3", "rkf5", "rkf8"
+//! @param name  "abm4", "euler", "fw", "rke"(default), "rkf3", "rkf5", "rkf8",
+//!              "multirate" (see multirate.h)
 //! \ingroup simlib
 inline void SetMethod(const char* name)
 {
@@ -1322,6 +1675,7 @@ class Integrator : public aContiBlock {   // integrator
   double initval;                      //!< initial value: y(t0)
   void CtrInit();
   IntegratorContainer::iterator it_list; //!< position in list of integrators
+  friend class IntegratorContainer::StateRef;
  public:
   Integrator();                        // implicit CTR (input = 0)
   Integrator(Input i, double initvalue=0);
@@ -1353,6 +1707,129 @@ class Integrator : public aContiBlock {   // integrator
 };
 
 
+////////////////////////////////////////////////////////////////////////////
+//! base for arrays of integrators with state in contiguous arrays
+//! (single block in IntegratorContainer instead of N integrators,
+//! derivatives of all elements are computed by single call of Eval)
+//! \ingroup simlib
+class aIntegratorArray {
+  aIntegratorArray(const aIntegratorArray&);   // disable copy ctor
+  void operator= (const aIntegratorArray&);    // disable assignment
+  IntegratorContainer::array_iterator it_list; // position in container
+  bool registered;                     // is in container
+  friend class IntegratorContainer;
+ protected:
+  size_t n;                            //!< number of scalar states
+  double *ss;                          //!< states: y = S f(t,y) dt
+  double *ssl;                         //!< the same from previous step
+  double *dd;                          //!< derivatives: y'=f(t,y)
+  double *ddl;                         //!< the same from previous step
+  // set arrays of derived class, register in container
+  void Bind(size_t n, double *ss, double *ssl, double *dd, double *ddl);
+ public:
+  aIntegratorArray();
+  virtual ~aIntegratorArray();
+  virtual void Eval() = 0;             //!< compute dd[] for all elements
+  virtual void Init() = 0;             //!< set initial values of ss[]
+  // private interface
+  void Save(void);                     // save status
+  void Restore(void);                  // restore saved status
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+//! state of single integrator or element of array (used by methods)
+class IntegratorContainer::StateRef {
+  double *ss, *ssl, *dd, *ddl;
+ public:
+  Integrator *intg;                    // integrator or 0
+  aIntegratorArray *array;             // array or 0
+  size_t index;                        // element of array
+  StateRef(): ss(0), ssl(0), dd(0), ddl(0), intg(0), array(0), index(0) {}
+  StateRef(Integrator *i):
+    ss(&i->ss), ssl(&i->ssl), dd(&i->dd), ddl(&i->ddl),
+    intg(i), array(0), index(0) {}
+  StateRef(aIntegratorArray *a, double *s, double *sl, double *d,
+           double *dl, size_t k):
+    ss(s), ssl(sl), dd(d), ddl(dl), intg(0), array(a), index(k) {}
+  StateRef *operator->() { return this; } // (*ip)->GetState() in methods
+  void SetState(double s) { *ss=s; }
+  double GetState(void) { return *ss; }
+  void SetOldState(double s) { *ssl=s; }
+  double GetOldState(void) { return *ssl; }
+  void SetDiff(double d) { *dd=d; }
+  double GetDiff(void) { return *dd; }
+  void SetOldDiff(double d) { *ddl=d; }
+  double GetOldDiff(void) { return *ddl; }
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+//! iterator over all states: integrators, then elements of arrays
+class IntegratorContainer::state_iterator {
+  iterator ip, iend;                   // scalar integrators
+  array_iterator ap, aend;             // arrays
+  size_t k;                            // element of array *ap
+  void SkipEmpty() {                   // go to array with elements
+    while(ap!=aend && (*ap)->n==0) ++ap;
+  }
+ public:
+  state_iterator() : k(0) {}
+  state_iterator(iterator i, iterator ie, array_iterator a,
+                 array_iterator ae) :
+    ip(i), iend(ie), ap(a), aend(ae), k(0) { SkipEmpty(); }
+  StateRef operator*() const {
+    if(ip!=iend)
+      return StateRef(*ip);
+    aIntegratorArray *a = *ap;
+    return StateRef(a, a->ss+k, a->ssl+k, a->dd+k, a->ddl+k, k);
+  }
+  state_iterator &operator++() {
+    if(ip!=iend)
+      ++ip;
+    else if(++k >= (*ap)->n) {
+      k = 0;
+      ++ap;
+      SkipEmpty();
+    }
+    return *this;
+  }
+  state_iterator operator++(int) {
+    state_iterator tmp(*this);
+    ++*this;
+    return tmp;
+  }
+  bool operator==(const state_iterator &x) const {
+    return ip==x.ip && ap==x.ap && k==x.k;
+  }
+  bool operator!=(const state_iterator &x) const { return !(*this==x); }
+};
+
+inline IntegratorContainer::state_iterator IntegratorContainer::StateBegin()
+{
+  std::list<Integrator*> *l = Instance();       // create lists
+  std::list<aIntegratorArray*> *a = ArrayInstance();
+  return state_iterator(l->begin(), l->end(), a->begin(), a->end());
+}
+
+inline IntegratorContainer::state_iterator IntegratorContainer::StateEnd()
+{
+  std::list<Integrator*> *l = Instance();       // create lists
+  std::list<aIntegratorArray*> *a = ArrayInstance();
+  return state_iterator(l->end(), l->end(), a->end(), a->end());
+}
+
+inline IntegrationMethod::Iterator IntegrationMethod::FirstIntegrator(void)
+{
+  return IntegratorContainer::StateBegin();
+}
+
+inline IntegrationMethod::Iterator IntegrationMethod::LastIntegrator(void)
+{
+  return IntegratorContainer::StateEnd();
+}
+
+
 ////////////////////////////////////////////////////////////////////////////
 //! Status variables (memory)
 //! base for blocks with internal state (Relay, ...)
@@ -1511,6 +1988,7 @@ class Function2 : public aContiBlock2 {
 class aCondition : public aBlock {
   static aCondition *First;            // list of all conditions
   aCondition *Next;                    // next condition in list
+  aCondition *Prev;                    // previous condition in list
   void operator= (aCondition&);        // disable operation
   aCondition(aCondition&);             // disable operation
  public:
@@ -1573,6 +2051,61 @@ class ConditionDown : public Condition { // state event on TRUE-->FALSE change
   virtual const char *Name() const;
 };
 
+////////////////////////////////////////////////////////////////////////////
+//! group of threshold conditions on single input signal
+//! Thresholds are sorted, each step checks only thresholds between
+//! old and new value of the signal: O(log n) instead of O(n) Conditions
+//! \ingroup simlib
+class ConditionGroup : public aCondition {
+ public:
+  typedef std::multimap<double,ThresholdCondition*> container_t;
+ private:
+  Input in;                            // block input (signal)
+  double x;                            // value of signal
+  double xl;                           // old value of signal
+  bool first;                          // no old value yet (after Init)
+  container_t thresholds;              // sorted thresholds
+  std::vector<ThresholdCondition*> pending; // crossed, waiting for Action
+  friend class ThresholdCondition;
+  virtual void Init();
+  virtual void SetNewStatus();
+  virtual bool Test();
+  virtual void Action();
+ public:
+  ConditionGroup(Input i);
+  ~ConditionGroup();
+  virtual bool Value() { return Crossed(); } // some threshold crossed
+  bool Crossed();                      //!< any threshold between xl and x
+  unsigned Size() const { return thresholds.size(); }
+  Input SetInput(Input inp) { return in.Set(inp); } // change input block
+  virtual const char *Name() const;
+};
+
+////////////////////////////////////////////////////////////////////////////
+//! state event: signal of the group crosses given level
+//! (the same as Condition(signal-level), but sharing the group test)
+//! \ingroup simlib
+class ThresholdCondition : public SimObject {
+  ThresholdCondition(const ThresholdCondition&);  // disable operation
+  void operator= (const ThresholdCondition&);     // disable operation
+  ConditionGroup *group;               // condition group of the signal
+  ConditionGroup::container_t::iterator pos; // position in group
+  double level;                        // threshold
+  bool up;                             // last change was FALSE->TRUE
+  friend class ConditionGroup;
+ public:
+  enum Direction { UP = 1, DOWN = 2, BOTH = 3 };
+  const Direction direction;           //!< changes causing Action
+  ThresholdCondition(ConditionGroup &g, double level, Direction d=BOTH);
+  virtual ~ThresholdCondition();
+  double Level() const { return level; }
+  void SetLevel(double newlevel);      //!< move threshold
+  bool Up() const   { return up; }     //!< change: FALSE->TRUE
+  bool Down() const { return !up; }    //!< change: TRUE->FALSE
+  virtual void Action()=0;             //!< state event
+  virtual const char *Name() const;
+};
+
 
 
 
@@ -1759,6 +2292,56 @@ class Newton : public AlgLoop {
 };
 
 
+////////////////////////////////////////////////////////////////////////////
+//! solve vector algebraic loop  x = f(x)  using Newton-Krylov method
+//
+//! Jacobian-free GMRES is used for Newton steps. Finite-difference
+//! Jacobian is the preconditioner, it is reused while Newton iterations
+//! converge well. Each solution starts from the previous one.
+//!
+//!  Usage:   NewtonKrylov loop(2, 1e-8, 50);
+//!           loop.SetInput(0, f0(loop[0], loop[1]));
+//!           loop.SetInput(1, f1(loop[0], loop[1]));
+//! \ingroup simlib
+class NewtonKrylov : public SimObject {
+  NewtonKrylov(const NewtonKrylov&);    // disable copy ctor
+  void operator= (const NewtonKrylov&); // disable assignment
+  class output;                        // block: component of solution
+  const unsigned n;                    // dimension
+  double Eps;                          // required accuracy
+  unsigned long MaxIt;                 // max. number of Newton iterations
+  std::vector<Input> in;               // loop inputs  x = f(x)
+  std::vector<output*> out;            // loop outputs
+  std::vector<double> x;               // solution (initial value)
+  const double *cur;                   // trial solution (in iterations)
+  std::vector<double> lu;              // LU of Jacobian (preconditioner)
+  std::vector<unsigned> piv;           // pivots of LU
+  bool jac_valid;                      // preconditioner can be used
+  bool solving;                        // evaluation of inputs in progress
+  unsigned long stamp;                 // model evaluation of solution
+  unsigned long icount, fcount, jcount;// statistics
+  void Residual(const double *t, double *r); // r = t - f(t)
+  void Jacobian(const double *r);      // new preconditioner
+  void Precondition(double *v);        // v = inverse(J)*v
+  bool GMRES(const double *r, double *dx); // solve J*dx = -r
+  void Solve();
+ public:
+  NewtonKrylov(unsigned n, double eps=1e-8, unsigned long max_it=50);
+  virtual ~NewtonKrylov();
+  void Set(double eps, unsigned long max_it); //!< set parameters
+  unsigned Size() const { return n; }
+  void SetInput(unsigned i, Input inp); //!< loop input: x[i] = inp
+  void Init(unsigned i, double x0);    //!< initial value of x[i]
+  Input operator[] (unsigned i);       //!< block: solution x[i]
+  double Value(unsigned i);            //!< solution x[i]
+  unsigned long IterationCount() const { return icount; }
+  unsigned long EvaluationCount() const { return fcount; }
+  unsigned long JacobianCount() const { return jcount; }
+  virtual const char *Name() const;
+  virtual void Output() const;
+};
+
+
 ////////////////////////////////////////////////////////////////////////////
 // CATEGORY: global functions
 
@@ -22,6 +22,7 @@
 #include "simlib3D.h"
 #include "internal.h"
 #include <cmath>
+#include <algorithm>
 
 ////////////////////////////////////////////////////////////////////////////
 // implementation
@@ -442,5 +443,194 @@ Input Ypart(Input3D a) { return new _XYZpart(a, _XYZpart::y); }
 Input Zpart(Input3D a) { return new _XYZpart(a, _XYZpart::z); }
 
 
+////////////////////////////////////////////////////////////////////////////
+// batch kernels --- operations on whole Vector3DArray
+//
+// simple loops over separate x,y,z arrays: compiler can vectorize them
+// (this file is compiled with -O3 -fno-math-errno, see Makefile.generic)
+//
+
+#if defined(__GNUC__) || defined(_MSC_VER)
+#  define SIMLIB_RESTRICT __restrict  // output does not alias input
+#else
+#  define SIMLIB_RESTRICT
+#endif
+
+void Vector3DArray::Resize(unsigned m)
+{
+  if(m == n)
+    return;
+  std::vector<double> w(3*m);
+  const unsigned k = std::min(m, n);
+  if(k > 0)
+    for(unsigned c=0; c<3; c++)        // components x, y, z
+      std::copy(&v[0]+c*n, &v[0]+c*n+k, &w[0]+c*m);
+  v.swap(w);
+  n = m;
+}
+
+void Abs(const Vector3DArray &a, double *out)
+{
+  const double *x = a.x(), *y = a.y(), *z = a.z();
+  const unsigned n = a.Size();
+  for(unsigned i=0; i<n; i++)
+    out[i] = sqrt(x[i]*x[i] + y[i]*y[i] + z[i]*z[i]);
+}
+
+void CrossProduct(const Vector3DArray &a, const Vector3DArray &b,
+                  Vector3DArray &out)
+{
+  const unsigned n = a.Size();
+  if(b.Size()!=n)
+    SIMLIB_error(ArraySizeError);
+  out.Resize(n);
+  const double *ax = a.x(), *ay = a.y(), *az = a.z();
+  const double *bx = b.x(), *by = b.y(), *bz = b.z();
+  double *ox = out.x(), *oy = out.y(), *oz = out.z();
+  for(unsigned i=0; i<n; i++) {
+    const double x = ay[i]*bz[i] - az[i]*by[i];
+    const double y = az[i]*bx[i] - ax[i]*bz[i];
+    const double z = ax[i]*by[i] - ay[i]*bx[i];
+    ox[i] = x; oy[i] = y; oz[i] = z;   // out can be the same as a or b
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////
+// GravityRow --- add acceleration by body j (at xj,yj,zj) to bodies b..e-1
+//
+static void GravityRow(unsigned b, unsigned e,
+                       double xj, double yj, double zj, double gm, double eps2,
+                       const double *x, const double *y, const double *z,
+                       double *SIMLIB_RESTRICT ox, double *SIMLIB_RESTRICT oy,
+                       double *SIMLIB_RESTRICT oz)
+{
+  for(unsigned i=b; i<e; i++) {        // independent iterations
+    const double dx = xj - x[i];
+    const double dy = yj - y[i];
+    const double dz = zj - z[i];
+    const double r2 = dx*dx + dy*dy + dz*dz + eps2;
+    const double f = gm / (r2 * sqrt(r2));
+    ox[i] += f * dx;  oy[i] += f * dy;  oz[i] += f * dz;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Gravity --- pairwise interaction, each body i sums all others
+// (loop over i writes out[i] only: no scatter to j, vectorized)
+//
+void Gravity(const Vector3DArray &r, const double *m, double G, double eps2,
+             Vector3DArray &out)
+{
+  const unsigned n = r.Size();
+  if(&out == &r) {                     // in-place operation
+    Vector3DArray tmp(n);
+    Gravity(r, m, G, eps2, tmp);
+    out = tmp;
+    return;
+  }
+  out.Resize(n);
+  const double *x = r.x(), *y = r.y(), *z = r.z();
+  double *ox = out.x(), *oy = out.y(), *oz = out.z();
+  std::fill(out.Data(), out.Data()+3*n, 0.0);
+  for(unsigned j=0; j<n; j++) {        // source body j, skip i==j
+    const double gm = G * m[j];
+    GravityRow(0, j, x[j], y[j], z[j], gm, eps2, x, y, z, ox, oy, oz);
+    GravityRow(j+1, n, x[j], y[j], z[j], gm, eps2, x, y, z, ox, oy, oz);
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+// _ArrayElement3D --- element of integrator array as 3D block
+//
+class _ArrayElement3D : public aContiBlock3D {
+  IntegratorArray3D *array;
+  unsigned index;
+ public:
+  _ArrayElement3D(IntegratorArray3D *a, unsigned i): array(a), index(i) {}
+  virtual Value3D Value() { return array->Value(index); }
+};
+
+////////////////////////////////////////////////////////////////////////////
+// IntegratorArray3D --- constructors & destructor
+//
+IntegratorArray3D::IntegratorArray3D(unsigned n):
+    input(0)
+{
+  Create(n);
+}
+
+IntegratorArray3D::IntegratorArray3D(IntegratorArray3D &i):
+    aIntegratorArray(), input(&i)
+{
+  Create(i.Size());
+}
+
+void IntegratorArray3D::Create(unsigned n)
+{
+  Dprintf(("IntegratorArray3D::Create(%u)", n));
+  state.Resize(n);
+  oldstate.Resize(n);
+  deriv.Resize(n);
+  oldderiv.Resize(n);
+  initval.Resize(n);
+  if(n > 0)  // 3N states in contiguous arrays
+    Bind(3*n, state.Data(), oldstate.Data(), deriv.Data(), oldderiv.Data());
+}
+
+IntegratorArray3D::~IntegratorArray3D()
+{
+  Dprintf(("IntegratorArray3D::~IntegratorArray3D()"));
+}
+
+////////////////////////////////////////////////////////////////////////////
+// IntegratorArray3D::Eval --- compute all derivatives
+// (called once per model evaluation by IntegratorContainer)
+//
+void IntegratorArray3D::Eval()
+{
+  Derivative(deriv);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// IntegratorArray3D::Derivative --- default: state of input array or 0
+//
+void IntegratorArray3D::Derivative(Vector3DArray &d)
+{
+  const unsigned n = Size();
+  if(input)
+    std::copy(input->state.Data(), input->state.Data()+3*n, d.Data());
+  else
+    std::fill(d.Data(), d.Data()+3*n, 0.0);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// IntegratorArray3D::Init --- initial state (start of simulation run)
+//
+void IntegratorArray3D::Init()
+{
+  const unsigned n = Size();
+  std::copy(initval.Data(), initval.Data()+3*n, state.Data());
+}
+
+void IntegratorArray3D::Init(unsigned i, const Value3D &v)
+{
+  initval.Set(i, v);
+  state.Set(i, v);
+  SIMLIB_ResetStatus = true;           // if in simulation
+}
+
+void IntegratorArray3D::Set(unsigned i, const Value3D &v)
+{
+  state.Set(i, v);
+  SIMLIB_ResetStatus = true;           // step change
+}
+
+Input3D IntegratorArray3D::operator[] (unsigned i)
+{
+  return new _ArrayElement3D(this, i);
+}
+
+
 } // end
 
@@ -23,6 +23,8 @@
 #   error "simlib3D.h: 22: requires SIMLIB version 2.12 and higher"
 #endif
 
+#include <vector>
+
 namespace simlib3 {
 
 ////////////////////////////////////////////////////////////////////////////
@@ -243,6 +245,80 @@ Input Ypart(Input3D a);
 //! get z part of (x,y,z) vector value
 Input Zpart(Input3D a);
 
+
+////////////////////////////////////////////////////////////////////////////
+// batches of 3D vectors (particle systems)
+//
+
+////////////////////////////////////////////////////////////////////////////
+//! array of N 3D vectors stored as x, y, z arrays (SoA) in single block
+//! of 3N values: x[0..N-1], y[0..N-1], z[0..N-1]
+//! (operations on whole arrays are simple loops the compiler can vectorize)
+//! \ingroup simlib3D
+class Vector3DArray {
+  std::vector<double> v;               // x, y, z components
+  unsigned n;
+ public:
+  explicit Vector3DArray(unsigned n=0) : v(3*n), n(n) {}
+  unsigned Size() const { return n; }
+  void Resize(unsigned n);             //!< change size, keeps elements
+  Value3D operator[] (unsigned i) const {
+    return Value3D(v[i], v[n+i], v[2*n+i]);
+  }
+  void Set(unsigned i, const Value3D &a) {
+    v[i] = a.x(); v[n+i] = a.y(); v[2*n+i] = a.z();
+  }
+  double *x() { return &v[0]; }         //!< x components
+  double *y() { return &v[n]; }         //!< y components
+  double *z() { return &v[2*n]; }       //!< z components
+  const double *x() const { return &v[0]; }
+  const double *y() const { return &v[n]; }
+  const double *z() const { return &v[2*n]; }
+  double *Data() { return &v[0]; }      //!< all 3N values
+};
+
+//! batch kernel: out[i] = abs(a[i])
+void Abs(const Vector3DArray &a, double *out);
+//! batch kernel: out[i] = a[i] * b[i]   (vector product)
+void CrossProduct(const Vector3DArray &a, const Vector3DArray &b,
+                  Vector3DArray &out);
+//! batch kernel: out[i] = sum_j  G*m[j]*(r[j]-r[i]) / (|r[j]-r[i]|^2+eps2)^1.5
+//! (pairwise gravity-like interaction, eps2 is softening, O(N^2))
+void Gravity(const Vector3DArray &r, const double *m, double G, double eps2,
+             Vector3DArray &out);
+
+////////////////////////////////////////////////////////////////////////////
+//! array of N 3D vector integrators with single batch input evaluation
+//! (replaces N Integrator3D with block expressions for particle systems)
+//!
+//! The 3N states are integrated as single block (see aIntegratorArray),
+//! the derivative is computed by method Derivative() for all elements
+//! at once, the default is state of input array (chained integrators)
+//! or zero.
+//! \ingroup simlib3D
+class IntegratorArray3D : public aIntegratorArray {
+  IntegratorArray3D *input;            // input array (or 0)
+  Vector3DArray state, oldstate;       // states of all elements
+  Vector3DArray deriv, oldderiv;       // derivatives of all elements
+  Vector3DArray initval;               // initial values
+  void Create(unsigned n);
+ protected:
+  virtual void Derivative(Vector3DArray &d); //!< compute all derivatives
+ public:
+  explicit IntegratorArray3D(unsigned n);
+  explicit IntegratorArray3D(IntegratorArray3D &input); // derivative = input
+  virtual ~IntegratorArray3D();
+  unsigned Size() const { return state.Size(); }
+  Value3D Value(unsigned i) const { return state[i]; } //!< state of element i
+  const Vector3DArray &State() const { return state; } //!< all states
+  void Init(unsigned i, const Value3D &v);  //!< initial value of element i
+  void Set(unsigned i, const Value3D &v);   //!< set state of element i
+  Input3D operator[] (unsigned i);     //!< element as 3D block (for output)
+  // interface of aIntegratorArray
+  virtual void Eval();                 // deriv = Derivative()
+  virtual void Init();                 // state = initial values
+};
+
 ////////////////////////////////////////////////////////////////////////////
 
 inline void Print(Value3D a) { a.Print(); }
@@ -33,32 +33,71 @@ SIMLIB_IMPLEMENTATION;
 //
 void Stat::operator () (double x)
 {
-  sx  += x;
+  double y = x - csx;        // Kahan summation
+  double t = sx + y;
+  csx = (t - sx) - y;
+  sx  = t;
   sx2 += x*x;
   if(++n==1) min=max=x;
   else {
     if(x<min) min = x;
     if(x>max) max = x;
   }
+  double d = x - mean;       // Welford
+  mean += d/n;
+  m2 += d*(x - mean);
+  if(qs) (*qs)(x);
 };
 
+////////////////////////////////////////////////////////////////////////////
+//  operator +=  --- merge statistics (e.g. of independent replications)
+//
+Stat &Stat::operator += (const Stat &x)
+{
+  if(x.n==0) return *this;
+  if(n==0) { min = x.min; max = x.max; }
+  else {
+    if(x.min<min) min = x.min;
+    if(x.max>max) max = x.max;
+  }
+  double nn = double(n) + x.n;
+  double d = x.mean - mean;
+  m2 += x.m2 + d*d*(double(n)*x.n/nn);    // Chan et al.
+  mean += d*(x.n/nn);
+  double y = (x.sx - x.csx) - csx;       // Kahan summation
+  double t = sx + y;
+  csx = (t - sx) - y;
+  sx = t;
+  sx2 += x.sx2;
+  n += x.n;
+  if(x.qs) {
+    if(!qs) qs = new TDigest(x.qs->Compression());
+    qs->Merge(*x.qs);
+  }
+  return *this;
+}
+
 
 ////////////////////////////////////////////////////////////////////////////
 //  constructors
 //
 Stat::Stat(const char *name) :
-  sx(0), sx2(0),
+  sx(0), csx(0), sx2(0),
+  mean(0), m2(0),
   min(0), max(0),
-  n(0)
+  n(0),
+  qs(0)
 {
   Dprintf(("Stat::Stat(\"%s\")",name));
   SetName(name);
 }
 
 Stat::Stat() :
-  sx(0), sx2(0),
+  sx(0), csx(0), sx2(0),
+  mean(0), m2(0),
   min(0), max(0),
-  n(0)
+  n(0),
+  qs(0)
 {
   Dprintf(("Stat::Stat()"));
 }
@@ -69,6 +108,7 @@ Stat::Stat() :
 Stat::~Stat()
 {
   Dprintf(("Stat::~Stat() // \"%s\" ", Name()));
+  delete qs;
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -76,9 +116,28 @@ Stat::~Stat()
 //
 void Stat::Clear()
 {
-  sx = sx2 = 0;    // sums
+  sx = csx = sx2 = 0;    // sums
+  mean = m2 = 0;
   min = max = 0;
   n = 0;           // # of records
+  if(qs) qs->Clear();
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  Stat::EnableQuantiles --- estimate quantiles of next records
+//
+void Stat::EnableQuantiles(double compression)
+{
+  if(!qs) qs = new TDigest(compression);
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  Stat::Quantile
+//
+double Stat::Quantile(double q) const
+{
+  if (!qs) SIMLIB_error(QuantileNotEnabled);
+  return qs->Quantile(q);
 }
 
 
@@ -97,8 +156,7 @@ double Stat::MeanValue() const
 double Stat::StdDev() const
 {
   if (n<2)  SIMLIB_error(StatDispError);
-  double mv = sx/n;
-  return sqrt((sx2-n*mv*mv)/(n-1));
+  return sqrt(m2/(n-1));
 }
 
 }
@@ -0,0 +1,181 @@
+/////////////////////////////////////////////////////////////////////////////
+//! \file  tdigest.cc  Streaming quantile estimation
+//
+// Copyright (c) 2026 agent <agent@local>
+//
+// This library is licensed under GNU Library GPL. See the file COPYING.
+//
+
+//
+// class TDigest implementation (merging t-digest, scale function k1)
+//
+// T. Dunning, O. Ertl: Computing Extremely Accurate Quantiles Using
+// t-Digests, 2019
+//
+
+////////////////////////////////////////////////////////////////////////////
+// interface
+//
+
+#include "simlib.h"
+#include "internal.h"
+
+#include <cmath>
+#include <algorithm>
+
+
+////////////////////////////////////////////////////////////////////////////
+// implementation
+//
+
+namespace simlib3 {
+
+SIMLIB_IMPLEMENTATION;
+
+static const double PI = 3.14159265358979323846;
+
+////////////////////////////////////////////////////////////////////////////
+// constructor
+//
+TDigest::TDigest(double compression) :
+  delta(compression < 10 ? 10 : compression),
+  total(0), bufw(0),
+  reverse(false),
+  min(0), max(0)
+{
+  Dprintf(("TDigest::TDigest(%g)", compression));
+  buf.reserve(5 * unsigned(delta));
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Clear --- initialize
+//
+void TDigest::Clear()
+{
+  c.clear();
+  buf.clear();
+  total = bufw = 0;
+  reverse = false;
+  min = max = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// operator () --- record value x with weight w
+//
+void TDigest::operator () (double x, double w)
+{
+  if (w <= 0)
+    return;
+  if (Weight() == 0)
+    min = max = x;
+  else {
+    if (x < min) min = x;
+    if (x > max) max = x;
+  }
+  Centroid a = { x, w, true };
+  buf.push_back(a);
+  bufw += w;
+  if (buf.size() >= 5 * unsigned(delta))
+    Compress();
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Merge --- add all values of digest d
+//
+void TDigest::Merge(const TDigest &d)
+{
+  if (d.Weight() == 0)
+    return;
+  if (&d == this) {             // doubling of all weights
+    TDigest copy(d);
+    Merge(copy);
+    return;
+  }
+  if (Weight() == 0) {
+    min = d.min;
+    max = d.max;
+  } else {
+    if (d.min < min) min = d.min;
+    if (d.max > max) max = d.max;
+  }
+  buf.insert(buf.end(), d.c.begin(), d.c.end());
+  buf.insert(buf.end(), d.buf.begin(), d.buf.end());
+  bufw += d.Weight();
+  Compress();
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Compress --- merge buffered values into centroids
+// neighbouring centroids are joined while the joined centroid
+// spans at most one unit of scale k(q) = delta/(2*PI)*asin(2q-1)
+//
+void TDigest::Compress() const
+{
+  if (buf.empty())
+    return;
+  buf.insert(buf.end(), c.begin(), c.end());
+  std::sort(buf.begin(), buf.end());
+  if (reverse)                  // alternate direction (removes bias)
+    std::reverse(buf.begin(), buf.end());
+  const double W = total + bufw;
+  const double norm = delta / (2 * PI);
+  c.clear();
+  Centroid cur = buf[0];
+  double wsofar = 0;                            // weight left of cur
+  double klimit = norm * asin(-1.0) + 1;        // k(q_left) + 1
+  for (unsigned i = 1; i < buf.size(); i++) {
+    double q = (wsofar + cur.weight + buf[i].weight) / W;
+    if (norm * asin(2 * q - 1) <= klimit) {     // join
+      cur.single = cur.single && buf[i].single && buf[i].mean == cur.mean;
+      cur.weight += buf[i].weight;
+      cur.mean += (buf[i].mean - cur.mean) * buf[i].weight / cur.weight;
+    } else {
+      c.push_back(cur);
+      wsofar += cur.weight;
+      klimit = norm * asin(2 * wsofar / W - 1) + 1;
+      cur = buf[i];
+    }
+  }
+  c.push_back(cur);
+  if (reverse)
+    std::reverse(c.begin(), c.end());
+  reverse = !reverse;
+  buf.clear();
+  total = W;
+  bufw = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Quantile --- estimate of q-quantile
+// piecewise linear interpolation of the inverse distribution function
+// through points (cumulative weight, value): min at 0, midpoint of each
+// centroid (both ends of centroids with equal values) and max at end
+//
+double TDigest::Quantile(double q) const
+{
+  if (q < 0 || q > 1 || Weight() == 0)
+    SIMLIB_error(QuantileRangeError);
+  Compress();
+  const double index = q * total;       // position in weight
+  double px = 0, py = min;              // previous point
+  double cum = 0;                       // weight left of c[i]
+  for (unsigned i = 0; i < c.size(); i++) {
+    const double w = c[i].weight;
+    double x1 = c[i].single ? cum : cum + w / 2;
+    double x2 = c[i].single ? cum + w : x1;
+    if (index < x1)                     // between previous and c[i]
+      return py + (c[i].mean - py) * (index - px) / (x1 - px);
+    if (index <= x2)                    // inside c[i] of equal values
+      return c[i].mean;
+    px = x2;
+    py = c[i].mean;
+    cum += w;
+  }
+  if (total <= px)
+    return max;
+  return py + (max - py) * (index - px) / (total - px);
+}
+
+} // namespace
+
+// end of tdigest.cc
@@ -0,0 +1,385 @@
+/////////////////////////////////////////////////////////////////////////////
+//! \file tracer.cc  Time-series tracing of continuous signals
+//
+// Copyright (c) 2026 agent <agent@local>
+//
+// This library is licensed under GNU Library GPL. See the file COPYING.
+//
+
+//
+//  This module contains implementation of class Tracer
+//
+//  classes:
+//     Tracer -- trace of continuous blocks into binary file
+//     SIMLIB_Tracer -- internal class for registration of tracers
+//
+
+////////////////////////////////////////////////////////////////////////////
+// interface
+//
+
+#include "simlib.h"
+#include "tracer.h"
+#include "internal.h"
+
+#include <cstdio>
+#include <cstring>
+#include <list>                 // for registration list of all tracers
+
+#if defined(__unix__) || defined(__APPLE__)
+#  include <unistd.h>
+#endif
+#if defined(_POSIX_THREADS) && _POSIX_THREADS > 0
+#  define SIMLIB_TRACER_THREAD
+#  include <pthread.h>          // writer thread
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////
+// implementation
+//
+
+namespace simlib3 {
+
+SIMLIB_IMPLEMENTATION;
+
+static const char MAGIC[] = "SIMLIB-TRACE1\n";
+static const unsigned BUFSIZE = 1 << 17;        // doubles in buffer (1MB)
+
+////////////////////////////////////////////////////////////////////////////
+/// writer of full buffers: transposition to columns + fwrite()
+/// runs in separate thread if POSIX threads are available, the tracer
+/// gets empty buffer back immediately (double buffering)
+struct Tracer::Writer {
+    FILE *file;                 //!< output file
+    const unsigned n;           //!< number of columns
+    double *spare;              //!< buffer owned by writer
+    double *col;                //!< columns for output
+    unsigned rows;              //!< rows in spare buffer
+#ifdef SIMLIB_TRACER_THREAD
+    bool busy;                  //!< spare buffer not written yet
+    bool quit;                  //!< end of thread
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    static void *Run(void *p) { // thread function
+        Writer *w = static_cast<Writer*>(p);
+        pthread_mutex_lock(&w->mutex);
+        for (;;) {
+            while (!w->busy && !w->quit)
+                pthread_cond_wait(&w->cond, &w->mutex);
+            if (!w->busy)
+                break;          // quit
+            pthread_mutex_unlock(&w->mutex);
+            w->Write();
+            pthread_mutex_lock(&w->mutex);
+            w->busy = false;
+            pthread_cond_broadcast(&w->cond);
+        }
+        pthread_mutex_unlock(&w->mutex);
+        return 0;
+    }
+#endif
+    Writer(FILE *f, unsigned _n, unsigned capacity) :
+        file(f), n(_n), rows(0)
+    {
+        spare = new double[capacity * n];
+        col = new double[capacity * n];
+#ifdef SIMLIB_TRACER_THREAD
+        busy = quit = false;
+        pthread_mutex_init(&mutex, 0);
+        pthread_cond_init(&cond, 0);
+        if (pthread_create(&thread, 0, Run, this) != 0)
+            SIMLIB_internal_error();
+#endif
+    }
+    ~Writer() {
+#ifdef SIMLIB_TRACER_THREAD
+        pthread_mutex_lock(&mutex);
+        quit = true;
+        pthread_cond_broadcast(&cond);
+        pthread_mutex_unlock(&mutex);
+        pthread_join(thread, 0);
+        pthread_cond_destroy(&cond);
+        pthread_mutex_destroy(&mutex);
+#endif
+        delete [] spare;
+        delete [] col;
+    }
+    /// write spare buffer as one block
+    void Write() {
+        for (unsigned r = 0; r < rows; r++)
+            for (unsigned c = 0; c < n; c++)
+                col[c * rows + r] = spare[r * n + c];
+        unsigned r32 = rows;
+        fwrite(&r32, sizeof(r32), 1, file);
+        fwrite(col, sizeof(double), rows * n, file);
+    }
+    /// take full buffer (r rows), return empty buffer
+    double *Put(double *full, unsigned r) {
+        Wait();                 // previous buffer written
+        double *empty = spare;
+        spare = full;
+        rows = r;
+#ifdef SIMLIB_TRACER_THREAD
+        pthread_mutex_lock(&mutex);
+        busy = true;
+        pthread_cond_broadcast(&cond);
+        pthread_mutex_unlock(&mutex);
+#else
+        Write();
+#endif
+        return empty;
+    }
+    /// wait until all data are written
+    void Wait() {
+#ifdef SIMLIB_TRACER_THREAD
+        pthread_mutex_lock(&mutex);
+        while (busy)
+            pthread_cond_wait(&cond, &mutex);
+        pthread_mutex_unlock(&mutex);
+#endif
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////
+/// registration of tracers (hooks into Run)
+class SIMLIB_Tracer {
+    static std::list<Tracer *> *listptr; //!< list of tracer objects
+  public:
+    static void Register(Tracer *p) {
+        if( listptr == 0 ) Initialize();
+        listptr->push_back(p);
+    }
+    static void UnRegister(Tracer *p) {
+        listptr->remove(p);
+        if( listptr->empty() ) Destroy();
+    }
+  private:
+    static void Initialize() {
+        listptr = new std::list<Tracer*>();
+        INSTALL_HOOK( Trace, SIMLIB_Tracer::StepAll );
+        INSTALL_HOOK( TraceStart, SIMLIB_Tracer::SampleAll );
+        INSTALL_HOOK( TraceEnd, SIMLIB_Tracer::FlushAll );
+    }
+    static void Destroy() {
+        delete listptr;
+        listptr = 0;
+        INSTALL_HOOK( Trace, 0 );
+        INSTALL_HOOK( TraceStart, 0 );
+        INSTALL_HOOK( TraceEnd, 0 );
+    }
+    /// called each continuous step
+    static void StepAll() {
+        std::list<Tracer *>::iterator i;
+        for( i=listptr->begin(); i!=listptr->end(); ++i)
+            (*i)->Step();
+    }
+    /// called at start of Run()
+    static void SampleAll() {
+        std::list<Tracer *>::iterator i;
+        for( i=listptr->begin(); i!=listptr->end(); ++i)
+            (*i)->Sample();
+    }
+    /// called at end of Run()
+    static void FlushAll() {
+        std::list<Tracer *>::iterator i;
+        for( i=listptr->begin(); i!=listptr->end(); ++i)
+            (*i)->Flush();
+    }
+};
+
+std::list<Tracer *> *SIMLIB_Tracer::listptr = 0;
+
+////////////////////////////////////////////////////////////////////////////
+// constructor --- open output file
+//
+Tracer::Tracer(const char *filename, unsigned k) :
+  file(0),
+  writer(0),
+  buf(0),
+  capacity(0),
+  rows(0),
+  decimation(k ? k : 1),
+  counter(0),
+  samples(0),
+  started(false)
+{
+  Dprintf(("Tracer::Tracer(\"%s\",%u)", filename, k));
+  SetName(filename);
+  file = fopen(filename, "wb");
+  if (!file)
+    SIMLIB_error(TracerFileError);
+  names.push_back("Time");
+  SIMLIB_Tracer::Register(this);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// destructor --- write rest of data, close file
+//
+Tracer::~Tracer()
+{
+  Dprintf(("Tracer::~Tracer() // \"%s\"", Name()));
+  SIMLIB_Tracer::UnRegister(this);
+  Flush();
+  delete writer;
+  fclose(file);
+  delete [] buf;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Add --- trace output of block b (before the first sample only)
+//
+void Tracer::Add(aContiBlock &b, const char *name)
+{
+  if (started)
+    SIMLIB_error(TracerAddError);
+  blocks.push_back(&b);
+  if (name)
+    names.push_back(name);
+  else if (b.HasName())
+    names.push_back(b.Name());
+  else {                        // unnamed block: column number
+    char s[16];
+    sprintf(s, "col%u", unsigned(names.size()));
+    names.push_back(s);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////
+// SetDecimation --- record every k-th integration step
+//
+void Tracer::SetDecimation(unsigned k)
+{
+  decimation = k ? k : 1;
+  counter = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Start --- allocate buffer, write file header (columns are fixed now)
+//
+void Tracer::Start()
+{
+  const unsigned n = Columns();
+  capacity = BUFSIZE / n;
+  if (capacity < 64)
+    capacity = 64;
+  buf = new double[capacity * n];
+  fwrite(MAGIC, 1, sizeof(MAGIC) - 1, file);
+  unsigned n32 = n;
+  fwrite(&n32, sizeof(n32), 1, file);
+  for (unsigned i = 0; i < n; i++)
+    fwrite(names[i].c_str(), 1, names[i].size() + 1, file);
+  fflush(file);                 // header before data of writer
+  writer = new Writer(file, n, capacity);
+  started = true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Step --- record at each k-th integration step
+//
+void Tracer::Step()
+{
+  if (++counter < decimation)
+    return;
+  counter = 0;
+  Sample();
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Sample --- record time and values of all blocks (one row)
+//
+void Tracer::Sample()
+{
+  if (!started)
+    Start();
+  if (rows == capacity) {
+    buf = writer->Put(buf, rows);       // written in background
+    rows = 0;
+  }
+  const unsigned n = blocks.size();
+  double *p = buf + rows * (n + 1);     // row-major while recording
+  *p++ = Time;
+  for (unsigned i = 0; i < n; i++)
+    *p++ = blocks[i]->Value();
+  rows++;
+  samples++;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Flush --- write all buffered rows, wait for the writer
+//
+void Tracer::Flush()
+{
+  if (!started)
+    return;
+  Dprintf(("Tracer::Flush() // %u rows", rows));
+  if (rows > 0) {
+    buf = writer->Put(buf, rows);
+    rows = 0;
+  }
+  writer->Wait();
+  fflush(file);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Output --- print status
+//
+void Tracer::Output() const
+{
+  Print("Tracer \"%s\": %u columns, %lu samples, decimation %u\n",
+        Name(), Columns(), samples, decimation);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Convert --- trace file to text: "# names" line, then one row per line
+// (returns false for bad input file)
+//
+bool Tracer::Convert(const char *tracefile, const char *textfile)
+{
+  FILE *in = fopen(tracefile, "rb");
+  if (!in)
+    return false;
+  bool ok = false;
+  FILE *out = 0;
+  char magic[sizeof(MAGIC)] = "";
+  unsigned n = 0, r;
+  std::vector<double> col;
+  if (fread(magic, 1, sizeof(MAGIC) - 1, in) != sizeof(MAGIC) - 1 ||
+      strcmp(magic, MAGIC) != 0 ||
+      fread(&n, sizeof(n), 1, in) != 1 || n == 0)
+    goto end;
+  out = fopen(textfile, "w");
+  if (!out)
+    goto end;
+  fputs("#", out);
+  for (unsigned i = 0; i < n; i++) {    // column names
+    fputc(' ', out);
+    int c;
+    while ((c = fgetc(in)) > 0)
+      fputc(c, out);
+    if (c < 0)
+      goto end;
+  }
+  fputc('\n', out);
+  while (fread(&r, sizeof(r), 1, in) == 1) {    // blocks
+    col.resize(size_t(n) * r);
+    if (fread(&col[0], sizeof(double), col.size(), in) != col.size())
+      goto end;
+    for (unsigned i = 0; i < r; i++) {
+      for (unsigned c = 0; c < n; c++)
+        fprintf(out, c ? " %g" : "%g", col[c * r + i]);
+      fputc('\n', out);
+    }
+  }
+  ok = true;
+ end:
+  if (out)
+    fclose(out);
+  fclose(in);
+  return ok;
+}
+
+} // namespace
+
+// end of tracer.cc
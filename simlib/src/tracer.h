@@ -0,0 +1,78 @@
+/////////////////////////////////////////////////////////////////////////////
+//! \file tracer.h   Time-series tracing of continuous signals --- interface
+//
+// Copyright (c) 2026 agent <agent@local>
+//
+// This library is licensed under GNU Library GPL. See the file COPYING.
+//
+
+//
+//  Tracer records values of continuous blocks at each integration step
+//  (or at each k-th step) into memory buffer as raw doubles. Full
+//  buffers are transposed and written into binary file by blocks of
+//  columns in separate thread (if POSIX threads are available), there
+//  is no text formatting during simulation run.
+//
+//  Usage:
+//      Tracer tr("model.trc", 10);     // every 10th step
+//      tr.Add(x, "x"); tr.Add(v, "v");
+//      ... Run() ...
+//      Tracer::Convert("model.trc", "model.dat"); // text for gnuplot
+//
+//  File format (native byte order):
+//      "SIMLIB-TRACE1\n", number of columns n (unsigned 32-bit),
+//      n zero-terminated column names (first is "Time"),
+//      blocks: number of rows r (unsigned 32-bit), n columns of r doubles
+//
+
+#ifndef __SIMLIB__
+#   error "tracer.h: 26: you should include simlib.h first"
+#endif
+#if __SIMLIB__ < 0x0307
+#   error "tracer.h: 29: requires SIMLIB version 3.07 and higher"
+#endif
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace simlib3 {
+
+////////////////////////////////////////////////////////////////////////////
+//! trace of continuous block outputs (binary, columnar)
+//! \ingroup simlib
+class Tracer : public SimObject {
+    Tracer(const Tracer&);                  // disable copy ctor
+    Tracer&operator=(const Tracer&);        // disable assignment
+    std::vector<aContiBlock*> blocks;       // traced blocks
+    std::vector<std::string> names;         // column names
+    struct Writer;                          // writing of full buffers
+    FILE *file;                             // output file
+    Writer *writer;                         // (asynchronous if possible)
+    double *buf;                            // rows: buf[row*Columns()+col]
+    unsigned capacity;                      // rows in buffer
+    unsigned rows;                          // used rows
+    unsigned decimation;                    // record every k-th step
+    unsigned counter;                       // steps since last record
+    unsigned long samples;                  // number of recorded rows
+    bool started;                           // header written
+    void Start();
+  public:
+    Tracer(const char *filename, unsigned decimation=1);
+    virtual ~Tracer();
+    virtual void Output() const;            //!< print status
+    void Add(aContiBlock &b, const char *name=0); //!< add traced block
+    void Add(aContiBlock *b, const char *name=0) { Add(*b, name); }
+    void SetDecimation(unsigned k);         //!< record every k-th step
+    void Step();                //!< integration step (called automatically)
+    void Sample();                          //!< record values now
+    void Flush();                           //!< write buffer to file
+    unsigned Columns() const { return blocks.size() + 1; }
+    unsigned long Samples() const { return samples; }
+    //! convert trace file to text (gnuplot) format
+    static bool Convert(const char *tracefile, const char *textfile);
+};
+
+} // namespace
+
+// end of tracer.h
@@ -31,20 +31,24 @@ SIMLIB_IMPLEMENTATION;
 //
 TStat::TStat(double initval):
   sxt(0), sx2t(0),
+  csxt(0), csx2t(0),
   min(initval), max(initval),
   t0(Time), tl(Time),     // time of initialization and last op
   xl(initval),            // last value
-  n(0UL)                  // number of records
+  n(0UL),                 // number of records
+  qs(0)
 {
   Dprintf(("TStat::TStat()"));
 }
 
 TStat::TStat(const char *name, double initval) :
   sxt(0), sx2t(0),
+  csxt(0), csx2t(0),
   min(initval), max(initval),
   t0(Time), tl(Time),
   xl(initval),
-  n(0UL)
+  n(0UL),
+  qs(0)
 {
   Dprintf(("TStat::TStat(\"%s\")",name));
   SetName(name);
@@ -56,6 +60,7 @@ TStat::TStat(const char *name, double initval) :
 TStat::~TStat()
 {
   Dprintf(("TStat::~TStat() // \"%s\" ", Name()));
+  delete qs;
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -64,9 +69,17 @@ TStat::~TStat()
 void TStat::operator () (double x)
 {
   if (Time<tl) SIMLIB_warning(TStatNotInitialized);
-  double tt = xl*(double(Time)-tl);
-  sxt  += tt;
-  sx2t += xl*tt;
+  double dt = double(Time)-tl;
+  double tt = xl*dt;
+  double y = tt - csxt;     // Kahan summation
+  double t = sxt + y;
+  csxt = (t - sxt) - y;
+  sxt  = t;
+  y = xl*tt - csx2t;
+  t = sx2t + y;
+  csx2t = (t - sx2t) - y;
+  sx2t = t;
+  if(qs) (*qs)(xl, dt);     // value xl lasted dt
   xl = x;
   tl = Time;
   if(++n==1) min=max=x;   // TODO: check
@@ -84,10 +97,34 @@ void TStat::Clear(double initval)
 {
   Dprintf(("TStat::Clear() // \"%s\" ", Name()));
   sxt = sx2t = 0;
+  csxt = csx2t = 0;
   min = max = initval;
   t0 = tl = Time;
   xl = initval;       // last value
   n = 0UL;
+  if(qs) qs->Clear();
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  EnableQuantiles --- estimate time-weighted quantiles from now
+//
+void TStat::EnableQuantiles(double compression)
+{
+  if(!qs) qs = new TDigest(compression);
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  Quantile --- value x, which is not exceeded for fraction q of time
+//
+double TStat::Quantile(double q) const
+{
+  if(!qs) SIMLIB_error(QuantileNotEnabled);
+  if(Time<tl)
+    SIMLIB_error(TStatNotInitialized);
+  if(Time==tl) return qs->Quantile(q);
+  TDigest d(*qs);       // count last period
+  d(xl, double(Time)-tl);
+  return d.Quantile(q);
 }
 
 ////////////////////////////////////////////////////////////////////////////
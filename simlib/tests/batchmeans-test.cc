@@ -0,0 +1,55 @@
+// batchmeans-test.cc
+//
+// this tests BatchMeans output analysis of SIMLIB/C++
+// M/M/1 queue (rho=0.8) starting with 200 waiting customers:
+// 1) warm-up detection and confidence interval of queue length (TStat)
+// 2) waiting time in queue (Stat)
+// 3) run stopped when required precision is reached
+//
+
+#include "simlib.h"
+
+Facility F("F");
+
+class Customer : public Process {
+  void Behavior() {
+    Seize(F);
+    Wait(Exponential(0.8));
+    Release(F);
+  }
+};
+
+class Generator : public Event {
+  void Behavior() {
+    (new Customer)->Activate();
+    Activate(Time + Exponential(1));
+  }
+};
+
+int main()
+{
+  SetOutput("batchmeans-test.out");
+  Print("# BatchMeans test\n");
+  RandomSeed(1234567);
+  BatchMeans len(F.Q1->StatN, 100, 0.05);   // stops the run
+  BatchMeans wait(F.Q1->StatDT, 100, 0.05);
+  len.SetName("queue length");
+  wait.SetName("waiting time");
+  wait.StopRun(false);
+  Init(0, 1e7);
+  for(int i=0; i<200; i++)           // initial backlog
+    (new Customer)->Activate();
+  (new Generator)->Activate();
+  Run();
+  // exact values: Lq = rho^2/(1-rho) = 3.2, StatDT records only
+  // customers who waited: Wq/P(wait) = 3.2/0.8 = 4
+  Print("# stopped at time %g\n", double(Time));
+  Print("# queue length: %.4f +- %.4f (exact 3.2), warm-up until %g\n",
+        len.MeanValue(), len.HalfWidth(), len.WarmUpTime());
+  Print("# waiting time: %.4f +- %.4f (exact 4.0), warm-up until %g\n",
+        wait.MeanValue(), wait.HalfWidth(), wait.WarmUpTime());
+  Print("# without truncation: queue length %.4f, waiting time %.4f\n",
+        F.Q1->StatN.MeanValue(), F.Q1->StatDT.MeanValue());
+  len.Output();
+  wait.Output();
+}
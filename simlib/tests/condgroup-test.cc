@@ -0,0 +1,71 @@
+// condgroup-test.cc
+//
+// this tests the ConditionGroup of SIMLIB/C++
+// many thresholds on single signal, results are compared with
+// the same number of separate Condition blocks
+//
+
+#include "simlib.h"
+
+const int N = 200;             // number of thresholds
+const double tend = 10;
+
+// signal: harmonic oscillator x = sin(t)
+struct Oscillator {
+  Integrator v, x;
+  Oscillator(): v(-x, 1), x(v, 0) {}
+} osc;
+
+int experiment;
+long events[2];                // number of state events
+double lasttime[2];            // time of last state event
+double sumtime[2];             // sum of state event times
+
+void Record(bool up) {
+  events[experiment] += up ? 1 : 1000;  // count ups and downs separately
+  lasttime[experiment] = Time;
+  sumtime[experiment] += Time;
+}
+
+double Level(int i) { return -0.995 + 1.99*i/(N-1); }
+
+// experiment 0: separate conditions
+class Cond : public Condition {
+  void Action() { if(experiment==0) Record(Up()); }
+ public:
+  Cond(double level) : Condition(osc.x - level) {}
+};
+
+// experiment 1: single group of thresholds
+ConditionGroup levels(osc.x);
+class Threshold : public ThresholdCondition {
+  void Action() { if(experiment==1) Record(Up()); }
+ public:
+  Threshold(double level) : ThresholdCondition(levels, level) {}
+};
+
+int main()
+{
+  SetOutput("condgroup-test.out");
+  SetStep(1e-8, 0.01);
+  Print("# ConditionGroup test, %d thresholds\n", N);
+  for(experiment=0; experiment<2; experiment++) {
+    Cond *c[N];
+    Threshold *t[N];
+    for(int i=0; i<N; i++) {
+      if(experiment==0) c[i] = new Cond(Level(i));
+      else              t[i] = new Threshold(Level(i));
+    }
+    Init(0, tend);
+    Run();
+    Print("# experiment %d: %ld ups, %ld downs, last at %.6f, sum %.6f\n",
+          experiment, events[experiment] % 1000, events[experiment] / 1000,
+          lasttime[experiment], sumtime[experiment]);
+    for(int i=0; i<N; i++) {
+      if(experiment==0) delete c[i];
+      else              delete t[i];
+    }
+  }
+  Print("# group size after delete: %u\n", levels.Size());
+}
+
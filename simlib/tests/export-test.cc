@@ -0,0 +1,85 @@
+// export-test.cc
+//
+// this tests StatExport (JSON lines) of SIMLIB/C++
+// 1) periodic snapshots during run + final snapshot
+// 2) all supported statistics objects
+// 3) many objects (buffered write)
+//
+
+#include "simlib.h"
+#include <cstdio>
+#include <cstring>
+
+Facility F("Box \"A\"");
+Store S("Store", 3);
+MultiFacility M("Servers", 2);
+Histogram H("Time in system", 0, 1, 5);
+LogHistogram LH("Time in system (log)", 0.001, 3);
+Stat W("Wait");
+TStat N("In system");
+Facility *many[500];
+
+class Customer : public Process {
+  void Behavior() {
+    double t0 = Time;
+    N(N.LastValue() + 1);
+    Seize(F);
+    Wait(Exponential(0.5));
+    Release(F);
+    W(Time - t0);
+    Enter(S, 1);
+    Wait(Exponential(1.5));
+    Leave(S, 1);
+    Seize(M);
+    Wait(Exponential(1.2));
+    Release(M);
+    Facility &f = *many[long(Random() * 500)];
+    Seize(f);
+    Wait(Exponential(0.1));
+    Release(f);
+    H(Time - t0);
+    LH(Time - t0);
+    N(N.LastValue() - 1);
+  }
+};
+
+class Generator : public Event {
+  void Behavior() {
+    (new Customer)->Activate();
+    Activate(Time + Exponential(1));
+  }
+};
+
+int main()
+{
+  SetOutput("export-test.out");
+  Print("# StatExport test\n");
+  RandomSeed(1234567);
+  StatExport ex("export-test.dat", 100);
+  ex.Add(F);
+  ex.Add(S);
+  ex.Add(M);
+  ex.Add(H);
+  ex.Add(LH);
+  ex.Add(W);
+  ex.Add(N);
+  ex.Add(*F.Q1);
+  for (int i = 0; i < 500; i++)
+    ex.Add(*(many[i] = new Facility));
+  Init(0, 1000);
+  (new Generator)->Activate();
+  Run();
+  ex.Write();                   // final snapshot
+  Print("# %lu snapshots of %u objects\n", ex.Snapshots(), ex.Objects());
+  // copy the final snapshot of named objects
+  FILE *f = fopen("export-test.dat", "r");
+  char line[10000];
+  unsigned long lines = 0;
+  while (fgets(line, sizeof(line), f)) {
+    lines++;
+    if (strncmp(line, "{\"snapshot\":10,", 15) == 0 && !strstr(line, "\"name\":\"\""))
+      Print("%s", line);
+  }
+  fclose(f);
+  Print("# %lu lines\n", lines);
+}
@@ -0,0 +1,52 @@
+// loghisto-test.cc
+//
+// this tests LogHistogram of SIMLIB/C++
+// 1) values of very different magnitude, comparison with Histogram
+// 2) merge of replications and serialization
+//
+
+#include "simlib.h"
+#include <string>
+#include <cmath>
+
+int main()
+{
+  SetOutput("loghisto-test.out");
+  Print("# LogHistogram test\n");
+  RandomSeed(1234567);
+  LogHistogram lh("lognormal", 0.01, 2);  // 25% buckets
+  Histogram h("lognormal", 0, 10, 10);
+  for(int i=0; i<100000; i++) {
+    double x = Normal(0, 3);
+    x = (x < 0 ? -1 : 1) * exp(x);     // signed, 1e-6 .. 1e6
+    lh(x);
+    h(x);
+  }
+  lh.Output();
+  h.Output();
+
+  const double q[5] = { 0.01, 0.25, 0.5, 0.9, 0.999 };
+  LogHistogram r1(1e-6, 7), r2(1e-6, 7), all(1e-6, 7);
+  for(int i=0; i<200000; i++) {
+    double x = Exponential(1);
+    (i%2 ? r1 : r2)(x);
+    all(x);
+  }
+  std::string s1 = r1.Serialize();
+  std::string s2 = r2.Serialize();
+  LogHistogram m;                      // other unit: replaced by data
+  m.Deserialize(s1);
+  LogHistogram tmp;
+  tmp.Deserialize(s2);
+  m.Merge(tmp);
+  Print("# serialized: %u + %u bytes\n", unsigned(s1.size()), unsigned(s2.size()));
+  Print("# merged: n=%lu mean %.6f (all: n=%lu mean %.6f)\n",
+        m.Number(), m.MeanValue(), all.Number(), all.MeanValue());
+  for(int i=0; i<5; i++)
+    Print("# q=%-5g merged %.6f all %.6f exact %.6f\n",
+          q[i], m.Quantile(q[i]), all.Quantile(q[i]), -log(1-q[i]));
+  int diff = 0;                        // merge is lossless
+  for(int i=0; i<=1000; i++)
+    diff += m.Quantile(i/1000.0) != all.Quantile(i/1000.0);
+  Print("# different quantiles: %d\n", diff);
+}
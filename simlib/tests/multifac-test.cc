@@ -0,0 +1,95 @@
+// multifac-test.cc
+//
+// this tests the MultiFacility of SIMLIB/C++
+// 1) M/M/c system: MultiFacility(c) vs. Store with capacity c
+// 2) server selection policies
+// 3) large server farm
+//
+
+#include "simlib.h"
+
+const int C = 5;               // number of servers
+const double Tarr = 1.0;       // mean interarrival time
+const double Tserv = 4.5;      // mean service time
+const double tend = 20000;
+
+MultiFacility *mf;
+Store *st;
+Histogram *served;             // number of services of each server
+
+class Customer : public Process {
+  void Behavior() {
+    if(mf) {
+      unsigned i = Seize(*mf);
+      (*served)(i);
+      Wait(Exponential(Tserv));
+      Release(*mf);
+    } else {
+      Enter(*st, 1);
+      Wait(Exponential(Tserv));
+      Leave(*st, 1);
+    }
+  }
+};
+
+class Generator : public Event {
+  void Behavior() {
+    (new Customer)->Activate();
+    Activate(Time + Exponential(Tarr));
+  }
+};
+
+double Experiment(MultiFacility *f, Store *s, double t=tend) {
+  mf = f;
+  st = s;
+  RandomSeed(1234);
+  Init(0, t);
+  if(f) f->Clear(); else s->Clear();  // created after previous run
+  (new Generator)->Activate();
+  Run();
+  return f ? f->Q->StatDT.MeanValue() : s->Q->StatDT.MeanValue();
+}
+
+int main()
+{
+  SetOutput("multifac-test.out");
+  Print("# MultiFacility test\n");
+  {
+    Store s("Store", C);
+    double w = Experiment(0, &s);
+    Print("# Store:         mean wait %.6f, usage %.6f\n", w, s.tstat.MeanValue());
+  }
+  const char *names[3] = { "FIRST_FREE", "ROUND_ROBIN", "LEAST_UTILIZED" };
+  for(int p=0; p<3; p++) {
+    MultiFacility f("MF", C, MultiFacility::Policy(p));
+    Histogram h("served", 0, 1, C);
+    served = &h;
+    double w = Experiment(&f, 0);
+    Print("# %-14s mean wait %.6f, usage %.6f\n",
+          names[p], w, f.tstat.MeanValue());
+    for(int i=0; i<C; i++)
+      Print("#   server %d: %6u services, utilization %.4f\n",
+            i, h[i+1], f.ServerStat(i).MeanValue());
+    if(p==0)
+      f.Output();
+  }
+  {
+    const unsigned N = 3000;   // large farm, 2700 busy servers in mean
+    MultiFacility f("farm", N, MultiFacility::ROUND_ROBIN);
+    Histogram h("served", 0, 1, N);
+    served = &h;
+    double t = 20;
+    mf = &f;
+    RandomSeed(4321);
+    Init(0, t);
+    f.Clear();
+    for(int i=0; i<600; i++)   // arrivals 600x faster
+      (new Generator)->Activate(Exponential(Tarr));
+    Run();
+    unsigned long n = 0;
+    for(unsigned i=0; i<N; i++)
+      n += f.ServerStat(i).Number();
+    Print("# farm of %u servers: %lu services, mean busy %.3f, max %g\n",
+          N, n, f.tstat.MeanValue(), f.tstat.Max());
+  }
+}
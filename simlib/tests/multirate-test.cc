@@ -0,0 +1,93 @@
+// multirate-test.cc
+//
+// this tests the multirate integration method of SIMLIB/C++
+// fast oscillator driven by slow first order system,
+// the results of single-rate "rkf5" and "multirate" methods are
+// compared with exact solution
+// tolerance of multirate: coupling error |y''|*H*H/8 = 5e-5 for
+// macro step H=1 (not in step control, see multirate.h) + integration
+//
+
+#include "simlib.h"
+#include "multirate.h"
+#include <cmath>
+
+const double w = 100;         // fast oscillator frequency
+const double tau = 50;        // slow time constant
+
+// slow subsystem: y' = -y/tau
+struct Slow {
+  Integrator y;
+  Slow(): y(-y/tau, 1) {}
+} slw;
+Integrator &y = slw.y;
+// fast subsystem (input from slow subsystem): x'' = -w*w*(x-y)
+struct Oscillator {
+  Integrator v, x;
+  Oscillator(): v(-w*w*(x-y), 0), x(v, 0) {}
+} osc;
+Integrator &x = osc.x;
+Integrator &v = osc.v;
+
+// exact solution for x(0)=0, x'(0)=0
+double Exact(double t) {
+  const double A = w*w/(w*w + 1/(tau*tau));
+  return A*(exp(-t/tau) - cos(w*t) + sin(w*t)/(tau*w));
+}
+
+const double tolerance = 1e-4; // max. deviation of multirate from exact x
+
+Subsystem fast("fast", 1e-6, 1e-3);
+Subsystem slow("slow", 1e-6, 1);
+
+struct Results { double x, y; } res[2][11];
+int experiment;
+
+void Sample() {
+  int i = int(Time/10 + 0.5);
+  res[experiment][i].x = x.Value();
+  res[experiment][i].y = y.Value();
+}
+Sampler s(Sample, 10);
+
+int main()
+{
+  SetOutput("multirate-test.out");
+  SetAccuracy(1e-8, 1e-6);
+  fast.Add(x);
+  fast.Add(v);
+  slow.Add(y);
+  const char *methods[2] = { "rkf5", "multirate" };
+  for(experiment=0; experiment<2; experiment++) {
+    SetMethod(methods[experiment]);
+    SetStep(1e-6, 1);
+    Init(0, 100);
+    Run();
+    Print("# method %s: %ld steps\n",
+          methods[experiment], SIMLIB_statistics.StepCount);
+  }
+  Print("# time  x(exact)  x(rkf5)  x(multirate)  y(rkf5)  y(multirate)\n");
+  double err[2] = { 0, 0 };
+  for(int i=0; i<=10; i++) {
+    double xe = Exact(i*10.0);
+    Print("%g %.6f %.6f %.6f %.6f %.6f\n", i*10.0, xe,
+          res[0][i].x, res[1][i].x, res[0][i].y, res[1][i].y);
+    for(int k=0; k<2; k++)
+      err[k] = fmax(err[k], fabs(res[k][i].x - xe));
+  }
+  Print("# max |x-exact|: rkf5 %.2g, multirate %.2g (tolerance %g): %s\n",
+        err[0], err[1], tolerance, err[1] < tolerance ? "OK" : "FAILED");
+  fast.Output();
+  slow.Output();
+  // destroyed integrator is removed from its subsystem
+  bool removed;
+  {
+    Integrator tmp(y, 0);
+    slow.Add(tmp);
+    removed = slow.Size() == 2;
+  }
+  removed = removed && slow.Size() == 1 && slow[0] == &y;
+  Print("# destroyed integrator removed from subsystem: %s\n",
+        removed ? "OK" : "FAILED");
+  return err[1] < tolerance && removed ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+// nbody-test.cc
+//
+// this tests IntegratorArray3D and batch kernels of SIMLIB/3D
+// 1) three bodies: block expressions (Integrator3D) vs. IntegratorArray3D
+// 2) many bodies: IntegratorArray3D + Gravity kernel, energy check
+//
+
+#include "simlib.h"
+#include "simlib3D.h"
+#include <cmath>
+#include <vector>
+
+const double G = 1.0;          // gravity constant (scaled units)
+const double eps2 = 1e-4;      // softening
+
+////////////////////////////////////////////////////////////////////////////
+// particle system: r'' = Gravity(r)
+struct Bodies : public IntegratorArray3D {
+  std::vector<double> m;       // masses
+  IntegratorArray3D r;         // positions: r' = v
+  Bodies(unsigned n) : IntegratorArray3D(n), m(n), r(*this) {}
+  void Derivative(Vector3DArray &a) {  // velocity' = acceleration
+    Gravity(r.State(), &m[0], G, eps2, a);
+  }
+  double Energy() {            // total energy of the system
+    double e = 0;
+    for(unsigned i=0; i<Size(); i++) {
+      Value3D v = Value(i);
+      e += 0.5 * m[i] * scalar_product(v, v);
+      for(unsigned j=i+1; j<Size(); j++) {
+        Value3D d = r.Value(j) - r.Value(i);
+        e -= G * m[i] * m[j] / sqrt(scalar_product(d, d) + eps2);
+      }
+    }
+    return e;
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////
+// the same three bodies using 3D block expressions
+Constant3D Zero(0,0,0);
+struct MassPoint {
+  double m;
+  Expression3D inforce;        // input acceleration
+  Integrator3D v;
+  Integrator3D p;
+  MassPoint(double mass, Value3D p0, Value3D v0) :
+    m(mass), inforce(Zero), v(inforce, v0), p(v, p0) {}
+};
+
+Input3D Force(MassPoint &a, MassPoint &b) {   // acceleration of a by b
+  Input3D d = b.p - a.p;
+  Input r2 = ScalarProduct(d, d) + eps2;
+  return G * b.m * d / (r2 * Sqrt(r2));
+}
+
+const Value3D p0[3] = { Value3D(0,0,0), Value3D(1,0,0), Value3D(0,2,0.1) };
+const Value3D v0[3] = { Value3D(0,-0.1,0), Value3D(0,1,0), Value3D(-0.7,0,0) };
+const double m0[3] = { 1, 0.01, 0.02 };
+
+void Print3(const char *s, Value3D a) {
+  Print("%s %.8f %.8f %.8f\n", s, a.x(), a.y(), a.z());
+}
+
+int main()
+{
+  SetOutput("nbody-test.out");
+  Print("# IntegratorArray3D test\n");
+  SetStep(1e-6, 0.01);
+  SetAccuracy(1e-9, 1e-9);
+  {
+    MassPoint *b[3];
+    for(int i=0; i<3; i++)
+      b[i] = new MassPoint(m0[i], p0[i], v0[i]);
+    for(int i=0; i<3; i++)
+      b[i]->inforce.SetInput(Force(*b[i], *b[(i+1)%3])
+                             + Force(*b[i], *b[(i+2)%3]));
+    Init(0, 10);
+    Run();
+    for(int i=0; i<3; i++)
+      Print3("# Integrator3D      ", b[i]->p.Value());
+    for(int i=0; i<3; i++)
+      delete b[i];
+  }
+  {
+    Bodies b(3);
+    for(int i=0; i<3; i++) {
+      b.m[i] = m0[i];
+      b.r.Init(i, p0[i]);
+      b.Init(i, v0[i]);
+    }
+    Init(0, 10);
+    Run();
+    for(int i=0; i<3; i++)
+      Print3("# IntegratorArray3D ", b.r.Value(i));
+  }
+  {
+    const unsigned N = 400;    // cluster of N bodies
+    Bodies b(N);
+    RandomSeed(1234567);
+    for(unsigned i=0; i<N; i++) {
+      b.m[i] = 1.0/N;
+      b.r.Init(i, Value3D(Uniform(-1,1), Uniform(-1,1), Uniform(-1,1)));
+      b.Init(i, Value3D(Normal(0,0.1), Normal(0,0.1), Normal(0,0.1)));
+    }
+    SetAccuracy(1e-6, 1e-6);
+    double e0 = b.Energy();
+    Init(0, 0.5);
+    Run();
+    double e1 = b.Energy();
+    Print("# %u bodies: energy %.6f -> %.6f\n", N, e0, e1);
+  }
+  // kernels
+  Vector3DArray a(2), c(2);
+  a.Set(0, Value3D(1,0,0));  a.Set(1, Value3D(0,3,4));
+  c.Set(0, Value3D(0,1,0));  c.Set(1, Value3D(1,0,0));
+  double n[2];
+  Abs(a, n);
+  CrossProduct(a, c, c);
+  Print("# Abs: %g %g\n", n[0], n[1]);
+  Print3("# CrossProduct:", c[0]);
+  Print3("# CrossProduct:", c[1]);
+}
+
@@ -0,0 +1,77 @@
+// newton-test.cc
+//
+// this tests the NewtonKrylov algebraic loop solver of SIMLIB/C++
+// nonlinear chain of N nodes between boundary values 1 and z(t):
+//    x[i]^3 - (x[i-1]^3 + x[i+1]^3)/2 = 0,   x[-1] = 1,  x[N] = z
+// z is integrated: z' = -z, z(0) = 1
+// x[i]^3 is linear in i: x[i] = (1 + (i+1)/(N+1)*(exp(-3t)-1))^(1/3),
+// the last node drives integrator s' = x[N-1]^3 (exact s is known)
+//
+
+#include "simlib.h"
+#include <cmath>
+
+const unsigned N = 20;          // number of nodes
+const double tolerance = 1e-6;  // max. deviation from exact solution
+
+Integrator z(-z, 1);
+NewtonKrylov loop(N, 1e-12, 50);
+Integrator s(loop[N-1]*loop[N-1]*loop[N-1], 0);
+
+// exact solution
+double Exact(unsigned i, double t) {
+  return pow(1 + (i+1.0)/(N+1)*(exp(-3*t)-1), 1.0/3);
+}
+double ExactS(double t) { return t/(N+1) + N/(N+1.0)*(1-exp(-3*t))/3; }
+
+// residual of chain equation i
+double Residual(unsigned i) {
+  double left = (i==0) ? 1.0 : loop.Value(i-1);
+  double right = (i==N-1) ? z.Value() : loop.Value(i+1);
+  double x = loop.Value(i);
+  return x*x*x - (left*left*left + right*right*right)/2;
+}
+
+double maxerr = 0;              // max. deviation from exact x
+double maxres = 0;              // max. residual
+
+void Sample() {
+  double err = 0, res = 0;
+  for(unsigned i=0; i<N; i++) {
+    err = fmax(err, fabs(loop.Value(i) - Exact(i, Time)));
+    res = fmax(res, fabs(Residual(i)));
+  }
+  maxerr = fmax(maxerr, err);
+  maxres = fmax(maxres, res);
+  Print("%g %.8f %.8f %.8f %.2g %.2g\n", Time, loop.Value(0),
+        loop.Value(N-1), s.Value(), err, res);
+}
+Sampler sam(Sample, 1);
+
+int main()
+{
+  SetOutput("newton-test.out");
+  SetName(loop, "chain");
+  Print("# NewtonKrylov: nonlinear chain of %u nodes\n", N);
+  // x[i] = f(x) = x[i] - (x[i]^3 - (x[i-1]^3 + x[i+1]^3)/2)
+  for(unsigned i=0; i<N; i++) {
+    Input left = (i==0) ? Input(1.0) : loop[i-1];
+    Input right = (i==N-1) ? Input(z) : loop[i+1];
+    loop.SetInput(i, loop[i] - (loop[i]*loop[i]*loop[i]
+                     - (left*left*left + right*right*right)/2));
+    loop.Init(i, 0.5);          // not the solution at time 0
+  }
+  SetAccuracy(1e-10);
+  Init(0, 10);
+  Print("# time  x[0]  x[N-1]  s  max|x-exact|  max|residual|\n");
+  Run();
+  double serr = fabs(s.Value() - ExactS(Time));
+  Print("# max |residual| = %.2g\n", maxres);
+  Print("# Newton iterations = %lu, Jacobians = %lu, loop evaluations = %lu\n",
+        loop.IterationCount(), loop.JacobianCount(), loop.EvaluationCount());
+  Print("# max |x-exact| = %.2g, |s-exact| = %.2g (tolerance %g): %s\n",
+        maxerr, serr, tolerance,
+        (maxerr < tolerance && serr < tolerance) ? "OK" : "FAILED");
+  loop.Output();
+  return (maxerr < tolerance && serr < tolerance) ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+// optimize-test.cc
+//
+// this tests population-based optimization methods of SIMLIB/C++
+// 1) Rosenbrock function: CMA-ES and differential evolution
+// 2) simulation model: the same results for 1 and 4 worker processes
+// 3) evaluation cache: number of simulation runs
+// 4) Bayesian optimization: Branin function with few evaluations
+// 5) failed worker: cache entry is marked, the result is not stored,
+//    Bayesian optimization with failed evaluations
+//
+
+#include "simlib.h"
+#include "optimize.h"
+#include <cmath>
+#if defined(__unix__)
+#include <unistd.h>
+#endif
+
+// Rosenbrock function, minimum 0 at (1,1,1)
+double Rosenbrock(const ParameterVector &p)
+{
+  double s = 0;
+  for(int i=0; i<p.size()-1; i++)
+    s += 100*pow(p[i+1]-p[i]*p[i], 2) + pow(1-p[i], 2);
+  return s;
+}
+
+// Branin function, minimum 0.397887 (3 points)
+unsigned long evals;
+double Branin(const ParameterVector &p)
+{
+  const double PI = 3.14159265358979323846;
+  double x = p[0], y = p[1];
+  evals++;
+  return pow(y - 5.1/(4*PI*PI)*x*x + 5/PI*x - 6, 2) +
+         10*(1 - 1/(8*PI))*cos(x) + 10;
+}
+
+// M/M/1 with optimized service time: cost of fast server + waiting
+Facility F("F");
+double Tserv;
+unsigned long runs;             // number of simulation runs
+
+class Customer : public Process {
+  void Behavior() {
+    Seize(F);
+    Wait(Exponential(Tserv));
+    Release(F);
+  }
+};
+
+class Generator : public Event {
+  void Behavior() {
+    (new Customer)->Activate();
+    Activate(Time + Exponential(1));
+  }
+};
+
+double Cost(const ParameterVector &p)
+{
+  Tserv = p[0];
+  runs++;
+  Init(0, 2000);
+  F.Clear();
+  (new Generator)->Activate();
+  Run();
+  // exact: 1/Ts + 2*Ts/(1-Ts), minimum at Ts = 1/(1+sqrt(2))
+  return 1/Tserv + 2*F.Q1->StatDT.MeanValue();
+}
+
+#if defined(__unix__)
+// worker exits for x > 0.5 (evaluation fails)
+double Crash(const ParameterVector &p)
+{
+  if(p[0] > 0.5)
+    _exit(1);
+  return p[0];
+}
+
+// minimum 0 at 0.5, the worker exits above 0.6
+double CrashAbove(const ParameterVector &p)
+{
+  if(p[0] > 0.6)
+    _exit(1);
+  return (p[0] - 0.5) * (p[0] - 0.5);
+}
+#endif
+
+int main()
+{
+  SetOutput("optimize-test.out");
+  Print("# population-based optimization test\n");
+  {
+    Param a[3] = { Param("x", -2, 2), Param("y", -2, 2), Param("z", -2, 2) };
+    ParameterVector p(3, a);
+    double r = Optimize_cmaes(Rosenbrock, p, 300);
+    Print("# CMA-ES Rosenbrock: %.3g at (%.5f, %.5f, %.5f)\n",
+          r, double(p[0]), double(p[1]), double(p[2]));
+  }
+  {
+    Param a[3] = { Param("x", -2, 2), Param("y", -2, 2), Param("z", -2, 2) };
+    ParameterVector p(3, a);
+    double r = Optimize_de(Rosenbrock, p, 500);
+    Print("# DE     Rosenbrock: %.3g at (%.5f, %.5f, %.5f)\n",
+          r, double(p[0]), double(p[1]), double(p[2]));
+  }
+  Print("# M/M/1 cost: exact optimum %.5f at Ts=%.5f\n",
+        2*sqrt(2.0)+3-2, 1/(1+sqrt(2.0)));
+  for(int w=1; w<=4; w+=3) {
+    Param a[1] = { Param("Ts", 0.1, 0.9) };
+    ParameterVector p1(1, a), p2(1, a);
+    p1[0] = p2[0] = 0.5;
+    double r1 = Optimize_cmaes(Cost, p1, 15, 8, w);
+    double r2 = Optimize_de(Cost, p2, 10, 12, w);
+    Print("# workers %d: CMA-ES %.6f at Ts=%.6f, DE %.6f at Ts=%.6f\n",
+          w, r1, double(p1[0]), r2, double(p2[0]));
+  }
+  {
+    Param a[1] = { Param("Ts", 0.1, 0.9) };
+    ParameterVector p(1, a);
+    p[0] = 0.8;
+    runs = 0;
+    RandomSeed(1234567);
+    double r = Optimize_hooke(Cost, p, 0.5, 1e-2, 100);
+    Print("# Hooke-Jeeves:          %.6f at Ts=%.6f, %lu runs\n",
+          r, double(p[0]), runs);
+    for(int adaptive=0; adaptive<2; adaptive++) {
+      p[0] = 0.8;
+      runs = 0;
+      EvaluationCache c(Cost, 1e-6, adaptive ? 2 : 20, 20);
+      r = Optimize_hooke(c.Function(), p, 0.5, 1e-2, 100);
+      Print("# Hooke-Jeeves %s: %.6f at Ts=%.6f, %lu runs, %lu calls, "
+            "%lu points, %u replications of result\n",
+            adaptive ? "adaptive" : "fixed 20", r, double(p[0]),
+            runs, c.Calls(), c.Points(), c.Replications(p));
+    }
+  }
+  for(int w=1; w<=4; w+=3) {
+    Param a[1] = { Param("Ts", 0.1, 0.9) };
+    ParameterVector p(1, a);
+    p[0] = 0.5;
+    EvaluationCache c(Cost, 1e-3, 2, 10);
+    double r = Optimize_de(c.Function(), p, 10, 12, w);
+    Print("# workers %d: DE cached %.6f at Ts=%.6f, %lu runs, %lu calls\n",
+          w, r, double(p[0]), c.Runs(), c.Calls());
+  }
+  {
+    // Optimize_simann prints parameters named d and k
+    Param a[2] = { Param("d", -5, 10), Param("k", 0, 15) };
+    ParameterVector p1(2, a), p2(2, a);
+    evals = 0;
+    double r = Optimize_bayes(Branin, p1, 30, 4, 1);
+    Print("# Bayes Branin:  %.5f at (%.4f, %.4f), %lu evaluations\n",
+          r, double(p1[0]), double(p1[1]), evals);
+    evals = 0;
+    RandomSeed(1234567);
+    r = Optimize_simann(Branin, p2, 300);
+    Print("# SimAnn Branin: %.5f at (%.4f, %.4f), %lu evaluations\n",
+          r, double(p2[0]), double(p2[1]), evals);
+  }
+#if defined(__unix__)
+  {
+    Param a[1] = { Param("x", 0, 1) };
+    std::vector<ParameterVector> pop(2, ParameterVector(1, a));
+    pop[0][0] = 0.25;
+    pop[1][0] = 0.75;
+    EvaluationCache c(Crash, 1e-6, 2, 2);
+    EvaluationPool pool(2);
+    std::vector<double> r;
+    pool.Evaluate(c.Function(), pop, r);
+    double again = c(pop[1]);   // not run again (would exit)
+    Print("# failed worker: f(0.25)=%g (%u replications), "
+          "f(0.75)=%g (%u replications), again %g\n",
+          r[0], c.Replications(pop[0]), r[1], c.Replications(pop[1]), again);
+  }
+  {
+    Param a[1] = { Param("x", 0, 1) };
+    ParameterVector p(1, a);
+    p[0] = 0.2;
+    double r = Optimize_bayes(CrashAbove, p, 16, 2, 2);
+    Print("# Bayes with failed evaluations: %.3g at x=%.4f\n", r, double(p[0]));
+  }
+#endif
+}
@@ -0,0 +1,93 @@
+// quantile-test.cc
+//
+// this tests stable accumulation and quantile estimation in Stat/TStat
+// 1) variance of values with large offset (naive formula fails)
+// 2) quantiles of exponential distribution, merge of replications
+// 3) time-weighted quantiles in TStat
+// 4) quantiles of waiting time in Queue (M/M/1)
+//
+
+#include "simlib.h"
+#include <cmath>
+
+Facility F("F");
+TStat t("t");
+
+class Step : public Event {    // value 1 for 7 time units, then 5
+  void Behavior() { t(5); }
+};
+
+class Customer : public Process {
+  void Behavior() {
+    Seize(F);
+    Wait(Exponential(0.8));
+    Release(F);
+  }
+};
+
+class Generator : public Event {
+  void Behavior() {
+    (new Customer)->Activate();
+    Activate(Time + Exponential(1));
+  }
+};
+
+int main()
+{
+  SetOutput("quantile-test.out");
+  Print("# Stat/TStat quantile test\n");
+  RandomSeed(1234567);
+  {
+    Stat s("offset");
+    double sx = 0, sx2 = 0;
+    for(int i=0; i<1000000; i++) {
+      double x = 1e9 + Uniform(0, 1);      // variance 1/12
+      s(x);
+      sx += x;  sx2 += x*x;
+    }
+    double n = s.Number(), mv = sx/n;
+    Print("# stddev %.6f (naive %.6f, exact %.6f)\n",
+          s.StdDev(), sqrt(fabs(sx2 - n*mv*mv)/(n-1)), sqrt(1/12.0));
+  }
+  {
+    Stat s1("replication 1"), s2("replication 2"), all("all");
+    s1.EnableQuantiles();
+    s2.EnableQuantiles();
+    all.EnableQuantiles();
+    for(int i=0; i<1000000; i++) {
+      double x = Exponential(1);
+      (i%2 ? s1 : s2)(x);
+      all(x);
+    }
+    const double q[4] = { 0.5, 0.9, 0.99, 0.999 };
+    for(int i=0; i<4; i++)
+      Print("# exponential: q=%-5g %.5f (exact %.5f)\n",
+            q[i], all.Quantile(q[i]), -log(1-q[i]));
+    s1 += s2;
+    Print("# merged: n=%lu mean %.6f stddev %.6f P99 %.4f (all %.4f)\n",
+          s1.Number(), s1.MeanValue(), s1.StdDev(),
+          s1.Quantile(0.99), all.Quantile(0.99));
+    Print("# centroids: %u\n", all.Quantiles()->Centroids());
+  }
+  {
+    t.EnableQuantiles();
+    Init(0, 10);
+    t.Clear();
+    t(1);
+    (new Step)->Activate(7);
+    Run();
+    Print("# TStat: mean %g, median %g, 90%% quantile %g\n",
+          t.MeanValue(), t.Quantile(0.5), t.Quantile(0.9));
+  }
+  {
+    F.Q1->StatDT.EnableQuantiles();
+    Init(0, 100000);
+    F.Clear();
+    (new Generator)->Activate();
+    Run();
+    // M/M/1, rho=0.8: waiting time in queue is Exp(mu-lambda)
+    Print("# M/M/1 waiting time: 99%% quantile %.3f (exact %.3f)\n",
+          F.Q1->StatDT.Quantile(0.99), log(100.0)/0.25);
+    F.Output();
+  }
+}
@@ -0,0 +1,203 @@
+// queue-test.cc
+//
+// this tests ordering of Queue of SIMLIB/C++ (index of tails of keys)
+// the order of queue is compared with reference list, where sorted insert
+// is the old linear scan (insert after the last entity with key >= key)
+// 1) random mix of Priority and service priority (Facility::QueueIn),
+//    Insert, InsFirst, InsLast, PredIns, PostIns and Get of random entities
+// 2) removal of the tail of a key, next insert with the same key
+//
+
+#include "simlib.h"
+#include <list>
+
+using namespace simlib3;
+
+const int N = 20000;            // number of operations
+const int MAXLEN = 200;         // queue is emptied at this length
+
+class Item : public Event {
+  void Behavior() {}
+ public:
+  ServicePriority_t sp;         // service priority of last QueueIn (reference)
+  Item(): sp(0) {}
+};
+
+typedef std::list<Item*> Reference;
+
+// key of old linear-scan insert
+long RefKey(Item *e, bool service)
+{
+  return e->Priority + (service ? long(e->sp) << 8 : 0);
+}
+
+// old sorted insert: after the last entity with key >= key (scan from end)
+void RefSortedIns(Reference &ref, Item *e, bool service)
+{
+  const long key = RefKey(e, service);
+  Reference::iterator p = ref.end();
+  while(p != ref.begin()) {
+    Reference::iterator q = p;
+    --p;
+    if(RefKey(*p, service) >= key) { p = q; break; }
+  }
+  ref.insert(p, e);
+}
+
+// random position 0..n-1
+unsigned RandomIndex(unsigned n) { return unsigned(Random() * n); }
+
+// queue iterator at position k
+Queue::iterator At(Queue &q, unsigned k)
+{
+  Queue::iterator i = q.begin();
+  while(k--) ++i;
+  return i;
+}
+
+Reference::iterator At(Reference &ref, unsigned k)
+{
+  Reference::iterator i = ref.begin();
+  while(k--) ++i;
+  return i;
+}
+
+// the same order in queue and reference
+bool Same(Queue &q, Reference &ref)
+{
+  if(q.size() != ref.size())
+    return false;
+  Reference::iterator r = ref.begin();
+  for(Queue::iterator i = q.begin(); i != q.end(); ++i, ++r)
+    if((Entity*)(*i) != *r)
+      return false;
+  return true;
+}
+
+// remove entity at position k from queue and reference
+Item *Get(Queue &q, Reference &ref, unsigned k)
+{
+  Item *e = (Item*)q.Get(At(q, k));
+  Reference::iterator r = At(ref, k);
+  if(*r != e) return 0;
+  ref.erase(r);
+  return e;
+}
+
+// 1) random operations, returns number of errors
+int RandomTest()
+{
+  Facility f("F");
+  Queue &q = *f.Q1;
+  Reference ref;
+  std::list<Item*> free_items;
+  int errors = 0;
+  unsigned long count[8] = { 0 };
+  RandomSeed(1234);
+  for(int n=0; n<N && errors==0; n++) {
+    Item *e = 0;
+    if(free_items.empty())
+      e = new Item;
+    else {
+      e = free_items.front();
+      free_items.pop_front();
+    }
+    e->Priority = Entity::Priority_t(int(RandomIndex(5)) - 2);
+    double r = Random();
+    int op = r < 0.5 ? 0 :            // Facility::QueueIn (sorted, both keys)
+             r < 0.54 ? 1 :           // Insert (sorted by Priority only)
+             r < 0.56 ? 2 :           // InsFirst
+             r < 0.58 ? 3 :           // InsLast
+             r < 0.60 ? 4 :           // PredIns
+             r < 0.62 ? 5 : 6;        // PostIns, else Get
+    if(q.empty() && op >= 4) op = 0;
+    if(op == 6) {                     // Get of random entity
+      free_items.push_back(e);
+      if(q.empty()) continue;
+      Item *g = Get(q, ref, RandomIndex(ref.size()));
+      if(g == 0) errors++;
+      else free_items.push_back(g);
+    }
+    else {
+      unsigned k = op >= 4 ? RandomIndex(ref.size()) : 0;
+      switch(op) {
+        case 0: e->sp = ServicePriority_t(RandomIndex(3));
+                f.QueueIn(e, e->sp); RefSortedIns(ref, e, true); break;
+        case 1: q.Insert(e);         RefSortedIns(ref, e, false); break;
+        case 2: q.InsFirst(e);       ref.push_front(e); break;
+        case 3: q.InsLast(e);        ref.push_back(e); break;
+        case 4: q.PredIns(e, At(q, k)); ref.insert(At(ref, k), e); break;
+        case 5: q.PostIns(e, At(q, k)); ref.insert(At(ref, k+1), e); break;
+      }
+    }
+    count[op]++;
+    if(!Same(q, ref)) {
+      Print("# operation %d (type %d): wrong order\n", n, op);
+      errors++;
+    }
+    if(q.size() >= unsigned(MAXLEN))  // empty queue: sorted (indexed) again
+      while(!q.empty() && errors==0) {
+        Item *g = Get(q, ref, 0);
+        if(g == 0) errors++;
+        else free_items.push_back(g);
+      }
+  }
+  Print("# %d operations: QueueIn %lu, Insert %lu, InsFirst %lu, InsLast %lu,\n"
+        "#   PredIns %lu, PostIns %lu, Get %lu: %s\n", N, count[0], count[1],
+        count[2], count[3], count[4], count[5], count[6],
+        errors ? "FAILED" : "OK");
+  while(!q.empty())
+    free_items.push_back((Item*)q.GetFirst());
+  for(std::list<Item*>::iterator i = free_items.begin(); i != free_items.end(); ++i)
+    delete *i;
+  return errors;
+}
+
+// 2) tail of key is removed, next entity with the key goes after new tail
+int TailTest()
+{
+  Queue q("Q");
+  Reference ref;
+  Item it[8];
+  const int prio[8] = { 1, 1, 1, 0, 1, 1, 1, 0 };
+  for(int i=0; i<8; i++)
+    it[i].Priority = Entity::Priority_t(prio[i]);
+  int errors = 0;
+  // A B C (key 1), D (key 0)
+  for(int i=0; i<4; i++) {
+    q.Insert(&it[i]);
+    RefSortedIns(ref, &it[i], false);
+  }
+  // remove tail C: E goes after B
+  errors += Get(q, ref, 2) != &it[2];
+  q.Insert(&it[4]);
+  RefSortedIns(ref, &it[4], false);
+  errors += !Same(q, ref);
+  // remove E and B: F goes after A
+  errors += Get(q, ref, 2) != &it[4];
+  errors += Get(q, ref, 1) != &it[1];
+  q.Insert(&it[5]);
+  RefSortedIns(ref, &it[5], false);
+  errors += !Same(q, ref) || *ref.begin() != &it[0];
+  // remove all with key 1: G goes first
+  errors += Get(q, ref, 0) != &it[0];
+  errors += Get(q, ref, 0) != &it[5];
+  q.Insert(&it[6]);
+  RefSortedIns(ref, &it[6], false);
+  // H with key 0 after D
+  q.Insert(&it[7]);
+  RefSortedIns(ref, &it[7], false);
+  errors += !Same(q, ref) || *ref.begin() != &it[6] || *--ref.end() != &it[7];
+  Print("# removal of tail of key: %s\n", errors ? "FAILED" : "OK");
+  while(!q.empty())
+    q.GetFirst();
+  return errors;
+}
+
+int main()
+{
+  SetOutput("queue-test.out");
+  Print("# Queue ordering test (reference: linear scan insert)\n");
+  int errors = RandomTest() + TailTest();
+  return errors ? 1 : 0;
+}
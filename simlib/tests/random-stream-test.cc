@@ -0,0 +1,89 @@
+// random-stream-test.cc
+//
+// this tests RandomStream of SIMLIB/C++
+// (independent streams, substreams, common random numbers)
+//
+
+#include "simlib.h"
+
+RandomStream arrivals;          // independent streams
+RandomStream service;
+
+void Moments(const char *name, double (*f)(RandomStream &), RandomStream &s)
+{
+  const int N = 100000;
+  double sum = 0, sum2 = 0;
+  for(int i=0; i<N; i++) {
+    double x = f(s);
+    sum += x;
+    sum2 += x*x;
+  }
+  double m = sum/N;
+  Print("%-16s mean %8.4f  variance %8.4f\n", name, m, sum2/N - m*m);
+}
+
+double u(RandomStream &s) { return s.Uniform(1, 3); }
+double e(RandomStream &s) { return s.Exponential(2); }
+double n(RandomStream &s) { return s.Normal(1, 2); }
+double p(RandomStream &s) { return s.Poisson(50); }
+double b(RandomStream &s) { return s.Binom(1000, 0.3); }
+
+int main()
+{
+  SetOutput("random-stream-test.out");
+  Print("# RandomStream test\n");
+  RandomStream s(1234);
+  Print("seeded stream:");
+  for(int i=0; i<5; i++)
+    Print(" %.6f", s.Random());
+  Print("\n");
+  Print("arrivals/service: %.6f %.6f\n", arrivals.Random(), service.Random());
+  // replications: the same substream gives the same numbers
+  s.Reset();
+  for(int rep=0; rep<3; rep++) {
+    Print("replication %d:", rep);
+    for(int i=0; i<3; i++)
+      Print(" %.6f", s.Random());
+    s.ResetSubstream();
+    Print(" / %.6f", s.Random());
+    s.NextSubstream();
+    Print("\n");
+  }
+  s.Reset();
+  Print("reset: %.6f\n", s.Random());
+  Moments("Uniform(1,3)", u, s);
+  Moments("Exponential(2)", e, s);
+  Moments("Normal(1,2)", n, s);
+  Moments("Poisson(50)", p, s);
+  Moments("Binom(1000,0.3)", b, s);
+  // alias table
+  const double w[4] = { 1, 0, 3, 4 };
+  EmpiricalDiscrete d(w, 4);
+  int count[4] = { 0, 0, 0, 0 };
+  for(int i=0; i<80000; i++)
+    count[d.Value(s)]++;
+  Print("EmpiricalDiscrete(1,0,3,4): %d %d %d %d\n",
+        count[0], count[1], count[2], count[3]);
+  // bulk generation gives the same numbers as scalar calls
+  double a[4], b[4];
+  s.ResetSubstream();
+  s.Normal(0, 1, a, 4);
+  s.ResetSubstream();
+  for(int i=0; i<4; i++)
+    b[i] = s.Normal(0, 1);
+  Print("bulk Normal:");
+  for(int i=0; i<4; i++)
+    Print(" %.6f%s", a[i], a[i]==b[i] ? "" : "(!)");
+  Print("\n");
+  RandomSeed(1537);
+  Exponential(2, a, 4);
+  RandomSeed(1537);
+  Print("bulk Exponential:");
+  for(int i=0; i<4; i++)
+    Print(" %.6f%s", a[i], a[i]==Exponential(2) ? "" : "(!)");
+  Print("\n");
+  // base generator
+  SetBaseRandomStream(&s);
+  Print("Random(): %.6f\n", Random());
+  SetBaseRandomStream(0);
+}
@@ -0,0 +1,92 @@
+// sensitivity-test.cc
+//
+// this tests global sensitivity analysis of SIMLIB/C++
+// 1) Ishigami function: Sobol indices compared to exact values
+// 2) Ishigami function: Morris screening
+// 3) simulation model with irrelevant parameter: the same results
+//    for 1 and 4 worker processes
+//
+
+#include "simlib.h"
+#include "optimize.h"
+#include <cmath>
+
+const double PI = 3.14159265358979323846;
+
+// Ishigami function, a=7, b=0.1, x in [-pi,pi]^3
+double Ishigami(const ParameterVector &p)
+{
+  return sin(p[0]) + 7*pow(sin(p[1]), 2) + 0.1*pow(p[2], 4)*sin(p[0]);
+}
+
+// M/M/1: mean time in queue for given service time and unused parameter
+Facility F("F");
+double Tserv;
+
+class Customer : public Process {
+  void Behavior() {
+    Seize(F);
+    Wait(Exponential(Tserv));
+    Release(F);
+  }
+};
+
+class Generator : public Event {
+  void Behavior() {
+    (new Customer)->Activate();
+    Activate(Time + Exponential(1));
+  }
+};
+
+double Waiting(const ParameterVector &p)
+{
+  Tserv = p[0];                 // p[1] is not used by model
+  Init(0, 1000);
+  F.Clear();
+  (new Generator)->Activate();
+  Run();
+  return F.Q1->StatDT.MeanValue();
+}
+
+int main()
+{
+  SetOutput("sensitivity-test.out");
+  Print("# global sensitivity analysis test\n");
+  Param a[3] = { Param("x1", -PI, PI), Param("x2", -PI, PI),
+                 Param("x3", -PI, PI) };
+  ParameterVector p(3, a);
+  {
+    // exact: V = a^2/8 + b*pi^4/5 + b^2*pi^8/18 + 1/2
+    const double V1 = 0.5*pow(1 + 0.1*pow(PI, 4)/5, 2);
+    const double V2 = 49.0/8;
+    const double V13 = pow(0.1, 2)*pow(PI, 8)*(1.0/18 - 1.0/50);
+    const double V = V1 + V2 + V13;
+    const double S[3] = { V1/V, V2/V, 0 };
+    const double ST[3] = { (V1 + V13)/V, V2/V, V13/V };
+    const unsigned N = 4000;
+    SensitivityAnalysis sa(Ishigami, p, 1);
+    sa.Sobol(N);
+    sa.Print();
+    Print("# runs %lu = N*(k+2) = %u\n", sa.Runs(), N*(p.size()+2));
+    for(int i=0; i<3; i++)
+      Print("# %s: S %.3f (exact %.4f)  ST %.3f (exact %.4f)\n",
+            p[i].Name(), sa.First(i), S[i], sa.Total(i), ST[i]);
+  }
+  {
+    SensitivityAnalysis sa(Ishigami, p, 1);
+    sa.Morris(50);
+    sa.Print();
+    Print("# runs %lu = r*(k+1) = %u\n", sa.Runs(), 50*(p.size()+1));
+  }
+  for(int w=1; w<=4; w+=3) {
+    Param b[2] = { Param("Ts", 0.3, 0.8), Param("dummy", 0, 1) };
+    ParameterVector q(2, b);
+    SensitivityAnalysis sa(Waiting, q, w);
+    sa.Sobol(100, 100);
+    sa.Morris(10);
+    Print("# workers %d: S(Ts) %.6f ST(Ts) %.6f  S(dummy) %.6f "
+          "ST(dummy) %.6f  mu*(dummy) %.6f\n",
+          w, sa.First(0), sa.Total(0), sa.First(1), sa.Total(1),
+          sa.MuStar(1));
+  }
+}
@@ -0,0 +1,89 @@
+// tracer-test.cc
+//
+// this tests Tracer of SIMLIB/C++
+// 1) harmonic oscillator traced at each step, conversion to text
+// 2) decimation
+// 3) many signals (more buffers written by writer thread)
+//
+
+#include "simlib.h"
+#include "tracer.h"
+#include <cstdio>
+#include <cmath>
+#include <cstring>
+
+struct Oscillator {
+  Integrator v, x;
+  Oscillator(double x0) : v(-x, 0), x(v, x0) {}
+};
+
+Oscillator osc(1);
+const int N = 100;
+Oscillator *many[N];
+
+// check text file: number of rows, maximal error of x(t)=cos(t)
+void Check(const char *name)
+{
+  FILE *f = fopen(name, "r");
+  char head[200];
+  if (!f || !fgets(head, sizeof(head), f)) {
+    Print("# can not read %s\n", name);
+    return;
+  }
+  double t, x, v, err = 0, tlast = 0;
+  unsigned long rows = 0;
+  while (fscanf(f, "%lg %lg %lg", &t, &x, &v) == 3) {
+    rows++;
+    tlast = t;
+    if (fabs(x - cos(t)) > err)
+      err = fabs(x - cos(t));
+  }
+  fclose(f);
+  Print("# %s: header \"%.*s\", %lu rows, last time %g, max error %.1e\n",
+        name, int(strlen(head) - 1), head, rows, tlast, err);
+}
+
+int main()
+{
+  SetOutput("tracer-test.out");
+  Print("# Tracer test\n");
+  {
+    Tracer all("tracer-test-all.trc.dat");
+    Tracer dec("tracer-test-dec.trc.dat", 10);
+    all.Add(osc.x, "x");
+    all.Add(osc.v, "v");
+    dec.Add(osc.x, "x");
+    dec.Add(osc.v, "v");
+    SetStep(1e-3, 1e-2);
+    SetAccuracy(1e-8);
+    Init(0, 10);
+    Run();
+    Print("# samples: %lu (each step), %lu (each 10th step), steps %ld\n",
+          all.Samples(), dec.Samples(), SIMLIB_statistics.StepCount);
+  }
+  Print("# conversion: %d %d\n",
+        Tracer::Convert("tracer-test-all.trc.dat", "tracer-test-all.dat"),
+        Tracer::Convert("tracer-test-dec.trc.dat", "tracer-test-dec.dat"));
+  Check("tracer-test-all.dat");
+  Check("tracer-test-dec.dat");
+  {
+    for (int i = 0; i < N; i++)
+      many[i] = new Oscillator(1);
+    Tracer tr("tracer-test-many.trc.dat");
+    for (int i = 0; i < N; i++)
+      tr.Add(many[i]->x);
+    tr.Add(many[0]->v, "v0");
+    SetStep(1e-4, 1e-4);            // fixed small step: 10^4 steps
+    Init(0, 1);
+    Run();
+    Print("# %u columns, %lu samples\n", tr.Columns(), tr.Samples());
+  }
+  Print("# conversion: %d\n",
+        Tracer::Convert("tracer-test-many.trc.dat", "tracer-test-many.dat"));
+  FILE *f = fopen("tracer-test-many.dat", "r");
+  unsigned long lines = 0;
+  for (int c; (c = getc(f)) != EOF; )
+    lines += c == '\n';
+  fclose(f);
+  Print("# %lu lines of text\n", lines);
+}